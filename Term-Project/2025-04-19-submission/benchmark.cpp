@@ -0,0 +1,194 @@
+// benchmark.cpp
+// In-process benchmark + validator for the power-plant solver strategies.
+// Replaces the docker/date/bc loops of run-benchmark.sh and
+// run-method-compare.sh: every input is parsed once, each strategy is run
+// on it through the same Strategy signature, and parse / solve / write are
+// timed separately. Every answer is checked for domination and its size is
+// recorded, so strategies are ranked on compute time and quality only.
+//
+//   ./benchmark [--runs N] [--budget MS] [--threads T] [--strategy a,b]
+//               [--out DIR] [--csv FILE] [--verbose] [input dirs...]
+//
+// Input dirs default to data/input and data/syn/input.
+// gcc/clang: -O3 -march=native -funroll-loops -pthread -I<Term-Project>
+
+#include <bits/stdc++.h>
+#include "mds/io.h"
+#include "mds/solver.h"
+using namespace std;
+namespace fs = std::filesystem;
+using Clock = chrono::steady_clock;
+
+struct RunConfig {
+    int budget_ms = 1000;
+    int threads = 0;
+};
+
+// A strategy maps a graph to in_set[v]; all of them see the same parsed graph.
+using Strategy = function<vector<char>(const mds::Graph&, const RunConfig&)>;
+
+static mds::Sub whole_graph(const mds::Graph& g) {
+    mds::Sub s;
+    s.g = g;
+    s.need.assign(g.n, 1);
+    s.cand.assign(g.n, 1);
+    s.orig.resize(g.n);
+    iota(s.orig.begin(), s.orig.end(), 0);
+    return s;
+}
+
+// kernel + components, then only the greedy on whatever is left
+static vector<char> kernel_greedy(const mds::Graph& g, const RunConfig& cfg) {
+    mds::Kernel k(g);
+    k.reduce();
+    vector<char> in_set = k.chosen;
+    int threads = cfg.threads > 0 ? cfg.threads : mds::default_threads();
+    vector<int> local(g.n);
+    for (auto& members : mds::label_components(g, k.need, k.cand, threads).members) {
+        mds::Sub s = mds::make_sub(g, k.need, k.cand, members, local);
+        for (int v : mds::greedy(s)) in_set[s.orig[v]] = 1;
+    }
+    return in_set;
+}
+
+static const vector<pair<string, Strategy>>& strategies() {
+    static const vector<pair<string, Strategy>> all = {
+        {"mds", [](const mds::Graph& g, const RunConfig& cfg) {
+             mds::Options opt;
+             opt.budget_ms = cfg.budget_ms;
+             opt.threads = cfg.threads;
+             return mds::solve(g, opt);
+         }},
+        {"kernel-greedy", kernel_greedy},
+        {"greedy", [](const mds::Graph& g, const RunConfig&) {
+             vector<char> in_set(g.n, 0);
+             for (int v : mds::greedy(whole_graph(g))) in_set[v] = 1;
+             return in_set;
+         }},
+    };
+    return all;
+}
+
+static double ms_since(Clock::time_point t) {
+    return chrono::duration<double, milli>(Clock::now() - t).count();
+}
+
+// nearest-rank percentile of an unsorted sample
+static double percentile(vector<double> v, double p) {
+    if (v.empty()) return 0;
+    sort(v.begin(), v.end());
+    size_t i = (size_t)ceil(p / 100.0 * v.size());
+    return v[min(v.size() - 1, i ? i - 1 : 0)];
+}
+
+static void print_phase(const char* name, const vector<double>& t) {
+    double sum = accumulate(t.begin(), t.end(), 0.0);
+    printf("  %-6s p50 %9.3f  p90 %9.3f  p99 %9.3f  max %9.3f  total %10.1f ms\n", name,
+           percentile(t, 50), percentile(t, 90), percentile(t, 99), percentile(t, 100), sum);
+}
+
+struct Stats {
+    vector<double> solve, write;
+    long long plants = 0;
+    int invalid = 0, wins = 0;
+};
+
+int main(int argc, char** argv) {
+    int runs = 3;
+    RunConfig cfg;
+    string only, out_dir = "data/output", csv_path;
+    bool verbose = false;
+    vector<string> dirs;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", a.c_str()); exit(1); }
+            return argv[++i];
+        };
+        if (a == "--runs") runs = max(1, atoi(next()));
+        else if (a == "--budget") cfg.budget_ms = atoi(next());
+        else if (a == "--threads") cfg.threads = atoi(next());
+        else if (a == "--strategy") only = next();
+        else if (a == "--out") out_dir = next();
+        else if (a == "--csv") csv_path = next();
+        else if (a == "--verbose") verbose = true;
+        else if (a.rfind("--", 0) == 0) { fprintf(stderr, "unknown option %s\n", a.c_str()); return 1; }
+        else dirs.push_back(a);
+    }
+    if (dirs.empty()) dirs = {"data/input", "data/syn/input"};
+
+    vector<pair<string, Strategy>> picked;
+    for (auto& s : strategies())
+        if (only.empty() || ("," + only + ",").find("," + s.first + ",") != string::npos) picked.push_back(s);
+    if (picked.empty()) { fprintf(stderr, "no strategy matches '%s'\n", only.c_str()); return 1; }
+
+    vector<string> files;
+    for (auto& d : dirs) {
+        if (!fs::is_directory(d)) { fprintf(stderr, "skipping %s: not a directory\n", d.c_str()); continue; }
+        for (auto& e : fs::directory_iterator(d))
+            if (e.path().extension() == ".txt") files.push_back(e.path().string());
+    }
+    sort(files.begin(), files.end());
+    fs::create_directories(out_dir);
+    FILE* csv = csv_path.empty() ? nullptr : fopen(csv_path.c_str(), "w");
+    if (csv) fprintf(csv, "file,n,m,strategy,run,parse_ms,solve_ms,write_ms,plants,valid\n");
+
+    printf("%zu files, %zu strategies, %d runs, budget %d ms\n", files.size(), picked.size(), runs, cfg.budget_ms);
+    vector<double> parse_t;
+    vector<Stats> stats(picked.size());
+    for (auto& path : files) {
+        mds::Graph g;
+        auto t0 = Clock::now();
+        if (!mds::read_graph(path.c_str(), g)) { fprintf(stderr, "cannot read %s\n", path.c_str()); continue; }
+        double parse_ms = ms_since(t0);
+        parse_t.push_back(parse_ms);
+        string base = fs::path(path).stem().string();
+        string out = (fs::path(out_dir) / (base + ".out")).string();
+
+        int best = INT_MAX;
+        vector<int> size(picked.size(), INT_MAX);
+        for (size_t s = 0; s < picked.size(); s++) {
+            for (int r = 0; r < runs; r++) {
+                t0 = Clock::now();
+                vector<char> in_set = picked[s].second(g, cfg);
+                double solve_ms = ms_since(t0);
+                t0 = Clock::now();
+                bool wrote = mds::write_solution(out.c_str(), in_set);
+                double write_ms = ms_since(t0);
+
+                int plants = (int)count(in_set.begin(), in_set.end(), 1);
+                bool valid = wrote && (int)in_set.size() == g.n && mds::dominates(g, in_set);
+                Stats& st = stats[s];
+                st.solve.push_back(solve_ms);
+                st.write.push_back(write_ms);
+                if (!valid) st.invalid++;
+                if (r == 0) {
+                    st.plants += plants;
+                    if (valid) size[s] = plants, best = min(best, plants);
+                }
+                if (verbose)
+                    printf("%-24s %-14s run %d  parse %8.3f  solve %9.3f  write %7.3f  plants %7d%s\n", base.c_str(),
+                           picked[s].first.c_str(), r, parse_ms, solve_ms, write_ms, plants, valid ? "" : "  NOT DOMINATING");
+                if (csv)
+                    fprintf(csv, "%s,%d,%d,%s,%d,%.3f,%.3f,%.3f,%d,%d\n", base.c_str(), g.n, g.edges(),
+                            picked[s].first.c_str(), r, parse_ms, solve_ms, write_ms, plants, valid ? 1 : 0);
+            }
+        }
+        for (size_t s = 0; s < picked.size(); s++)
+            if (best != INT_MAX && size[s] == best) stats[s].wins++;
+    }
+    if (csv) fclose(csv);
+
+    printf("\nparse (%zu files)\n", parse_t.size());
+    print_phase("parse", parse_t);
+    for (size_t s = 0; s < picked.size(); s++) {
+        const Stats& st = stats[s];
+        printf("\n%s: plants %lld, smallest on %d/%zu files, %d invalid\n", picked[s].first.c_str(), st.plants,
+               st.wins, parse_t.size(), st.invalid);
+        print_phase("solve", st.solve);
+        print_phase("write", st.write);
+    }
+    int invalid = 0;
+    for (auto& st : stats) invalid += st.invalid;
+    return invalid ? 2 : 0;
+}
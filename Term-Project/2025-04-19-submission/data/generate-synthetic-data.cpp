@@ -0,0 +1,318 @@
+// generate-synthetic-data.cpp
+// Synthetic power-plant instances at scale, replacing generate-synthetic-data.py
+// for anything past ~10^5 edges. Families:
+//   chain     - path 0..n-1 plus uniform extra edges (the .py family)
+//   random    - uniform simple graph with m edges (ortools/graph/random_graph.h)
+//   grid      - rows x cols lattice
+//   ring      - cycle on n vertices
+//   tree      - random recursive tree
+//   powerlaw  - preferential attachment, about m/n edges per new vertex
+//   geometric - unit-square points joined within the radius for --degree
+//   planted   - k centres with a private leaf each, every other vertex
+//               attached to a centre, then noise; the centres are optimal
+// Writes <outdir>/input/<name>.txt through a large buffer, a dominating set
+// to <outdir>/expected-output/<name>.out, and appends
+//   name family n m seed lower upper optimum
+// to <outdir>/bounds.tsv. lower is a packing bound (or the family's known
+// optimum), upper the size of the written set; optimum is "-" if unknown.
+//
+//   ./gen --family F (--nodes N | --rows R --cols C) [--edges M] [--degree D]
+//         [--plants K] [--seed S] [--budget-ms B] [--outdir DIR]
+// gcc/clang: -O3 -std=c++17 -pthread -I<Term-Project> -I<ortools>/include
+//            generate-synthetic-data.cpp -L<ortools>/lib -lortools
+
+#include <bits/stdc++.h>
+#include "ortools/graph/random_graph.h"
+#include "mds/io.h"
+#include "mds/solver.h"
+using namespace std;
+namespace fs = std::filesystem;
+
+struct Edges {
+    vector<int> u, v;
+    void add(int a, int b) { u.push_back(a); v.push_back(b); }
+    size_t size() const { return u.size(); }
+};
+
+static uint64_t key(int a, int b) { return (uint64_t)min(a, b) << 32 | (uint32_t)max(a, b); }
+
+// keys -> edges, dropping self-loops and repeats
+static void add_keys(Edges& e, vector<uint64_t>& keys) {
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    for (uint64_t k : keys) e.add((int)(k >> 32), (int)(uint32_t)k);
+}
+
+// top up keys with uniform pairs from [0, range) until there are m distinct
+// non-loop edges (or the graph is complete); skip(x) excludes vertices
+template <class Skip>
+static void fill_uniform(vector<uint64_t>& keys, long long m, int range, mt19937_64& rng, Skip skip) {
+    uniform_int_distribution<int> pick(0, range - 1);
+    long long cap = (long long)range * (range - 1) / 2;
+    m = min(m, cap);
+    while ((long long)keys.size() < m) {
+        for (long long i = keys.size(); i < m; i++) {
+            int a = pick(rng), b = pick(rng);
+            if (a != b && !skip(a) && !skip(b)) keys.push_back(key(a, b));
+        }
+        sort(keys.begin(), keys.end());
+        keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    }
+}
+
+static Edges chain(int n, long long m, mt19937_64& rng) {
+    vector<uint64_t> keys;
+    for (int i = 0; i + 1 < n; i++) keys.push_back(key(i, i + 1));
+    fill_uniform(keys, m, n, rng, [](int) { return false; });
+    Edges e;
+    add_keys(e, keys);
+    return e;
+}
+
+static Edges uniform(int n, long long m, mt19937_64& rng) {
+    m = min(m, (long long)n * (n - 1) / 2);
+    auto g = util::GenerateRandomUndirectedSimpleGraph(n, (int)m, true, rng);
+    Edges e;
+    for (int a = 0; a < g->num_arcs(); a++)
+        if (g->Tail(a) < g->Head(a)) e.add(g->Tail(a), g->Head(a));
+    return e;
+}
+
+static Edges grid(int rows, int cols) {
+    Edges e;
+    for (int r = 0; r < rows; r++)
+        for (int c = 0; c < cols; c++) {
+            int v = r * cols + c;
+            if (c + 1 < cols) e.add(v, v + 1);
+            if (r + 1 < rows) e.add(v, v + cols);
+        }
+    return e;
+}
+
+static Edges ring(int n) {
+    Edges e;
+    for (int i = 0; i + 1 < n; i++) e.add(i, i + 1);
+    if (n >= 3) e.add(n - 1, 0);
+    return e;
+}
+
+static Edges tree(int n, mt19937_64& rng) {
+    Edges e;
+    for (int v = 1; v < n; v++) e.add(uniform_int_distribution<int>(0, v - 1)(rng), v);
+    return e;
+}
+
+// Barabasi-Albert: each new vertex links to k distinct earlier vertices
+// picked proportionally to degree (endpoint list sampling).
+static Edges powerlaw(int n, long long m, mt19937_64& rng) {
+    int k = (int)max(1LL, min<long long>(n - 1, n ? m / n : 1));
+    Edges e;
+    vector<int> ends;
+    int seed_size = min(n, k + 1);
+    for (int a = 0; a < seed_size; a++)
+        for (int b = a + 1; b < seed_size; b++) e.add(a, b), ends.push_back(a), ends.push_back(b);
+    vector<int> picked;
+    for (int v = seed_size; v < n; v++) {
+        picked.clear();
+        while ((int)picked.size() < k) {
+            int t = ends.empty() ? 0 : ends[uniform_int_distribution<size_t>(0, ends.size() - 1)(rng)];
+            if (find(picked.begin(), picked.end(), t) == picked.end()) picked.push_back(t);
+        }
+        for (int t : picked) e.add(t, v), ends.push_back(t), ends.push_back(v);
+    }
+    return e;
+}
+
+// Random geometric graph; cells of side r so only 3x3 cells are compared.
+static Edges geometric(int n, double degree, mt19937_64& rng) {
+    double r = sqrt(degree / (M_PI * max(1, n)));
+    int cells = max(1, (int)(1.0 / r));
+    uniform_real_distribution<double> unit(0, 1);
+    vector<double> x(n), y(n);
+    vector<vector<int>> cell(cells * cells);
+    auto at = [&](double t) { return min(cells - 1, (int)(t * cells)); };
+    for (int i = 0; i < n; i++) {
+        x[i] = unit(rng), y[i] = unit(rng);
+        cell[at(x[i]) * cells + at(y[i])].push_back(i);
+    }
+    Edges e;
+    for (int i = 0; i < n; i++) {
+        int cx = at(x[i]), cy = at(y[i]);
+        for (int dx = -1; dx <= 1; dx++)
+            for (int dy = -1; dy <= 1; dy++) {
+                int gx = cx + dx, gy = cy + dy;
+                if (gx < 0 || gy < 0 || gx >= cells || gy >= cells) continue;
+                for (int j : cell[gx * cells + gy])
+                    if (j > i && (x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) <= r * r) e.add(i, j);
+            }
+    }
+    return e;
+}
+
+// Centres 0..k-1, private leaves k..2k-1, the rest attached to a random
+// centre, then uniform noise avoiding the leaves. Each leaf needs its own
+// plant (leaf or centre), so the k centres are optimal. Ids are shuffled.
+static Edges planted(int n, long long m, int k, mt19937_64& rng, vector<char>& centre) {
+    k = max(1, min(k, n / 2));
+    vector<uint64_t> keys;
+    for (int i = 0; i < k; i++) keys.push_back(key(i, k + i));
+    uniform_int_distribution<int> pick_centre(0, k - 1);
+    for (int v = 2 * k; v < n; v++) keys.push_back(key(pick_centre(rng), v));
+    vector<int> core;  // everyone but the leaves
+    for (int v = 0; v < n; v++)
+        if (v < k || v >= 2 * k) core.push_back(v);
+    long long core_pairs = (long long)core.size() * (core.size() - 1) / 2;
+    long long target = min<long long>(m, keys.size() + core_pairs - (n - 2 * k));
+    fill_uniform(keys, target, n, rng, [&](int v) { return v >= k && v < 2 * k; });
+
+    vector<int> perm(n);
+    iota(perm.begin(), perm.end(), 0);
+    shuffle(perm.begin(), perm.end(), rng);
+    centre.assign(n, 0);
+    for (int i = 0; i < k; i++) centre[perm[i]] = 1;
+    Edges e;
+    for (uint64_t kk : keys) e.add(perm[kk >> 32], perm[(uint32_t)kk]);
+    return e;
+}
+
+// Buffered writer: the edge list never goes through stdio formatting.
+class Writer {
+  public:
+    explicit Writer(const string& path) : f_(fopen(path.c_str(), "wb")), buf_(1 << 22) {}
+    ~Writer() { close(); }
+    bool ok() const { return f_ != nullptr; }
+
+    void put(char c) {
+        if (len_ == buf_.size()) flush();
+        buf_[len_++] = c;
+    }
+    void put(long long x) {
+        char tmp[24];
+        int k = 0;
+        do tmp[k++] = char('0' + x % 10), x /= 10; while (x);
+        while (k) put(tmp[--k]);
+    }
+    bool close() {
+        if (!f_) return false;
+        flush();
+        bool good = fclose(f_) == 0;
+        f_ = nullptr;
+        return good;
+    }
+
+  private:
+    void flush() {
+        fwrite(buf_.data(), 1, len_, f_);
+        len_ = 0;
+    }
+    FILE* f_;
+    vector<char> buf_;
+    size_t len_ = 0;
+};
+
+int main(int argc, char** argv) {
+    string family, outdir = "./syn";
+    long long nodes = -1, edges = -1;
+    int rows = -1, cols = -1, plants = -1, budget_ms = 1000;
+    double degree = 6;
+    uint64_t seed = 42;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        auto next = [&]() -> const char* {
+            if (i + 1 >= argc) { fprintf(stderr, "%s needs a value\n", a.c_str()); exit(1); }
+            return argv[++i];
+        };
+        if (a == "--family") family = next();
+        else if (a == "--nodes" || a == "-n") nodes = atoll(next());
+        else if (a == "--edges" || a == "-e") edges = atoll(next());
+        else if (a == "--rows") rows = atoi(next());
+        else if (a == "--cols") cols = atoi(next());
+        else if (a == "--degree") degree = atof(next());
+        else if (a == "--plants") plants = atoi(next());
+        else if (a == "--seed") seed = strtoull(next(), nullptr, 10);
+        else if (a == "--budget-ms") budget_ms = atoi(next());
+        else if (a == "--outdir") outdir = next();
+        else { fprintf(stderr, "unknown option %s\n", a.c_str()); return 1; }
+    }
+    if (family == "grid" && rows > 0 && cols > 0) nodes = (long long)rows * cols;
+    if (family.empty() || nodes < 1 || nodes > INT_MAX) {
+        fprintf(stderr, "Usage: %s --family F (--nodes N | --rows R --cols C) [--edges M] ...\n", argv[0]);
+        return 1;
+    }
+    const int n = (int)nodes;
+    if (edges < 0) edges = (long long)(n * degree / 2);
+    mt19937_64 rng(seed);
+
+    Edges e;
+    vector<char> known;  // planted set, if any
+    int optimum = -1;
+    if (family == "chain") e = chain(n, edges, rng);
+    else if (family == "random") e = uniform(n, edges, rng);
+    else if (family == "grid") {
+        if (rows <= 0 || cols <= 0) rows = max(1, (int)sqrt((double)n)), cols = n / rows;
+        e = grid(rows, cols);
+        // Goncalves, Pinlou, Rao, Thomasse (2011), for both sides >= 16
+        if (rows >= 16 && cols >= 16) optimum = (rows + 2) * (cols + 2) / 5 - 4;
+    } else if (family == "ring") {
+        e = ring(n);
+        optimum = (n + 2) / 3;
+    } else if (family == "tree") e = tree(n, rng);
+    else if (family == "powerlaw") e = powerlaw(n, edges, rng);
+    else if (family == "geometric") e = geometric(n, degree, rng);
+    else if (family == "planted") {
+        e = planted(n, edges, plants > 0 ? plants : max(1, n / 10), rng, known);
+        optimum = (int)count(known.begin(), known.end(), 1);
+    } else {
+        fprintf(stderr, "unknown family %s\n", family.c_str());
+        return 1;
+    }
+    const int vertices = family == "grid" ? rows * cols : n;
+
+    string name = family == "chain" ? "syn-n" + to_string(vertices) + "-e" + to_string(e.size())
+                                    : "syn-" + family + "-n" + to_string(vertices) + "-e" + to_string(e.size()) +
+                                          "-s" + to_string(seed);
+    fs::create_directories(fs::path(outdir) / "input");
+    fs::create_directories(fs::path(outdir) / "expected-output");
+    string input_path = (fs::path(outdir) / "input" / (name + ".txt")).string();
+    string output_path = (fs::path(outdir) / "expected-output" / (name + ".out")).string();
+    {
+        Writer w(input_path);
+        if (!w.ok()) { fprintf(stderr, "cannot write %s\n", input_path.c_str()); return 1; }
+        w.put((long long)vertices), w.put('\n');
+        w.put((long long)e.size()), w.put('\n');
+        for (size_t i = 0; i < e.size(); i++) w.put((long long)e.u[i]), w.put(' '), w.put((long long)e.v[i]), w.put('\n');
+        if (!w.close()) { fprintf(stderr, "write failed: %s\n", input_path.c_str()); return 1; }
+    }
+
+    mds::Graph g = mds::from_edges(vertices, e.u, e.v);
+    e = Edges{};
+    mds::Options opt;
+    opt.budget_ms = budget_ms;
+    vector<char> in_set = mds::solve(g, opt);
+    if (!known.empty() && count(known.begin(), known.end(), 1) < count(in_set.begin(), in_set.end(), 1))
+        in_set = known;
+    if (!mds::dominates(g, in_set)) {
+        fprintf(stderr, "❌ Validation failed: output does not power all nodes.\n");
+        return 1;
+    }
+    mds::write_solution(output_path.c_str(), in_set);
+
+    mds::Sub whole;
+    whole.g = move(g);
+    whole.need.assign(vertices, 1);
+    whole.cand.assign(vertices, 1);
+    int upper = (int)count(in_set.begin(), in_set.end(), 1);
+    int lower = max(mds::packing_lower_bound(whole), optimum);
+    if (family == "tree") optimum = lower = upper;  // kernel + tree DP are exact
+    if (lower == upper) optimum = upper;
+
+    FILE* tsv = fopen((fs::path(outdir) / "bounds.tsv").string().c_str(), "a");
+    if (tsv) {
+        fprintf(tsv, "%s\t%s\t%d\t%d\t%llu\t%d\t%d\t%s\n", name.c_str(), family.c_str(), vertices,
+                whole.g.edges(), (unsigned long long)seed, lower, upper,
+                optimum >= 0 ? to_string(optimum).c_str() : "-");
+        fclose(tsv);
+    }
+    printf("✅ Input saved to: %s\n", input_path.c_str());
+    printf("✅ Output saved to: %s (%d plants, lower bound %d)\n", output_path.c_str(), upper, lower);
+}
@@ -43,4 +43,12 @@ python generate-synthetic-data.py -n 500000 -e 1500000
 
 # === Massive graph ===
 python generate-synthetic-data.py -n 1000000 -e 1000000
-python generate-synthetic-data.py -n 1000000 -e 2000000
\ No newline at end of file
+python generate-synthetic-data.py -n 1000000 -e 2000000
+# === Structured families at scale (C++ generator, see generate-synthetic-data.cpp) ===
+./gen --family random -n 2000000 -e 10000000 --seed 42
+./gen --family grid --rows 1000 --cols 1000
+./gen --family ring -n 1000000
+./gen --family tree -n 1000000 --seed 42
+./gen --family powerlaw -n 1000000 -e 5000000 --seed 42
+./gen --family geometric -n 1000000 --degree 8 --seed 42
+./gen --family planted -n 2000000 -e 10000000 --plants 200000 --seed 42
@@ -2,7 +2,7 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <set>
+#include "mds/io.h"
 #include "ortools/linear_solver/linear_solver.h"
 
 using namespace operations_research;
@@ -13,18 +13,13 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::ifstream infile(argv[1]);
-    std::ofstream outfile(argv[2]);
-
-    int n, m;
-    infile >> n >> m;
-    std::vector<std::set<int>> adj(n);
-    for (int i = 0; i < m; ++i) {
-        int u, v;
-        infile >> u >> v;
-        adj[u].insert(v);
-        adj[v].insert(u);
+    mds::Graph g;
+    if (!mds::read_graph(argv[1], g)) {
+        std::cerr << "Cannot read " << argv[1] << "\n";
+        return 1;
     }
+    std::ofstream outfile(argv[2]);
+    const int n = g.n;
 
     // Create solver
     std::unique_ptr<MPSolver> solver(MPSolver::CreateSolver("CBC"));
@@ -42,7 +37,7 @@ int main(int argc, char** argv) {
     for (int i = 0; i < n; ++i) {
         LinearExpr coverage;
         coverage += vars[i];
-        for (int neighbor : adj[i]) {
+        for (int neighbor : g.nbrs(i)) {
             coverage += vars[neighbor];
         }
         solver->MakeRowConstraint(coverage >= 1);
@@ -53,7 +48,7 @@ int main(int argc, char** argv) {
     for (int i = 0; i < n; ++i) {
         obj += vars[i];
     }
-    solver->Minimize(obj);
+    solver->MutableObjective()->MinimizeLinearExpr(obj);
 
     const MPSolver::ResultStatus result_status = solver->Solve();
     if (result_status != MPSolver::OPTIMAL) {
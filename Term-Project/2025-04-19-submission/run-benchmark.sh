@@ -1,5 +1,8 @@
 #!/bin/bash
 
+# Times whole `docker run` invocations, so container startup is included.
+# For per-phase compute time of the solver strategies use benchmark.cpp.
+
 # Final Docker run test:
 # time docker run -v $(pwd)/data/input:/input -v $(pwd)/data/output:/output power-plant-solver /input/grid-6-7.txt /output/grid-6-7.out
 
@@ -1,5 +1,8 @@
 #!/bin/bash
 
+# Times whole `docker run` invocations, so container startup is included.
+# For per-phase compute time of the solver strategies use benchmark.cpp.
+
 # === CONFIGURATION ===
 ARCHIVE_DIR="archive"
 INPUT_DIR="data/input"
@@ -3,23 +3,18 @@
 #include <vector>
 #include <string>
 #include "ortools/linear_solver/linear_solver.h"
+#include "mds/io.h"
 
 using namespace operations_research;
 
 void solve_power_plant_problem(const std::string& input_file, const std::string& output_file) {
     // Step 1: Read input
-    std::ifstream fin(input_file);
-    int num_nodes, num_edges;
-    fin >> num_nodes >> num_edges;
-
-    std::vector<std::vector<int>> neighbors(num_nodes);
-    for (int i = 0; i < num_edges; ++i) {
-        int u, v;
-        fin >> u >> v;
-        neighbors[u].push_back(v);
-        neighbors[v].push_back(u);
+    mds::Graph g;
+    if (!mds::read_graph(input_file.c_str(), g)) {
+        std::cerr << "Could not read " << input_file << std::endl;
+        return;
     }
-    fin.close();
+    const int num_nodes = g.n;
 
     // Step 2: Create solver (CBC is faster for small graphs like n <= 64)
     std::unique_ptr<MPSolver> solver(MPSolver::CreateSolver("CBC"));
@@ -42,7 +37,7 @@ void solve_power_plant_problem(const std::string& input_file, const std::string&
     for (int i = 0; i < num_nodes; ++i) {
         MPConstraint* ct = solver->MakeRowConstraint(1, solver->infinity());
         ct->SetCoefficient(x[i], 1.0);
-        for (int neighbor : neighbors[i]) {
+        for (int neighbor : g.nbrs(i)) {
             ct->SetCoefficient(x[neighbor], 1.0);
         }
     }
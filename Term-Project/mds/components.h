@@ -0,0 +1,112 @@
+// components.h
+// Split the residual instance into connected components.
+//
+// Labelling is a concurrent union-find: threads take slices of the vertex
+// range and union along relevant edges, linking the larger root under the
+// smaller with a CAS and halving paths as they go. Relevant edges join a
+// candidate to a needed vertex; everything else cannot interact.
+// Components come back largest first, and each one is turned into a Sub
+// (local CSR) by whoever solves it.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "kernel.h"
+#include "parallel.h"
+
+namespace mds {
+
+class ConcurrentUnionFind {
+  public:
+    explicit ConcurrentUnionFind(int n) : parent_(n) {
+        for (int v = 0; v < n; v++) parent_[v].store(v, std::memory_order_relaxed);
+    }
+
+    int find(int x) {
+        while (true) {
+            int p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x) return x;
+            int gp = parent_[p].load(std::memory_order_relaxed);
+            if (gp != p) parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    void unite(int a, int b) {
+        while (true) {
+            a = find(a), b = find(b);
+            if (a == b) return;
+            if (a < b) std::swap(a, b);
+            int expect = a;  // a must still be a root
+            if (parent_[a].compare_exchange_strong(expect, b, std::memory_order_acq_rel)) return;
+        }
+    }
+
+  private:
+    std::vector<std::atomic<int>> parent_;
+};
+
+struct Components {
+    std::vector<std::vector<int>> members;  // global ids, largest component first
+};
+
+inline bool relevant_edge(const std::vector<char> &need, const std::vector<char> &cand, int u, int v) {
+    return (cand[u] && need[v]) || (cand[v] && need[u]);
+}
+
+inline Components label_components(const Graph &g, const std::vector<char> &need,
+                                   const std::vector<char> &cand, int threads) {
+    const int n = g.n;
+    ConcurrentUnionFind uf(n);
+    parallel_for(threads, [&](int t) {
+        int b = (int)((long long)n * t / threads), e = (int)((long long)n * (t + 1) / threads);
+        for (int v = b; v < e; v++)
+            for (int u : g.nbrs(v))
+                if (u > v && relevant_edge(need, cand, u, v)) uf.unite(u, v);
+    });
+    std::vector<int> id(n, -1), size;
+    for (int v = 0; v < n; v++) {
+        if (!(need[v] || cand[v])) continue;
+        int r = uf.find(v);
+        if (id[r] == -1) id[r] = (int)size.size(), size.push_back(0);
+        size[id[r]]++;
+    }
+    Components out;
+    out.members.resize(size.size());
+    for (size_t c = 0; c < size.size(); c++) out.members[c].reserve(size[c]);
+    for (int v = 0; v < n; v++)
+        if (need[v] || cand[v]) out.members[id[uf.find(v)]].push_back(v);
+    std::sort(out.members.begin(), out.members.end(),
+              [](const std::vector<int> &a, const std::vector<int> &b) { return a.size() > b.size(); });
+    return out;
+}
+
+// Local CSR for one component. local must map every member to its index
+// in members (callers own the array; components are disjoint so several
+// threads can share it).
+inline Sub make_sub(const Graph &g, const std::vector<char> &need, const std::vector<char> &cand,
+                    const std::vector<int> &members, std::vector<int> &local) {
+    const int k = (int)members.size();
+    for (int i = 0; i < k; i++) local[members[i]] = i;
+    Sub sub;
+    sub.orig = members;
+    sub.need.resize(k);
+    sub.cand.resize(k);
+    sub.g.n = k;
+    sub.g.off.assign(k + 1, 0);
+    for (int i = 0; i < k; i++) {
+        int v = members[i];
+        sub.need[i] = need[v];
+        sub.cand[i] = cand[v];
+        for (int u : g.nbrs(v))
+            if (relevant_edge(need, cand, u, v)) sub.g.adj.push_back(local[u]);
+        std::sort(sub.g.adj.begin() + sub.g.off[i], sub.g.adj.end());
+        sub.g.off[i + 1] = (int)sub.g.adj.size();
+    }
+    return sub;
+}
+
+}  // namespace mds
@@ -0,0 +1,262 @@
+// exact.h
+// Exact solvers for small kernel components.
+//
+// solve_tiny: subset DP over the needed vertices. best[mask] is the fewest
+// plants whose combined cover is exactly mask; a plant only adds bits, so
+// one pass over masks in increasing order settles them all.
+//
+// packing_lower_bound: needed vertices no candidate covers two of each need
+// their own plant; picked greedily, fewest candidates first.
+//
+// solve_exact: branch and reduce for components of up to a few hundred
+// vertices. The state is the set U of needed vertices still undominated,
+// with closed neighbourhoods as bitsets. At each node
+//   - branch on the u in U with the fewest candidates (a single candidate
+//     is a forced move), trying the ones covering most of U first;
+//   - skip a candidate whose cover within U is inside another's;
+//   - cut when plants so far plus a lower bound reach the incumbent. The
+//     bound is the larger of a packing (vertices of U no candidate covers
+//     two of; each needs its own plant) and the fractional bound: u in U
+//     charges 1 / (largest cover in U of a candidate next to u), and no
+//     plant collects more than 1;
+//   - memoize per U the best proven lower bound, or the exact value and
+//     the move that reaches it.
+
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "kernel.h"
+#include "local_search.h"
+
+namespace mds {
+
+// Components with at most this many needed vertices go to solve_tiny.
+constexpr int kTinyNeed = 16;
+
+inline int count_need(const Sub &s) {
+    int k = 0;
+    for (char x : s.need) k += x;
+    return k;
+}
+
+// solve_exact handles components with at most this many needed vertices
+// and candidates (one fixed-width bitset each).
+constexpr int kExactMax = 256;
+// Search nodes before solve_exact gives up on proving optimality.
+constexpr long long kExactNodes = 1 << 18;
+
+inline std::vector<int> solve_tiny(const Sub &s) {
+    const int n = s.size();
+    std::vector<int> bit(n, -1);
+    int k = 0;
+    for (int v = 0; v < n; v++)
+        if (s.need[v]) bit[v] = k++;
+    // cover mask per candidate; identical masks only need one candidate
+    std::vector<uint32_t> cov;
+    std::vector<int> who;
+    for (int c = 0; c < n; c++) {
+        if (!s.cand[c]) continue;
+        uint32_t m = bit[c] >= 0 ? 1u << bit[c] : 0;
+        for (int y : s.g.nbrs(c))
+            if (bit[y] >= 0) m |= 1u << bit[y];
+        if (!m) continue;
+        bool dup = false;
+        for (uint32_t o : cov) dup |= o == m;
+        if (!dup) cov.push_back(m), who.push_back(c);
+    }
+
+    const uint32_t full = (1u << k) - 1;
+    const int kInf = 1 << 30;
+    std::vector<int> best(full + 1, kInf), from(full + 1, -1), pick(full + 1, -1);
+    best[0] = 0;
+    for (uint32_t mask = 0; mask < full; mask++) {
+        if (best[mask] == kInf) continue;
+        for (size_t i = 0; i < cov.size(); i++) {
+            uint32_t nm = mask | cov[i];
+            if (nm != mask && best[mask] + 1 < best[nm])
+                best[nm] = best[mask] + 1, from[nm] = (int)mask, pick[nm] = (int)i;
+        }
+    }
+    std::vector<int> out;
+    for (uint32_t mask = full; mask != 0; mask = (uint32_t)from[mask]) out.push_back(who[pick[mask]]);
+    return out;
+}
+
+inline int packing_lower_bound(const Sub &s) {
+    const int n = s.size();
+    std::vector<int> order, dominators(n, 0);
+    for (int y = 0; y < n; y++) {
+        if (!s.need[y]) continue;
+        order.push_back(y);
+        dominators[y] = s.cand[y];
+        for (int c : s.g.nbrs(y)) dominators[y] += s.cand[c];
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return dominators[a] < dominators[b]; });
+    std::vector<char> used(n, 0);
+    int pack = 0;
+    for (int y : order) {
+        bool free = !(s.cand[y] && used[y]);
+        for (int c : s.g.nbrs(y)) free &= !(s.cand[c] && used[c]);
+        if (!free) continue;
+        pack++;
+        used[y] = 1;
+        for (int c : s.g.nbrs(y)) used[c] = 1;
+    }
+    return pack;
+}
+
+namespace detail {
+
+class BranchAndReduce {
+  public:
+    using Bits = std::bitset<kExactMax>;
+
+    explicit BranchAndReduce(const Sub &s) {
+        const int n = s.size();
+        std::vector<int> bit(n, -1);
+        for (int v = 0; v < n; v++) {
+            if (s.need[v]) bit[v] = k_++;
+            if (s.cand[v]) who_.push_back(v);
+        }
+        cov_.resize(who_.size());
+        hits_.resize(who_.size());
+        dom_.resize(k_);
+        cands_.resize(k_);
+        for (size_t c = 0; c < who_.size(); c++) {
+            int v = who_[c];
+            auto mark = [&](int y) {
+                if (bit[y] < 0) return;
+                cov_[c][bit[y]] = 1;
+                dom_[bit[y]][c] = 1;
+                cands_[bit[y]].push_back((int)c);
+            };
+            mark(v);
+            for (int y : s.g.nbrs(v)) mark(y);
+        }
+        // packing scans vertices with few candidates first
+        order_.resize(k_);
+        for (int i = 0; i < k_; i++) order_[i] = i;
+        std::stable_sort(order_.begin(), order_.end(),
+                         [&](int a, int b) { return dom_[a].count() < dom_[b].count(); });
+    }
+
+    // Improves sol (a dominating set of s, local ids) to an optimal one.
+    // Returns false if the node limit or deadline hit first; sol is then
+    // still valid but maybe not optimal.
+    bool run(std::vector<int> &sol, Clock::time_point deadline) {
+        deadline_ = deadline;
+        Bits all;
+        for (int i = 0; i < k_; i++) all[i] = 1;
+        int got = search(all, (int)sol.size() - 1);
+        if (aborted_) return false;
+        if (got < (int)sol.size()) {
+            sol.clear();
+            for (Bits u = all; u.any();) {
+                int c = memo_.at(u).move;
+                sol.push_back(who_[c]);
+                u &= ~cov_[c];
+            }
+        }
+        return true;
+    }
+
+  private:
+    struct Entry {
+        int value;      // exact if move >= 0, else a lower bound
+        int move = -1;  // candidate to place first
+    };
+
+    int lower_bound(const Bits &u) {
+        Bits used;
+        int pack = 0;
+        for (int i : order_)
+            if (u[i] && (dom_[i] & used).none()) pack++, used |= dom_[i];
+        for (size_t c = 0; c < cov_.size(); c++) hits_[c] = (int)(cov_[c] & u).count();
+        double share = 0;
+        for (int i = 0; i < k_; i++) {
+            if (!u[i]) continue;
+            int widest = 1;
+            for (int c : cands_[i]) widest = std::max(widest, hits_[c]);
+            share += 1.0 / widest;
+        }
+        return std::max(pack, (int)std::ceil(share - 1e-9));
+    }
+
+    // Fewest plants covering u if that is <= budget; otherwise some proven
+    // lower bound > budget.
+    int search(const Bits &u, int budget) {
+        if (u.none()) return 0;
+        if (aborted_ || ((++nodes_ & 1023) == 0 && (nodes_ > kExactNodes || Clock::now() >= deadline_))) {
+            aborted_ = true;
+            return budget + 1;
+        }
+        auto it = memo_.find(u);
+        int lb = 0;
+        if (it != memo_.end()) {
+            if (it->second.move >= 0 || it->second.value > budget) return it->second.value;
+            lb = it->second.value;
+        }
+        lb = std::max(lb, lower_bound(u));
+        if (lb > budget) return memo_[u] = Entry{lb}, lb;
+
+        int pivot = -1;
+        size_t fewest = 0;
+        for (int i = 0; i < k_; i++)
+            if (u[i] && (pivot < 0 || dom_[i].count() < fewest)) pivot = i, fewest = dom_[i].count();
+        std::vector<std::pair<int, int>> order;  // (-|cover in u|, candidate)
+        for (size_t c = 0; c < cov_.size(); c++)
+            if (dom_[pivot][c]) order.push_back({-(int)(cov_[c] & u).count(), (int)c});
+        std::sort(order.begin(), order.end());
+        std::vector<int> moves;
+        for (auto [neg, c] : order) {
+            (void)neg;
+            bool dominated = false;
+            for (int m : moves) dominated |= (cov_[c] & u & ~cov_[m]).none();
+            if (!dominated) moves.push_back(c);
+        }
+
+        int best = budget + 1, move = -1;
+        for (int c : moves) {
+            int r = 1 + search(u & ~cov_[c], best - 2);
+            if (aborted_) return budget + 1;
+            if (r < best) best = r, move = c;
+            if (best <= lb) break;
+        }
+        if (move >= 0) memo_[u] = Entry{best, move};
+        else memo_[u] = Entry{budget + 1};
+        return best;
+    }
+
+    int k_ = 0;
+    std::vector<int> who_, order_;  // who_: candidate index -> local id
+    std::vector<Bits> cov_, dom_;   // cov_[c]: needed bits; dom_[i]: candidate bits
+    std::vector<std::vector<int>> cands_;  // dom_ as lists
+    std::vector<int> hits_;                // scratch: |cov_[c] & U|
+    std::unordered_map<Bits, Entry> memo_;
+    long long nodes_ = 0;
+    bool aborted_ = false;
+    Clock::time_point deadline_;
+};
+
+}  // namespace detail
+
+inline bool fits_exact(const Sub &s) {
+    int c = 0;
+    for (char x : s.cand) c += x;
+    return c <= kExactMax && count_need(s) <= kExactMax;
+}
+
+// Replaces sol (a dominating set of s) by an optimal one; false if the
+// search ran out of nodes or time before it could prove optimality.
+inline bool solve_exact(const Sub &s, std::vector<int> &sol, Clock::time_point deadline) {
+    return detail::BranchAndReduce(s).run(sol, deadline);
+}
+
+}  // namespace mds
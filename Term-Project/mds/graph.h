@@ -0,0 +1,82 @@
+// graph.h
+// Compressed sparse row (CSR) graph used by every stage of the mds engine.
+// Neighbour lists are sorted and free of self-loops / parallel edges, so
+// adjacency tests are a binary search.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mds {
+
+struct Graph {
+    int n = 0;
+    std::vector<int> off;  // neighbours of v are adj[off[v] .. off[v+1])
+    std::vector<int> adj;
+
+    struct Range {
+        const int *b, *e;
+        const int *begin() const { return b; }
+        const int *end() const { return e; }
+    };
+
+    int deg(int v) const { return off[v + 1] - off[v]; }
+    Range nbrs(int v) const { return {adj.data() + off[v], adj.data() + off[v + 1]}; }
+    int edges() const { return (int)adj.size() / 2; }
+
+    // true if u is in the closed neighbourhood N[v]
+    bool closed(int v, int u) const {
+        return u == v || std::binary_search(adj.data() + off[v], adj.data() + off[v + 1], u);
+    }
+};
+
+// Build a simple undirected graph from an edge list. Self-loops are dropped
+// and parallel edges merged; rows come out sorted.
+inline Graph from_edges(int n, const std::vector<int> &eu, const std::vector<int> &ev) {
+    Graph g;
+    g.n = n;
+    g.off.assign(n + 1, 0);
+    const size_t m = eu.size();
+    for (size_t i = 0; i < m; i++) {
+        if (eu[i] == ev[i]) continue;
+        g.off[eu[i] + 1]++;
+        g.off[ev[i] + 1]++;
+    }
+    for (int v = 0; v < n; v++) g.off[v + 1] += g.off[v];
+    g.adj.resize(g.off[n]);
+    std::vector<int> pos(g.off.begin(), g.off.end() - 1);
+    for (size_t i = 0; i < m; i++) {
+        int u = eu[i], v = ev[i];
+        if (u == v) continue;
+        g.adj[pos[u]++] = v;
+        g.adj[pos[v]++] = u;
+    }
+    // sort + dedup each row, then compact
+    int w = 0;
+    for (int v = 0; v < n; v++) {
+        int *b = g.adj.data() + g.off[v], *e = g.adj.data() + g.off[v + 1];
+        std::sort(b, e);
+        e = std::unique(b, e);
+        g.off[v] = w;
+        for (int *p = b; p != e; ++p) g.adj[w++] = *p;
+    }
+    g.off[n] = w;
+    g.adj.resize(w);
+    return g;
+}
+
+// Every vertex is in the set or adjacent to it.
+inline bool dominates(const Graph &g, const std::vector<char> &in_set) {
+    for (int v = 0; v < g.n; v++) {
+        if (in_set[v]) continue;
+        bool ok = false;
+        for (int u : g.nbrs(v))
+            if (in_set[u]) { ok = true; break; }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+}  // namespace mds
@@ -0,0 +1,128 @@
+// greedy.h
+// Max-coverage greedy for kernel components that are neither trees nor
+// rings, followed by a redundancy prune.
+//
+// gain[c] = needed, still undominated vertices in N[c]. Gains live in a
+// bucket queue (one intrusive list per gain value) and are maintained
+// incrementally: picking c only changes the gain of candidates within
+// distance 2 of c, and each vertex is dominated once, so a whole run is
+// O(n + m) instead of a rescan of every candidate per step.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "kernel.h"
+
+namespace mds {
+
+namespace detail {
+
+// Max bucket queue over ids 0..n-1 with integer keys in [0, max_key].
+class BucketQueue {
+  public:
+    BucketQueue(int n, int max_key)
+        : key_(n, -1), next_(n, -1), prev_(n, -1), head_(max_key + 1, -1), top_(-1) {}
+
+    bool empty() const { return top_ < 0; }
+    int key(int v) const { return key_[v]; }
+    bool contains(int v) const { return key_[v] >= 0; }
+
+    void insert(int v, int k) {
+        key_[v] = k;
+        prev_[v] = -1;
+        next_[v] = head_[k];
+        if (head_[k] != -1) prev_[head_[k]] = v;
+        head_[k] = v;
+        if (k > top_) top_ = k;
+    }
+
+    void erase(int v) {
+        int k = key_[v];
+        if (prev_[v] != -1) next_[prev_[v]] = next_[v];
+        else head_[k] = next_[v];
+        if (next_[v] != -1) prev_[next_[v]] = prev_[v];
+        key_[v] = -1;
+    }
+
+    void decrease(int v) {
+        int k = key_[v];
+        erase(v);
+        insert(v, k - 1);
+    }
+
+    // id with the largest key; the queue must not be empty
+    int top() {
+        while (head_[top_] == -1) --top_;
+        return head_[top_];
+    }
+
+    // drop keys that reached zero so empty() means "nothing left to gain"
+    void settle() {
+        while (top_ >= 0 && head_[top_] == -1) --top_;
+        if (top_ == 0) top_ = -1;
+    }
+
+  private:
+    std::vector<int> key_, next_, prev_, head_;
+    int top_;
+};
+
+}  // namespace detail
+
+// Candidates that stay in the solution must each be the only dominator of
+// some needed vertex; drop the others, latest picks first.
+inline void prune_redundant(const Sub &s, std::vector<int> &sol) {
+    const int n = s.size();
+    std::vector<int> cover(n, 0);
+    auto each_closed = [&](int p, auto &&f) {
+        f(p);
+        for (int y : s.g.nbrs(p)) f(y);
+    };
+    for (int p : sol) each_closed(p, [&](int y) { cover[y]++; });
+    std::vector<int> keep;
+    for (int i = (int)sol.size() - 1; i >= 0; i--) {
+        int p = sol[i];
+        bool needed = false;
+        each_closed(p, [&](int y) { needed |= s.need[y] && cover[y] == 1; });
+        if (needed) keep.push_back(p);
+        else each_closed(p, [&](int y) { cover[y]--; });
+    }
+    sol.assign(keep.rbegin(), keep.rend());
+}
+
+inline std::vector<int> greedy(const Sub &s) {
+    const int n = s.size();
+    int max_deg = 0;
+    for (int v = 0; v < n; v++) max_deg = std::max(max_deg, s.g.deg(v));
+    detail::BucketQueue q(n, max_deg + 1);
+    for (int c = 0; c < n; c++) {
+        if (!s.cand[c]) continue;
+        int gain = s.need[c];
+        for (int y : s.g.nbrs(c)) gain += s.need[y];
+        if (gain > 0) q.insert(c, gain);
+    }
+
+    std::vector<char> dom(n, 0);
+    std::vector<int> sol;
+    auto dominate = [&](int y) {
+        if (!s.need[y] || dom[y]) return;
+        dom[y] = 1;
+        // y no longer counts for any candidate next to it
+        if (q.contains(y)) q.decrease(y);
+        for (int w : s.g.nbrs(y))
+            if (q.contains(w)) q.decrease(w);
+    };
+    for (q.settle(); !q.empty(); q.settle()) {
+        int c = q.top();
+        q.erase(c);
+        sol.push_back(c);
+        dominate(c);
+        for (int y : s.g.nbrs(c)) dominate(y);
+    }
+    prune_redundant(s, sol);
+    return sol;
+}
+
+}  // namespace mds
@@ -0,0 +1,295 @@
+// io.h
+// Edge-list reader shared by all power-plant solver variants.
+//
+//   n
+//   m
+//   u v      (m lines)
+//
+// The file is mmap'ed, the body is split by byte range across threads, and
+// numbers are located 16 bytes at a time with SSE2 (digit mask + tzcnt) and
+// converted 8 digits at a time with SWAR. The CSR is built by a parallel
+// counting sort (per-thread histograms, then a fill pass), after which rows
+// are sorted and deduplicated so the result matches from_edges().
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "graph.h"
+#include "parallel.h"
+
+namespace mds {
+
+namespace detail {
+
+// Read-only view of a whole file; mmap when possible, read() otherwise.
+class MappedFile {
+  public:
+    explicit MappedFile(const char *path) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = (size_t)st.st_size;
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE;
+#endif
+            void *p = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+            if (p != MAP_FAILED) {
+                map_ = p;
+                data_ = (const char *)p;
+            }
+        }
+        if (!data_) {  // pipes, /proc files, failed mmap
+            size_ = 0;
+            char chunk[1 << 16];
+            ssize_t r;
+            while ((r = read(fd, chunk, sizeof chunk)) > 0) copy_.insert(copy_.end(), chunk, chunk + r);
+            size_ = copy_.size();
+            data_ = copy_.data();
+        }
+        close(fd);
+    }
+    ~MappedFile() {
+        if (map_) munmap(map_, size_);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool ok() const { return data_ != nullptr; }
+    const char *begin() const { return data_; }
+    const char *end() const { return data_ + size_; }
+    size_t size() const { return size_; }
+
+  private:
+    void *map_ = nullptr;
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<char> copy_;
+};
+
+inline bool is_digit(char c) { return (unsigned)(c - '0') < 10; }
+
+// Value of the len (1..8) digits at p; p[0..7] must be readable.
+inline uint32_t swar_digits(const char *p, int len) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    v <<= 8 * (8 - len);  // right-align, leading bytes become zero digits
+    v &= 0x0F0F0F0F0F0F0F0FULL;
+    v = (v * 10 + (v >> 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v * 100 + (v >> 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v * 10000 + (v >> 32)) & 0x00000000FFFFFFFFULL;
+    return (uint32_t)v;
+}
+
+// Scalar parse of one number at p; returns the byte after it.
+inline const char *scalar_number(const char *p, const char *end, int &x) {
+    x = 0;
+    while (p < end && is_digit(*p)) x = x * 10 + (*p++ - '0');
+    return p;
+}
+
+// Append every number whose first digit lies in [p, stop). Numbers may run
+// past stop; nothing at or after end is read.
+inline void parse_range(const char *p, const char *stop, const char *end, std::vector<int> &out) {
+#if defined(__SSE2__)
+    const __m128i zero = _mm_set1_epi8('0'), nine = _mm_set1_epi8(9);
+    // 16-byte blocks while a whole block plus an 8-byte SWAR load fits
+    while (p < stop && p + 32 <= end) {
+        __m128i d = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)p), zero);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, nine), d));
+        int consumed = 16;
+        while (mask) {
+            int s = __builtin_ctz(mask);
+            if (p + s >= stop) { consumed = 16; mask = 0; p = stop; break; }
+            uint32_t run_bits = ~(mask >> s);
+            int len = run_bits ? __builtin_ctz(run_bits) : 32;
+            if (s + len >= 16) {  // may continue past the block
+                if (s > 0) { consumed = s; break; }  // reload at its start
+                int x;
+                p = scalar_number(p, end, x);  // 16+ digits: not an id, but stay total
+                out.push_back(x);
+                consumed = 0;
+                break;
+            }
+            int x;
+            if (len <= 8) x = (int)swar_digits(p + s, len);
+            else scalar_number(p + s, end, x);
+            out.push_back(x);
+            mask &= ~((1u << (s + len)) - 1);
+        }
+        if (p >= stop) break;
+        p += consumed;
+    }
+#endif
+    // tail (and non-x86): plain scalar
+    while (p < stop) {
+        while (p < stop && !is_digit(*p)) ++p;
+        if (p >= stop) break;
+        int x;
+        p = scalar_number(p, end, x);
+        out.push_back(x);
+    }
+}
+
+// First byte at or after p that is not in the middle of a number.
+inline const char *align_to_token(const char *begin, const char *p, const char *end) {
+    if (p == begin) return p;
+    while (p < end && is_digit(p[-1]) && is_digit(*p)) ++p;
+    return p;
+}
+
+// Rows are short on sparse inputs; insertion sort beats std::sort there.
+inline void sort_row(int *b, int *e) {
+    if (e - b > 16) { std::sort(b, e); return; }
+    for (int *i = b + 1; i < e; ++i) {
+        int x = *i, *j = i;
+        for (; j > b && j[-1] > x; --j) *j = j[-1];
+        *j = x;
+    }
+}
+
+}  // namespace detail
+
+// Parse an edge-list file into a simple CSR graph. threads <= 0 picks the
+// hardware concurrency; small inputs are always read on one thread.
+inline bool read_graph(const char *path, Graph &g, int threads = 0) {
+    using namespace detail;
+    MappedFile f(path);
+    if (!f.ok()) return false;
+    const char *p = f.begin(), *end = f.end();
+
+    int n = 0, m = 0;
+    while (p < end && !is_digit(*p)) ++p;
+    p = scalar_number(p, end, n);
+    while (p < end && !is_digit(*p)) ++p;
+    p = scalar_number(p, end, m);
+
+    // ~1 MiB of text per thread before spawning is worth it
+    constexpr size_t kBytesPerThread = 1 << 20;
+    if (threads <= 0) threads = default_threads();
+    threads = (int)std::max<size_t>(1, std::min<size_t>(threads, (end - p) / kBytesPerThread + 1));
+
+    // 1. parse tokens per byte range
+    std::vector<std::vector<int>> tok(threads);
+    std::vector<const char *> cut(threads + 1);
+    for (int t = 0; t <= threads; t++)
+        cut[t] = align_to_token(p, p + (end - p) * t / threads, end);
+    parallel_for(threads, [&](int t) {
+        tok[t].reserve((size_t)(2.0 * m * (cut[t + 1] - cut[t]) / std::max<std::ptrdiff_t>(1, end - p)) + 16);
+        parse_range(cut[t], cut[t + 1], end, tok[t]);
+    });
+    std::vector<size_t> base(threads + 1, 0);
+    for (int t = 0; t < threads; t++) base[t + 1] = base[t] + tok[t].size();
+    std::vector<int> flat(std::min<size_t>(base[threads], 2 * (size_t)m) & ~(size_t)1);
+    const size_t total = flat.size();
+    parallel_for(threads, [&](int t) {
+        size_t b = std::min(base[t], total), e = std::min(base[t + 1], total);
+        if (e > b) std::memcpy(flat.data() + b, tok[t].data(), (e - b) * sizeof(int));
+        std::vector<int>().swap(tok[t]);
+    });
+    const size_t edges = total / 2;
+
+    // 2. counting pass: one degree histogram per thread, so no atomics and
+    //    each thread later writes its own disjoint slots of every row
+    auto slice = [&](int t, size_t len) {
+        return std::make_pair(len * t / threads, len * (t + 1) / threads);
+    };
+    std::vector<std::vector<int>> cur(threads);
+    parallel_for(threads, [&](int t) {
+        std::vector<int> &c = cur[t];
+        c.assign(n, 0);
+        auto [b, e] = slice(t, edges);
+        for (size_t i = b; i < e; i++) {
+            int u = flat[2 * i], v = flat[2 * i + 1];
+            if (u == v || u >= n || v >= n) continue;
+            c[u]++, c[v]++;
+        }
+    });
+    std::vector<int> off(n + 1, 0);
+    parallel_for(threads, [&](int t) {
+        auto [b, e] = slice(t, (size_t)n);
+        for (size_t v = b; v < e; v++)
+            for (int k = 0; k < threads; k++) off[v + 1] += cur[k][v];
+    });
+    for (int v = 0; v < n; v++) off[v + 1] += off[v];
+    parallel_for(threads, [&](int t) {
+        auto [b, e] = slice(t, (size_t)n);
+        for (size_t v = b; v < e; v++)
+            for (int k = 0, s = off[v]; k < threads; k++) {
+                int c = cur[k][v];
+                cur[k][v] = s;
+                s += c;
+            }
+    });
+
+    // 3. fill pass
+    std::vector<int> adj(off[n]);
+    parallel_for(threads, [&](int t) {
+        int *c = cur[t].data();
+        auto [b, e] = slice(t, edges);
+        for (size_t i = b; i < e; i++) {
+            int u = flat[2 * i], v = flat[2 * i + 1];
+            if (u == v || u >= n || v >= n) continue;
+            adj[c[u]++] = v;
+            adj[c[v]++] = u;
+        }
+    });
+    std::vector<int>().swap(flat);
+    std::vector<std::vector<int>>().swap(cur);
+
+    // 4. sort + dedup rows, then compact
+    std::vector<int> len(n);
+    parallel_for(threads, [&](int t) {
+        auto [b, e] = slice(t, (size_t)n);
+        for (size_t v = b; v < e; v++) {
+            int *rb = adj.data() + off[v], *re = adj.data() + off[v + 1];
+            sort_row(rb, re);
+            len[v] = (int)(std::unique(rb, re) - rb);
+        }
+    });
+    g.n = n;
+    g.off.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) g.off[v + 1] = g.off[v] + len[v];
+    if (g.off[n] == off[n]) {
+        g.adj = std::move(adj);
+    } else {
+        g.adj.resize(g.off[n]);
+        parallel_for(threads, [&](int t) {
+            auto [b, e] = slice(t, (size_t)n);
+            for (size_t v = b; v < e; v++)
+                std::memcpy(g.adj.data() + g.off[v], adj.data() + off[v], len[v] * sizeof(int));
+        });
+    }
+    return true;
+}
+
+// Write the answer line ('1' = plant) followed by a newline.
+inline bool write_solution(const char *path, const std::vector<char> &in_set) {
+    FILE *fo = std::fopen(path, "wb");
+    if (!fo) return false;
+    std::string out(in_set.size() + 1, '0');
+    for (size_t i = 0; i < in_set.size(); i++)
+        if (in_set[i]) out[i] = '1';
+    out.back() = '\n';
+    bool ok = std::fwrite(out.data(), 1, out.size(), fo) == out.size();
+    return std::fclose(fo) == 0 && ok;
+}
+
+}  // namespace mds
@@ -0,0 +1,166 @@
+// kernel.h
+// Exact reductions for minimum dominating set, run before any search.
+//
+// The instance is kept in annotated form: need[v] says v still has to be
+// dominated, cand[v] says a plant may still go on v. Every rule below keeps
+// at least one optimal solution, so the kernel plus the forced vertices is
+// as good as the original graph:
+//   forced   - a needed vertex with a single candidate left forces it
+//              (covers the leaf rule: the support vertex of a leaf)
+//   useless  - a candidate with nothing left to dominate is dropped
+//   column   - candidate u whose needed set N[u] is inside N[v] is dropped
+//   row      - needed b with every candidate of some needed a in N[b]
+//              is implied by a and stops being needed
+// What survives is split into connected components (Sub, see components.h).
+
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "graph.h"
+
+namespace mds {
+
+// A connected piece of the residual instance with local ids 0..n-1.
+struct Sub {
+    Graph g;
+    std::vector<char> need, cand;
+    std::vector<int> orig;  // local id -> global id
+
+    int size() const { return g.n; }
+};
+
+class Kernel {
+  public:
+    // Subset tests are only tried on sets up to this size; the dominance
+    // rules are the expensive ones and large sets rarely nest anyway.
+    static constexpr int kSubsetCap = 16;
+
+    explicit Kernel(const Graph &g)
+        : need(g.n, 1), cand(g.n, 1), chosen(g.n, 0),
+          g_(g), ncand_(g.n), nneed_(g.n), queued_(g.n, 0) {
+        for (int v = 0; v < g.n; v++) ncand_[v] = nneed_[v] = g.deg(v) + 1;
+    }
+
+    std::vector<char> need, cand, chosen;
+
+    int num_chosen() const {
+        int c = 0;
+        for (char x : chosen) c += x;
+        return c;
+    }
+
+    // Apply all rules until none fires.
+    void reduce() {
+        for (int v = 0; v < g_.n; v++) push(v);
+        while (!work_.empty()) {
+            int v = work_.back();
+            work_.pop_back();
+            queued_[v] = 0;
+            check(v);
+        }
+    }
+
+  private:
+    void push(int v) {
+        if (!queued_[v]) queued_[v] = 1, work_.push_back(v);
+    }
+
+    void choose(int c) {
+        chosen[c] = 1;
+        drop_cand(c);
+        if (need[c]) drop_need(c);
+        for (int y : g_.nbrs(c))
+            if (need[y]) drop_need(y);
+    }
+
+    void drop_cand(int u) {
+        cand[u] = 0;
+        --ncand_[u];
+        push(u);
+        for (int y : g_.nbrs(u)) --ncand_[y], push(y);
+    }
+
+    void drop_need(int y) {
+        need[y] = 0;
+        --nneed_[y];
+        push(y);
+        for (int u : g_.nbrs(y)) --nneed_[u], push(u);
+    }
+
+    void check(int v) {
+        if (need[v]) {
+            assert(ncand_[v] > 0);
+            if (ncand_[v] == 1) {
+                if (cand[v]) { choose(v); return; }
+                for (int u : g_.nbrs(v))
+                    if (cand[u]) { choose(u); return; }
+            }
+            drop_implied_rows(v);
+        }
+        if (cand[v]) {
+            if (nneed_[v] == 0) { drop_cand(v); return; }
+            drop_if_column_dominated(v);
+        }
+    }
+
+    // Candidate u is dropped if another candidate covers everything u
+    // still needs to cover.
+    void drop_if_column_dominated(int u) {
+        if (nneed_[u] > kSubsetCap) return;
+        set_.clear();
+        int pivot = -1;
+        auto add = [&](int y) {
+            if (!need[y]) return;
+            set_.push_back(y);
+            if (pivot == -1 || g_.deg(y) < g_.deg(pivot)) pivot = y;
+        };
+        add(u);
+        for (int y : g_.nbrs(u)) add(y);
+        // any dominator of the set must dominate the pivot
+        auto try_v = [&](int v) {
+            if (v == u || !cand[v]) return false;
+            for (int y : set_)
+                if (!g_.closed(v, y)) return false;
+            drop_cand(u);
+            return true;
+        };
+        if (try_v(pivot)) return;
+        for (int v : g_.nbrs(pivot))
+            if (try_v(v)) return;
+    }
+
+    // Needed b is dropped if some needed a has all its candidates inside
+    // N[b]: whichever plant dominates a also dominates b. Here a is the
+    // vertex being checked and the implied rows b are dropped.
+    void drop_implied_rows(int a) {
+        if (ncand_[a] > kSubsetCap) return;
+        set_.clear();
+        int pivot = -1;
+        auto add = [&](int c) {
+            if (!cand[c]) return;
+            set_.push_back(c);
+            if (pivot == -1 || g_.deg(c) < g_.deg(pivot)) pivot = c;
+        };
+        add(a);
+        for (int c : g_.nbrs(a)) add(c);
+        // an implied row must be next to every candidate, the pivot included
+        auto try_b = [&](int b) {
+            if (b == a || !need[b]) return;
+            for (int c : set_)
+                if (!g_.closed(b, c)) return;
+            drop_need(b);
+        };
+        try_b(pivot);
+        for (int b : g_.nbrs(pivot)) try_b(b);
+    }
+
+    const Graph &g_;
+    std::vector<int> ncand_;  // candidates in N[v]
+    std::vector<int> nneed_;  // needed vertices in N[v]
+    std::vector<char> queued_;
+    std::vector<int> work_, set_;
+};
+
+}  // namespace mds
@@ -0,0 +1,315 @@
+// local_search.h
+// Anytime improvement of a dominating set, run after the greedy.
+//
+// Each worker keeps, incrementally:
+//   cnt[y]   - plants in N[y]
+//   score[v] - for a plant: weight it alone dominates (loss of removing it)
+//              otherwise:   weight of undominated vertices it would add
+// and runs the usual remove-one / swap search: whenever the set dominates
+// everything it is recorded and its cheapest plant is dropped (a 2-for-1
+// once the following swaps repair it), then 1-swaps (drop a low-loss plant,
+// add the best candidate next to a random dark vertex) run until it
+// dominates again. Dark vertices gain weight every step so the search
+// leaves plateaus, configuration checking stops a plant from coming back
+// before something within distance 2 of it changed, and the plant to drop
+// is picked by best-from-multiple-selection (BMS) sampling on large sets.
+//
+// Workers are seeded differently and run on their own threads. The best
+// set found so far is published as an immutable snapshot through an atomic
+// pointer; stale workers restart from it.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "kernel.h"
+
+namespace mds {
+
+using Clock = std::chrono::steady_clock;
+
+struct SearchLimits {
+    Clock::time_point deadline;
+    int threads = 1;
+    uint64_t seed = 1;
+};
+
+namespace detail {
+
+// Immutable best-so-far set. Snapshots are never freed while workers run;
+// replaced ones go on a retired list that is released after they join.
+struct Snapshot {
+    std::vector<int> sol;
+    Snapshot *retired_next = nullptr;
+};
+
+class SharedBest {
+  public:
+    explicit SharedBest(std::vector<int> sol) {
+        auto *s = new Snapshot{std::move(sol)};
+        best_.store(s, std::memory_order_release);
+        size_.store((int)s->sol.size(), std::memory_order_relaxed);
+    }
+    ~SharedBest() {
+        for (Snapshot *s = retired_; s;) {
+            Snapshot *nx = s->retired_next;
+            delete s;
+            s = nx;
+        }
+        delete best_.load();
+    }
+
+    int size() const { return size_.load(std::memory_order_relaxed); }
+    const Snapshot *get() const { return best_.load(std::memory_order_acquire); }
+
+    // Publish sol if it is strictly smaller than the current best.
+    void offer(const std::vector<int> &sol) {
+        if ((int)sol.size() >= size()) return;
+        auto *s = new Snapshot{sol};
+        Snapshot *old = best_.load(std::memory_order_acquire);
+        while (old->sol.size() > s->sol.size()) {
+            if (best_.compare_exchange_weak(old, s, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                int cur = size();
+                while ((int)s->sol.size() < cur &&
+                       !size_.compare_exchange_weak(cur, (int)s->sol.size(), std::memory_order_relaxed)) {}
+                retire(old);
+                return;
+            }
+        }
+        retire(s);  // someone published a smaller one meanwhile
+    }
+
+  private:
+    void retire(Snapshot *s) {
+        s->retired_next = retired_.load(std::memory_order_relaxed);
+        while (!retired_.compare_exchange_weak(s->retired_next, s, std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+    }
+
+    std::atomic<Snapshot *> best_{nullptr};
+    std::atomic<Snapshot *> retired_{nullptr};
+    std::atomic<int> size_{0};
+};
+
+class LocalSearch {
+  public:
+    // BMS sample size when choosing the plant to drop.
+    static constexpr int kSample = 64;
+    // Weights are halved once one of them reaches this value.
+    static constexpr int kWeightCap = 1 << 16;
+
+    LocalSearch(const Sub &s, uint64_t seed)
+        : s_(s), n_(s.size()), in_(n_, 0), conf_(n_, 1), pos_(n_, -1), upos_(n_, -1),
+          cnt_(n_, 0), w_(n_, 1), score_(n_, 0), age_(n_, 0), rng_(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+
+    // Run until the deadline, the stop flag, or max_idle steps without a
+    // new personal best. Returns the best set found.
+    std::vector<int> run(const std::vector<int> &start, SharedBest &shared,
+                         const std::atomic<bool> &stop, Clock::time_point deadline, long long max_idle) {
+        load(start);
+        std::vector<int> best = start;
+        long long idle = 0;
+        int last_added = -1;
+        for (long long step = 1;; step++) {
+            if ((step & 255) == 0 &&
+                (stop.load(std::memory_order_relaxed) || Clock::now() >= deadline)) break;
+            if (undom_.empty()) {
+                if (sol_.size() < best.size()) {
+                    best = sol_;
+                    shared.offer(best);
+                    idle = 0;
+                }
+                if (sol_.size() <= 1) break;
+                remove(pick_drop(-1), step);
+                continue;
+            }
+            if (++idle > max_idle) break;
+            if (idle % (max_idle / 4 + 1) == 0 && shared.size() < (int)best.size()) {
+                // stale: continue from the global best instead
+                const Snapshot *g = shared.get();
+                load(g->sol);
+                best = g->sol;
+                last_added = -1;
+                continue;
+            }
+            remove(pick_drop(last_added), step);
+            last_added = pick_add();
+            add(last_added, step);
+            for (int y : undom_) bump(y);
+        }
+        return best;
+    }
+
+  private:
+    uint64_t next() {
+        rng_ ^= rng_ << 13, rng_ ^= rng_ >> 7, rng_ ^= rng_ << 17;
+        return rng_;
+    }
+
+    template <class F>
+    void closed(int v, F &&f) {
+        f(v);
+        for (int u : s_.g.nbrs(v)) f(u);
+    }
+
+    void load(const std::vector<int> &sol) {
+        for (int v : sol_) in_[v] = 0, pos_[v] = -1;
+        sol_.clear();
+        for (int y : undom_) upos_[y] = -1;
+        undom_.clear();
+        std::fill(cnt_.begin(), cnt_.end(), 0);
+        std::fill(conf_.begin(), conf_.end(), 1);
+        for (int v : sol) {
+            in_[v] = 1, pos_[v] = (int)sol_.size();
+            sol_.push_back(v);
+            closed(v, [&](int y) { cnt_[y]++; });
+        }
+        for (int y = 0; y < n_; y++)
+            if (s_.need[y] && cnt_[y] == 0) upos_[y] = (int)undom_.size(), undom_.push_back(y);
+        rescore();
+    }
+
+    void rescore() {
+        for (int v = 0; v < n_; v++) {
+            int sc = 0;
+            closed(v, [&](int y) {
+                if (s_.need[y] && cnt_[y] == (in_[v] ? 1 : 0)) sc += w_[y];
+            });
+            score_[v] = sc;
+        }
+    }
+
+    // the only plant in N[y]
+    int sole_dominator(int y) {
+        if (in_[y]) return y;
+        for (int u : s_.g.nbrs(y))
+            if (in_[u]) return u;
+        return -1;
+    }
+
+    void add(int v, long long step) {
+        in_[v] = 1, pos_[v] = (int)sol_.size(), age_[v] = step;
+        sol_.push_back(v);
+        int loss = 0;
+        closed(v, [&](int y) {
+            if (!s_.need[y]) return;
+            if (++cnt_[y] == 1) {
+                int i = upos_[y], last = undom_.back();
+                undom_[i] = last, upos_[last] = i;
+                undom_.pop_back(), upos_[y] = -1;
+                closed(y, [&](int u) {
+                    if (u != v) score_[u] -= w_[y];
+                });
+                loss += w_[y];
+            } else if (cnt_[y] == 2) {
+                int x = -1;
+                closed(y, [&](int u) {
+                    if (u != v && in_[u]) x = u;
+                });
+                score_[x] -= w_[y];
+            }
+        });
+        score_[v] = loss;
+        for (int y : s_.g.nbrs(v)) closed(y, [&](int u) { conf_[u] = 1; });
+    }
+
+    void remove(int v, long long step) {
+        in_[v] = 0, age_[v] = step;
+        int i = pos_[v], last = sol_.back();
+        sol_[i] = last, pos_[last] = i;
+        sol_.pop_back(), pos_[v] = -1;
+        int gain = 0;
+        closed(v, [&](int y) {
+            if (!s_.need[y]) return;
+            if (--cnt_[y] == 0) {
+                upos_[y] = (int)undom_.size(), undom_.push_back(y);
+                closed(y, [&](int u) {
+                    if (u != v) score_[u] += w_[y];
+                });
+                gain += w_[y];
+            } else if (cnt_[y] == 1) {
+                score_[sole_dominator(y)] += w_[y];
+            }
+        });
+        score_[v] = gain;
+        for (int y : s_.g.nbrs(v)) closed(y, [&](int u) { conf_[u] = 1; });
+        conf_[v] = 0;
+    }
+
+    void bump(int y) {
+        closed(y, [&](int u) { score_[u]++; });
+        if (++w_[y] < kWeightCap) return;
+        for (int v = 0; v < n_; v++) w_[v] = std::max(1, w_[v] / 2);
+        rescore();
+    }
+
+    // Plant with the smallest loss (oldest on ties), never `keep`.
+    int pick_drop(int keep) {
+        const int k = (int)sol_.size();
+        int best = -1;
+        auto consider = [&](int v) {
+            if (v == keep && k > 1) return;
+            if (best == -1 || score_[v] < score_[best] ||
+                (score_[v] == score_[best] && age_[v] < age_[best]))
+                best = v;
+        };
+        if (k <= kSample) {
+            for (int v : sol_) consider(v);
+        } else {
+            for (int t = 0; t < kSample; t++) consider(sol_[next() % k]);
+        }
+        return best;
+    }
+
+    // Best candidate next to a random dark vertex; configuration checking
+    // first, falling back to any candidate if all are blocked.
+    int pick_add() {
+        int y = undom_[next() % undom_.size()];
+        int best = -1, any = -1;
+        closed(y, [&](int u) {
+            if (!s_.cand[u]) return;
+            auto better = [&](int a) {
+                return a == -1 || score_[u] > score_[a] || (score_[u] == score_[a] && age_[u] < age_[a]);
+            };
+            if (better(any)) any = u;
+            if (conf_[u] && better(best)) best = u;
+        });
+        return best != -1 ? best : any;
+    }
+
+    const Sub &s_;
+    const int n_;
+    std::vector<char> in_, conf_;
+    std::vector<int> pos_, upos_, cnt_, w_, score_;
+    std::vector<long long> age_;
+    std::vector<int> sol_, undom_;
+    uint64_t rng_;
+};
+
+}  // namespace detail
+
+// Improve a dominating set of s until limits.deadline. Stops early once no
+// worker has improved for a while, so tiny components return quickly.
+inline std::vector<int> improve(const Sub &s, const std::vector<int> &start, const SearchLimits &limits) {
+    if (start.size() <= 1 || Clock::now() >= limits.deadline) return start;
+    const long long max_idle = 20000 + 50LL * s.size();
+    detail::SharedBest shared(start);
+    std::atomic<bool> stop{false};
+    auto worker = [&](int t) {
+        detail::LocalSearch ls(s, limits.seed + 7919ULL * t);
+        ls.run(start, shared, stop, limits.deadline, max_idle);
+    };
+    const int threads = std::max(1, limits.threads);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &th : pool) th.join();
+    return shared.get()->sol;
+}
+
+}  // namespace mds
@@ -0,0 +1,80 @@
+// parallel.h
+// Threading helpers for the mds engine: a fork-join parallel_for and a
+// small work-stealing pool for irregular tasks (one per component).
+
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mds {
+
+inline int default_threads() {
+    unsigned t = std::thread::hardware_concurrency();
+    return t ? (int)t : 1;
+}
+
+// f(t) for t in [0, threads), t = 0 on the calling thread.
+template <class F>
+void parallel_for(int threads, F &&f) {
+    if (threads <= 1) { f(0); return; }
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(f, t);
+    f(0);
+    for (auto &th : pool) th.join();
+}
+
+// Runs a fixed batch of tasks. Tasks are dealt round-robin in the given
+// order (put the big ones first) into per-worker deques; a worker works
+// through its own deque from the front and, once it is empty, steals the
+// smallest leftovers from the back of the others.
+class WorkStealingPool {
+  public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threads) : threads_(std::max(1, threads)) {}
+
+    void run(std::vector<Task> tasks) {
+        const int w = std::min<int>(threads_, std::max<size_t>(1, tasks.size()));
+        std::vector<Queue> q(w);
+        for (size_t i = 0; i < tasks.size(); i++) q[i % w].tasks.push_back(std::move(tasks[i]));
+        parallel_for(w, [&](int me) {
+            Task task;
+            while (true) {
+                bool got = q[me].pop_front(task);
+                for (int k = 1; !got && k < w; k++) got = q[(me + k) % w].pop_back(task);
+                if (!got) break;  // nothing is pushed after the start, so we are done
+                task();
+            }
+        });
+    }
+
+  private:
+    struct Queue {
+        std::mutex mu;
+        std::deque<Task> tasks;
+
+        bool pop_back(Task &t) {
+            std::lock_guard<std::mutex> lock(mu);
+            if (tasks.empty()) return false;
+            t = std::move(tasks.back());
+            tasks.pop_back();
+            return true;
+        }
+        bool pop_front(Task &t) {
+            std::lock_guard<std::mutex> lock(mu);
+            if (tasks.empty()) return false;
+            t = std::move(tasks.front());
+            tasks.pop_front();
+            return true;
+        }
+    };
+
+    int threads_;
+};
+
+}  // namespace mds
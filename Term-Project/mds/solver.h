@@ -0,0 +1,99 @@
+// solver.h
+// Minimum dominating set pipeline:
+//   1. kernelize (kernel.h) - forced plants are final
+//   2. label the residual components with a concurrent union-find
+//      (components.h)
+//   3. per component, on a work-stealing pool (parallel.h):
+//        few needed vertices -> exact subset DP (exact.h)
+//        tree / ring         -> exact linear DP (tree.h)
+//        small treewidth     -> DP over a min-degree decomposition
+//                               (treewidth.h)
+//        anything else       -> bucket-queue greedy + prune (greedy.h),
+//                               then local search (local_search.h); if
+//                               small enough, branch and reduce (exact.h)
+//                               then proves or improves that bound
+//   Components big enough for a multithreaded search run afterwards, one
+//   at a time, with every thread.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "components.h"
+#include "exact.h"
+#include "graph.h"
+#include "greedy.h"
+#include "kernel.h"
+#include "local_search.h"
+#include "parallel.h"
+#include "tree.h"
+#include "treewidth.h"
+
+namespace mds {
+
+struct Options {
+    int budget_ms = 1000;  // wall clock for the local search, whole graph
+    int threads = 0;       // <= 0: hardware concurrency
+    uint64_t seed = 1;
+};
+
+// From this size on a component gets the whole machine for its search;
+// smaller ones share the pool, one thread each.
+constexpr int kParallelSearchMin = 512;
+
+inline std::vector<int> solve_component(const Sub &s, const SearchLimits &limits) {
+    if (count_need(s) <= kTinyNeed) return solve_tiny(s);
+    if (is_tree(s)) return solve_tree(s);
+    if (is_ring(s)) return solve_ring(s);
+    std::vector<int> sol;
+    if (solve_treewidth(s, sol)) return sol;
+    sol = improve(s, greedy(s), limits);
+    if (fits_exact(s)) solve_exact(s, sol, limits.deadline);  // best effort: sol stays valid
+    return sol;
+}
+
+// Returns in_set[v] for every vertex of g.
+inline std::vector<char> solve(const Graph &g, const Options &opt = {}) {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(opt.budget_ms);
+    const int threads = opt.threads > 0 ? opt.threads : default_threads();
+
+    Kernel k(g);
+    k.reduce();
+    std::vector<char> in_set = k.chosen;
+    Components comps = label_components(g, k.need, k.cand, threads);
+
+    // Search time is shared by size: a component starting now gets its
+    // fraction of the vertices not yet started, scaled by the number of
+    // components that run side by side.
+    long long total = 0;
+    for (auto &m : comps.members) total += (long long)m.size();
+    std::atomic<long long> left{total};
+    std::vector<int> local(g.n);
+    auto run = [&](const std::vector<int> &members, int search_threads, int width) {
+        Sub s = make_sub(g, k.need, k.cand, members, local);
+        SearchLimits limits;
+        limits.threads = search_threads;
+        limits.seed = opt.seed;
+        long long rest = left.fetch_sub(s.size());
+        auto now = Clock::now();
+        limits.deadline = now;
+        if (deadline > now)
+            limits.deadline += std::min<Clock::duration>(
+                deadline - now, std::chrono::duration_cast<Clock::duration>(
+                                    (deadline - now) * s.size() * width / std::max(1LL, rest)));
+        for (int v : solve_component(s, limits)) in_set[s.orig[v]] = 1;
+    };
+
+    std::vector<WorkStealingPool::Task> small;
+    size_t big = 0;
+    while (big < comps.members.size() && (int)comps.members[big].size() >= kParallelSearchMin) big++;
+    for (size_t c = big; c < comps.members.size(); c++)
+        small.push_back([&, c] { run(comps.members[c], 1, threads); });
+    WorkStealingPool(threads).run(std::move(small));
+    for (size_t c = 0; c < big; c++) run(comps.members[c], threads, 1);
+    return in_set;
+}
+
+}  // namespace mds
@@ -0,0 +1,158 @@
+// tree.h
+// Linear-time optimal solvers for components that are trees or rings.
+//
+// Tree DP keeps three states per vertex:
+//   A - v hosts a plant
+//   B - v has no plant and is already dominated from below (or not needed)
+//   C - v has no plant, is needed, and waits for its parent
+// A ring is cut at one vertex and the remaining path is solved by the same
+// DP under each of the (at most three) ways that vertex can be handled.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "kernel.h"
+
+namespace mds {
+
+namespace detail {
+
+constexpr int kInf = 1 << 29;
+inline int sat(long long x) { return x >= kInf ? kInf : (int)x; }
+
+// Optimal annotated dominating set of a forest. force[v] pins a plant on v.
+// Returns the cost (kInf if infeasible) and appends chosen ids to out.
+inline int forest_dp(const Graph &g, const std::vector<char> &need,
+                     const std::vector<char> &cand, const std::vector<char> &force,
+                     std::vector<int> &out) {
+    const int n = g.n;
+    std::vector<int> order, parent(n, -2), A(n), B(n), C(n), push_child(n, -1);
+    order.reserve(n);
+    for (int r = 0; r < n; r++) {
+        if (parent[r] != -2) continue;
+        parent[r] = -1;
+        order.push_back(r);
+        for (size_t h = order.size() - 1; h < order.size(); h++) {
+            int v = order[h];
+            for (int u : g.nbrs(v))
+                if (parent[u] == -2) parent[u] = v, order.push_back(u);
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        int v = order[i];
+        long long sum_abc = 0, sum_ab = 0, sum_b = 0;
+        int gap = kInf, gap_child = -1;
+        bool free_a = false;
+        for (int c : g.nbrs(v)) {
+            if (c == parent[v]) continue;
+            sum_abc += std::min({A[c], B[c], C[c]});
+            sum_ab += std::min(A[c], B[c]);
+            sum_b += B[c];
+            if (A[c] <= B[c]) free_a = true;
+            else if (A[c] - B[c] < gap) gap = A[c] - B[c], gap_child = c;
+        }
+        A[v] = cand[v] ? sat(1 + sum_abc) : kInf;
+        if (force[v]) {
+            B[v] = C[v] = kInf;
+        } else if (!need[v]) {
+            B[v] = sat(sum_ab);
+            C[v] = kInf;
+        } else {
+            B[v] = free_a ? sat(sum_ab) : sat(sum_ab + gap);
+            push_child[v] = free_a ? -1 : gap_child;
+            C[v] = sat(sum_b);
+        }
+    }
+
+    // top-down reconstruction; state 0/1/2 = A/B/C
+    std::vector<char> st(n);
+    int total = 0;
+    for (int v : order) {
+        int p = parent[v];
+        if (p == -1) {
+            st[v] = A[v] <= B[v] ? 0 : 1;
+            total = sat((long long)total + std::min(A[v], B[v]));
+        } else if (st[p] == 0) {
+            int best = std::min({A[v], B[v], C[v]});
+            st[v] = A[v] == best ? 0 : B[v] == best ? 1 : 2;
+        } else if (st[p] == 1) {
+            st[v] = (v == push_child[p] || A[v] <= B[v]) ? 0 : 1;
+        } else {
+            st[v] = 1;
+        }
+        if (st[v] == 0) out.push_back(v);
+    }
+    return total;
+}
+
+}  // namespace detail
+
+inline bool is_tree(const Sub &s) { return s.g.edges() == s.size() - 1; }
+
+inline bool is_ring(const Sub &s) {
+    if (s.size() < 3 || s.g.edges() != s.size()) return false;
+    for (int v = 0; v < s.size(); v++)
+        if (s.g.deg(v) != 2) return false;
+    return true;
+}
+
+inline std::vector<int> solve_tree(const Sub &s) {
+    std::vector<int> out;
+    std::vector<char> force(s.size(), 0);
+    detail::forest_dp(s.g, s.need, s.cand, force, out);
+    return out;
+}
+
+inline std::vector<int> solve_ring(const Sub &s) {
+    using detail::kInf;
+    const int k = s.size();
+    // walk the ring from 0: ring[0] is cut off, ring[1..k-1] is a path
+    std::vector<int> ring{0};
+    for (int prev = -1, v = 0; (int)ring.size() < k;) {
+        const int *nb = s.g.nbrs(v).begin();
+        int nxt = nb[0] != prev ? nb[0] : nb[1];
+        prev = v, v = nxt;
+        ring.push_back(v);
+    }
+    const int m = k - 1;
+    std::vector<int> eu, ev;
+    for (int i = 0; i + 1 < m; i++) eu.push_back(i), ev.push_back(i + 1);
+    Graph path = from_edges(m, eu, ev);
+    std::vector<char> need(m), cand(m), force(m, 0);
+    for (int i = 0; i < m; i++) need[i] = s.need[ring[i + 1]], cand[i] = s.cand[ring[i + 1]];
+
+    int best = kInf;
+    std::vector<int> best_out, out;
+    auto consider = [&](int base, const std::vector<char> &nd, bool head_plant) {
+        out.clear();
+        int c = detail::forest_dp(path, nd, cand, force, out);
+        if (c >= kInf || base + c >= best) return;
+        best = base + c;
+        best_out.clear();
+        if (head_plant) best_out.push_back(ring[0]);
+        for (int i : out) best_out.push_back(ring[i + 1]);
+    };
+    // ring[0] hosts a plant: both ends of the path are covered
+    if (s.cand[ring[0]]) {
+        std::vector<char> nd = need;
+        nd[0] = nd[m - 1] = 0;
+        consider(1, nd, true);
+    }
+    // ring[0] has no plant: one of its two neighbours must, if it is needed
+    if (!s.need[ring[0]]) {
+        consider(0, need, false);
+    } else {
+        for (int end : {0, m - 1}) {
+            if (!cand[end]) continue;
+            force[end] = 1;
+            consider(0, need, false);
+            force[end] = 0;
+        }
+    }
+    return best_out;
+}
+
+}  // namespace mds
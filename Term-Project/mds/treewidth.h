@@ -0,0 +1,262 @@
+// treewidth.h
+// Optimal solver for components of small treewidth (near-trees, rings with
+// chords, chain backbones).
+//
+// A min-degree elimination order gives the tree decomposition: eliminating
+// v turns its remaining neighbours upper[v] into a clique, the bag of v is
+// {v} + upper[v], and its parent is the first vertex of upper[v] to go.
+// The table of v is a flat array over upper[v], one base-3 digit per
+// vertex:
+//   P - plant (paid for when that vertex is eliminated)
+//   D - no plant, dominated by some vertex eliminated below
+//   F - no plant, free: dominated below or not, so T[F] <= T[D]
+// A bag starts from v's own choice, then merges its children one at a
+// time: a D in the result comes from one side being D and the other F, so
+// a merge over a bag of b vertices costs at most 4^b. Eliminating v then
+// keeps the assignments where v is planted, dominated below, not needed,
+// or next to a planted vertex of upper[v].
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "kernel.h"
+#include "tree.h"
+
+namespace mds {
+
+// Largest separator the DP accepts, and the most merge steps it may spend
+// on one component (sum over bags of children * 4^bag).
+constexpr int kMaxTreewidth = 7;
+constexpr long long kMaxTreewidthWork = 1LL << 24;
+
+struct Decomposition {
+    std::vector<int> order;               // elimination order
+    std::vector<std::vector<int>> upper;  // separator of each vertex's bag
+    std::vector<int> parent;              // -1 at a root
+    int width = 0;                        // max |upper[v]|
+};
+
+// Min-degree elimination. Returns false as soon as every remaining vertex
+// has more than max_width neighbours, or the remaining graph has more
+// edges than a chordal graph of that width could (max_width per vertex).
+// Only vertices of degree <= max_width are queued (lazily, one bucket per
+// degree); rows are unsorted and fill is found by stamping.
+inline bool min_degree_decomposition(const Graph &g, int max_width, Decomposition &td) {
+    const int n = g.n;
+    long long live = g.edges();
+    if (live > (long long)n * max_width) return false;
+    std::vector<std::vector<int>> adj(n), bucket(max_width + 1);
+    for (int v = 0; v < n; v++) {
+        adj[v].assign(g.nbrs(v).begin(), g.nbrs(v).end());
+        if (g.deg(v) <= max_width) bucket[g.deg(v)].push_back(v);
+    }
+    td = Decomposition{};
+    td.upper.resize(n);
+    td.parent.assign(n, -1);
+    std::vector<int> pos(n, -1), stamp(n, -1);
+    auto requeue = [&](int u) {
+        if ((int)adj[u].size() <= max_width) bucket[adj[u].size()].push_back(u);
+    };
+    for (int left = n; left > 0; left--) {
+        if (live > (long long)left * max_width) return false;
+        int v = -1;
+        for (int d = 0; d <= max_width && v < 0; d++)
+            while (!bucket[d].empty() && v < 0) {
+                int u = bucket[d].back();
+                bucket[d].pop_back();
+                if (pos[u] < 0 && (int)adj[u].size() == d) v = u;  // skip stale entries
+            }
+        if (v < 0) return false;
+        pos[v] = n - left;
+        td.order.push_back(v);
+        std::vector<int> &up = td.upper[v];
+        up = std::move(adj[v]);
+        td.width = std::max(td.width, (int)up.size());
+        live -= (long long)up.size();
+        for (int u : up) {
+            auto it = std::find(adj[u].begin(), adj[u].end(), v);
+            *it = adj[u].back();
+            adj[u].pop_back();
+        }
+        for (size_t i = 0; i < up.size(); i++) {
+            int a = up[i];
+            for (int x : adj[a]) stamp[x] = a;
+            for (size_t j = 0; j < up.size(); j++) {
+                int b = up[j];
+                if (b == a || stamp[b] == a) continue;
+                adj[a].push_back(b);
+                if (a < b) live++;
+            }
+        }
+        for (int u : up) requeue(u);
+    }
+    // the parent is eliminated later, so it is still unknown at v's turn
+    for (int v = 0; v < n; v++)
+        for (int u : td.upper[v])
+            if (td.parent[v] == -1 || pos[u] < pos[td.parent[v]]) td.parent[v] = u;
+    return true;
+}
+
+namespace detail {
+
+class TreewidthDp {
+  public:
+    enum : int { P = 0, D = 1, F = 2 };
+
+    TreewidthDp(const Sub &s, const Decomposition &td)
+        : s_(s), td_(td), children_(s.size()), table_(s.size()), where_(s.size(), -1),
+          next_(s.size(), 0) {
+        for (int v : td.order)
+            if (td.parent[v] >= 0) children_[td.parent[v]].push_back(v);
+        pow3_.push_back(1);
+        for (int i = 0; i <= td.width + 1; i++) pow3_.push_back(pow3_.back() * 3);
+    }
+
+    // Merge steps the DP will take; callers compare with kMaxTreewidthWork.
+    long long work() const {
+        long long w = 0;
+        for (int v : td_.order) w += (long long)(children_[v].size() + 1) << (2 * (td_.upper[v].size() + 1));
+        return w;
+    }
+
+    std::vector<int> solve() {
+        for (int v : td_.order) {
+            std::vector<std::vector<int>> acc;
+            build(v, acc, false);
+            table_[v] = eliminate(v, acc.back());
+        }
+        std::vector<int> out;
+        std::vector<std::pair<int, int>> todo;  // (vertex, index into its table)
+        for (int v : td_.order)
+            if (td_.parent[v] == -1) todo.push_back({v, 0});
+        while (!todo.empty()) {
+            auto [v, r] = todo.back();
+            todo.pop_back();
+            trace(v, r, out, todo);
+        }
+        return out;
+    }
+
+  private:
+    int digit(int x, int i) const { return x / pow3_[i] % 3; }
+
+    // Bag coordinates: v is 0, upper[v][i] is i + 1.
+    void place(int v) {
+        where_[v] = 0;
+        for (size_t i = 0; i < td_.upper[v].size(); i++) where_[td_.upper[v][i]] = (int)i + 1;
+    }
+
+    // acc[0] is v's own choice, acc[k] has the first k children merged in.
+    // Keeps only the last table unless keep_all is set (reconstruction).
+    void build(int v, std::vector<std::vector<int>> &acc, bool keep_all) {
+        const std::vector<int> &up = td_.upper[v];
+        const int b = (int)up.size() + 1;
+        for (int u : s_.g.nbrs(v)) next_[u] = 1;
+        std::vector<int> base(pow3_[b], kInf);
+        for (int x = 0; x < pow3_[b]; x++) {
+            int vs = digit(x, 0);
+            if (vs == D || (vs == P && !s_.cand[v])) continue;
+            bool ok = true;
+            for (int i = 1; i < b && ok; i++) {
+                int d = digit(x, i), u = up[i - 1];
+                ok = d == F || (d == P && s_.cand[u]) || (d == D && vs == P && next_[u]);
+            }
+            if (ok) base[x] = vs == P ? 1 : 0;
+        }
+        for (int u : s_.g.nbrs(v)) next_[u] = 0;
+        acc.clear();
+        acc.push_back(std::move(base));
+        place(v);
+        for (int c : children_[v]) {
+            std::vector<int> merged(pow3_[b], kInf);
+            const std::vector<int> &prev = acc.back(), &child = table_[c];
+            for (int x = 0; x < pow3_[b]; x++)
+                options(c, x, [&](int y, int z) { merged[x] = std::min(merged[x], sat((long long)prev[y] + child[z])); });
+            if (!keep_all) acc.clear();
+            acc.push_back(std::move(merged));
+        }
+    }
+
+    // Every split of bag state x into (accumulated y, child table z).
+    // Requires place(parent) for the bag coordinates.
+    template <class Fn>
+    void options(int c, int x, Fn &&fn) {
+        const std::vector<int> &up = td_.upper[c];
+        int y = x, z = 0, nd = 0;
+        int dpos[kMaxTreewidth + 1], dcoord[kMaxTreewidth + 1];
+        for (size_t j = 0; j < up.size(); j++) {
+            int i = where_[up[j]], d = digit(x, i);
+            if (d == D) dpos[nd] = (int)j, dcoord[nd] = i, nd++;
+            else z += d * pow3_[j];
+        }
+        // D splits as (y D, z F) or (y F, z D)
+        for (int mask = 0; mask < 1 << nd; mask++) {
+            int yy = y, zz = z;
+            for (int t = 0; t < nd; t++) {
+                if (mask >> t & 1) yy += pow3_[dcoord[t]], zz += D * pow3_[dpos[t]];
+                else zz += F * pow3_[dpos[t]];
+            }
+            fn(yy, zz);
+        }
+    }
+
+    bool may_eliminate(int v, int x) {
+        int vs = digit(x, 0);
+        if (vs != F || !s_.need[v]) return true;
+        const std::vector<int> &up = td_.upper[v];
+        for (size_t i = 0; i < up.size(); i++)
+            if (digit(x, (int)i + 1) == P && s_.g.closed(v, up[i])) return true;
+        return false;
+    }
+
+    std::vector<int> eliminate(int v, const std::vector<int> &acc) {
+        std::vector<int> t(pow3_[td_.upper[v].size()], kInf);
+        for (int x = 0; x < (int)acc.size(); x++)
+            if (may_eliminate(v, x)) t[x / 3] = std::min(t[x / 3], acc[x]);
+        return t;
+    }
+
+    // v's table entry r is final; pick v's state and the child entries
+    // that reach it.
+    void trace(int v, int r, std::vector<int> &out, std::vector<std::pair<int, int>> &todo) {
+        std::vector<std::vector<int>> acc;
+        build(v, acc, true);
+        int x = -1;
+        for (int vs : {P, D, F})
+            if (x < 0 && may_eliminate(v, vs + 3 * r) && acc.back()[vs + 3 * r] == table_[v][r]) x = vs + 3 * r;
+        place(v);
+        for (size_t k = children_[v].size(); k-- > 0;) {
+            int c = children_[v][k], want = acc[k + 1][x], ny = -1, nz = -1;
+            options(c, x, [&](int y, int z) {
+                if (ny < 0 && sat((long long)acc[k][y] + table_[c][z]) == want) ny = y, nz = z;
+            });
+            todo.push_back({c, nz});
+            x = ny;
+        }
+        if (digit(x, 0) == P) out.push_back(v);
+    }
+
+    const Sub &s_;
+    const Decomposition &td_;
+    std::vector<std::vector<int>> children_, table_;
+    std::vector<int> where_, pow3_;
+    std::vector<char> next_;  // scratch: neighbours of the bag's vertex
+};
+
+}  // namespace detail
+
+// Optimal set for s if its treewidth (by min-degree) and DP work are small
+// enough; false leaves out untouched.
+inline bool solve_treewidth(const Sub &s, std::vector<int> &out) {
+    Decomposition td;
+    if (!min_degree_decomposition(s.g, kMaxTreewidth, td)) return false;
+    detail::TreewidthDp dp(s, td);
+    if (dp.work() > kMaxTreewidthWork) return false;
+    out = dp.solve();
+    return true;
+}
+
+}  // namespace mds
@@ -0,0 +1,465 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks the set cover solution generators and improvers on the
+// OR-Library scp and rail instances, and on larger random models generated
+// from them with SetCoverModel::GenerateRandomModelFrom.
+//
+// Every generator is run on every instance, and every improver is run from
+// the solution of every generator. Each run is written as one JSON object per
+// line to --output, with:
+// - the size of the model,
+// - the time spent reading or generating the model, initializing the
+//   invariant, computing the first solution, and improving it,
+// - the time to the first solution, which includes the initialization,
+// - the cost of the first solution and the cost-versus-time curve of the
+//   improvement, sampled after each round of --iterations_per_round
+//   iterations,
+// - the peak resident set size of the run. On Linux, the peak is reset before
+//   each run. Elsewhere, it is the peak since the start of the process, which
+//   is still meaningful since the instances are run by increasing scale.
+//
+// Usage:
+//   set_cover_benchmarks --benchmarks_dir=/path/to/orlib
+//     --output=/tmp/set_cover.jsonl --scales=1,10
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/log/check.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "ortools/algorithms/set_cover_heuristics.h"
+#include "ortools/algorithms/set_cover_invariant.h"
+#include "ortools/algorithms/set_cover_lagrangian.h"
+#include "ortools/algorithms/set_cover_lns.h"
+#include "ortools/algorithms/set_cover_model.h"
+#include "ortools/algorithms/set_cover_reader.h"
+#include "ortools/base/file.h"
+#include "ortools/base/init_google.h"
+#include "ortools/base/logging.h"
+#include "ortools/base/path.h"
+#include "ortools/base/timer.h"
+
+#if !defined(_MSC_VER)
+#include <sys/resource.h>
+#endif
+
+ABSL_FLAG(std::string, benchmarks_dir, "",
+          "REQUIRED: Directory containing the OR-Library files.");
+ABSL_FLAG(std::vector<std::string>, scp_files,
+          std::vector<std::string>({"scp41.txt", "scp51.txt", "scp61.txt",
+                                    "scpa1.txt", "scpb1.txt", "scpc1.txt",
+                                    "scpd1.txt", "scpe1.txt", "scpnre1.txt",
+                                    "scpnrf1.txt", "scpnrg1.txt",
+                                    "scpnrh1.txt"}),
+          "OR-Library scp files, in --benchmarks_dir. Missing files are "
+          "skipped.");
+ABSL_FLAG(std::vector<std::string>, rail_files,
+          std::vector<std::string>({"rail507", "rail516", "rail582",
+                                    "rail2536", "rail2586", "rail4284",
+                                    "rail4872"}),
+          "OR-Library rail files, in --benchmarks_dir. Missing files are "
+          "skipped.");
+ABSL_FLAG(std::vector<std::string>, scales,
+          std::vector<std::string>({"1", "10", "100"}),
+          "Scale factors of the models. A model of scale s has s times as many "
+          "elements and subsets as the instance it is generated from.");
+ABSL_FLAG(int64_t, max_num_nonzeros, int64_t{1} << 28,
+          "Scaled models with more nonzeros than this are skipped.");
+ABSL_FLAG(std::vector<std::string>, generators,
+          std::vector<std::string>({"Greedy", "ParallelGreedy",
+                                    "ElementDegree", "LazyElementDegree"}),
+          "First-solution generators. Among Trivial, Random, Greedy, "
+          "ParallelGreedy, ElementDegree and LazyElementDegree.");
+ABSL_FLAG(std::vector<std::string>, improvers,
+          std::vector<std::string>({"None", "Steepest", "GuidedLocalSearch",
+                                    "GuidedTabuSearch", "LagrangianThreePhase",
+                                    "Lns"}),
+          "Solution improvers. Among None, Steepest, GuidedLocalSearch, "
+          "GuidedTabuSearch, LagrangianThreePhase and Lns.");
+ABSL_FLAG(int, improvement_rounds, 20,
+          "Number of rounds of each improver, after each of which the cost is "
+          "sampled.");
+ABSL_FLAG(int, iterations_per_round, 100,
+          "Number of iterations of the improvers per round.");
+ABSL_FLAG(int, lns_iterations_per_round, 5,
+          "Number of iterations of Lns per round, each solving a MIP.");
+ABSL_FLAG(double, lns_time_limit, 1.0,
+          "Time limit in seconds of each sub-problem solved by Lns.");
+ABSL_FLAG(int, num_threads, 4,
+          "Number of threads of ParallelGreedy and LagrangianThreePhase.");
+ABSL_FLAG(std::string, output, "",
+          "File receiving the results, as one JSON object per line. If empty, "
+          "the results are only logged.");
+
+namespace operations_research {
+namespace {
+using CL = SetCoverInvariant::ConsistencyLevel;
+
+// Resets the peak resident set size of the process, so that PeakRssBytes()
+// measures the peak from now on. Returns false when this is not supported.
+bool ResetPeakRss() {
+#if defined(__linux__)
+  FILE* const clear_refs = fopen("/proc/self/clear_refs", "w");
+  if (clear_refs == nullptr) return false;
+  const bool reset = fputs("5", clear_refs) >= 0;
+  return fclose(clear_refs) == 0 && reset;
+#else
+  return false;
+#endif
+}
+
+// Returns the peak resident set size of the process in bytes, or -1 if it is
+// not available.
+int64_t PeakRssBytes() {
+#if defined(__linux__)
+  // VmHWM is the peak since the last ResetPeakRss(), unlike ru_maxrss.
+  FILE* const status = fopen("/proc/self/status", "r");
+  if (status != nullptr) {
+    char line[256];
+    int64_t peak_kib = -1;
+    while (fgets(line, sizeof(line), status) != nullptr) {
+      if (strncmp(line, "VmHWM:", 6) == 0) {
+        peak_kib = strtoll(line + 6, nullptr, 10);
+        break;
+      }
+    }
+    fclose(status);
+    if (peak_kib >= 0) return peak_kib * 1024;
+  }
+#endif
+#if defined(_MSC_VER)
+  return -1;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+  return usage.ru_maxrss;  // In bytes.
+#else
+  return int64_t{1024} * usage.ru_maxrss;  // In KiB.
+#endif
+#endif
+}
+
+// A model to benchmark, with the time it took to read or generate it.
+struct BenchmarkModel {
+  std::string instance;
+  double scale;
+  SetCoverModel model;
+  double load_seconds;
+};
+
+// The result of one generator/improver run.
+struct RunResult {
+  std::string generator;
+  std::string improver;
+  double init_seconds = 0.0;
+  double first_solution_seconds = 0.0;
+  Cost first_cost = 0.0;
+  double improvement_seconds = 0.0;
+  Cost final_cost = 0.0;
+  int64_t peak_rss_bytes = -1;
+  bool peak_rss_is_per_run = false;
+  // Pairs (time since the start of the improvement, best cost so far).
+  std::vector<std::pair<double, Cost>> curve;
+};
+
+// Runs generator on inv. Returns false if the name is unknown.
+bool Generate(absl::string_view generator, SetCoverInvariant* inv) {
+  if (generator == "Trivial") {
+    CHECK(TrivialSolutionGenerator(inv).NextSolution());
+  } else if (generator == "Random") {
+    CHECK(RandomSolutionGenerator(inv).NextSolution());
+  } else if (generator == "Greedy") {
+    CHECK(GreedySolutionGenerator(inv).NextSolution());
+  } else if (generator == "ParallelGreedy") {
+    CHECK(ParallelGreedySolutionGenerator(inv, absl::GetFlag(FLAGS_num_threads))
+              .NextSolution());
+  } else if (generator == "ElementDegree") {
+    CHECK(ElementDegreeSolutionGenerator(inv).NextSolution());
+  } else if (generator == "LazyElementDegree") {
+    CHECK(LazyElementDegreeSolutionGenerator(inv).NextSolution());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// An improver, run round after round on the same invariant.
+class Improver {
+ public:
+  virtual ~Improver() = default;
+  virtual void RunRound(int num_iterations) = 0;
+
+  // Whether the improver has no notion of iterations, and is thus run in a
+  // single round.
+  virtual bool RunsOnce() const { return false; }
+};
+
+class SteepestImprover : public Improver {
+ public:
+  explicit SteepestImprover(SetCoverInvariant* inv) : steepest_(inv) {}
+  void RunRound(int num_iterations) override {
+    CHECK(steepest_.NextSolution(num_iterations));
+  }
+
+ private:
+  SteepestSearch steepest_;
+};
+
+class GuidedLocalSearchImprover : public Improver {
+ public:
+  explicit GuidedLocalSearchImprover(SetCoverInvariant* inv) : gls_(inv) {}
+  void RunRound(int num_iterations) override {
+    CHECK(gls_.NextSolution(num_iterations));
+  }
+
+ private:
+  GuidedLocalSearch gls_;
+};
+
+class GuidedTabuSearchImprover : public Improver {
+ public:
+  explicit GuidedTabuSearchImprover(SetCoverInvariant* inv)
+      : inv_(inv), tabu_(inv) {}
+  void RunRound(int num_iterations) override {
+    inv_->Recompute(CL::kFreeAndUncovered);
+    CHECK(tabu_.NextSolution(num_iterations));
+  }
+
+ private:
+  SetCoverInvariant* inv_;
+  GuidedTabuSearch tabu_;
+};
+
+// Runs the three phases of the Lagrangian heuristic from the solution.
+class LagrangianThreePhaseImprover : public Improver {
+ public:
+  explicit LagrangianThreePhaseImprover(SetCoverInvariant* inv)
+      : lagrangian_(inv, absl::GetFlag(FLAGS_num_threads)) {}
+  void RunRound(int /*num_iterations*/) override {
+    CHECK(lagrangian_.NextSolution());
+  }
+  bool RunsOnce() const override { return true; }
+
+ private:
+  SetCoverLagrangian lagrangian_;
+};
+
+class LnsImprover : public Improver {
+ public:
+  explicit LnsImprover(SetCoverInvariant* inv) : lns_(inv) {}
+  void RunRound(int /*num_iterations*/) override {
+    CHECK(lns_.NextSolution(absl::GetFlag(FLAGS_lns_iterations_per_round),
+                            absl::GetFlag(FLAGS_lns_time_limit)));
+  }
+
+ private:
+  SetCoverLns lns_;
+};
+
+// Returns the improver with the given name working on inv, or nullptr for
+// "None". Dies if the name is unknown.
+std::unique_ptr<Improver> MakeImprover(absl::string_view improver,
+                                       SetCoverInvariant* inv) {
+  if (improver == "None") return nullptr;
+  if (improver == "Steepest") return std::make_unique<SteepestImprover>(inv);
+  if (improver == "GuidedLocalSearch") {
+    return std::make_unique<GuidedLocalSearchImprover>(inv);
+  }
+  if (improver == "GuidedTabuSearch") {
+    return std::make_unique<GuidedTabuSearchImprover>(inv);
+  }
+  if (improver == "LagrangianThreePhase") {
+    return std::make_unique<LagrangianThreePhaseImprover>(inv);
+  }
+  if (improver == "Lns") return std::make_unique<LnsImprover>(inv);
+  LOG(FATAL) << "Unknown improver: " << improver;
+}
+
+// Runs the generator, then each improver from its solution, on the model.
+std::vector<RunResult> RunGenerator(absl::string_view generator,
+                                    const std::vector<std::string>& improvers,
+                                    SetCoverModel* model) {
+  std::vector<RunResult> results;
+  for (const std::string& improver_name : improvers) {
+    RunResult result;
+    result.generator = std::string(generator);
+    result.improver = improver_name;
+    result.peak_rss_is_per_run = ResetPeakRss();
+    WallTimer timer;
+    timer.Start();
+    SetCoverInvariant inv(model);
+    result.init_seconds = timer.Get();
+    timer.Restart();
+    CHECK(Generate(generator, &inv)) << "Unknown generator: " << generator;
+    result.first_solution_seconds = timer.Get();
+    // The generators only trace the subsets they selected themselves.
+    inv.LoadSolution(inv.is_selected());
+    inv.Recompute(CL::kFreeAndUncovered);
+    result.first_cost = inv.cost();
+    result.final_cost = inv.cost();
+    timer.Restart();
+    std::unique_ptr<Improver> improver = MakeImprover(improver_name, &inv);
+    if (improver != nullptr) {
+      for (int round = 0; round < absl::GetFlag(FLAGS_improvement_rounds);
+           ++round) {
+        improver->RunRound(absl::GetFlag(FLAGS_iterations_per_round));
+        result.final_cost = std::min(result.final_cost, inv.cost());
+        result.curve.push_back({timer.Get(), result.final_cost});
+        if (improver->RunsOnce()) break;
+      }
+    }
+    result.improvement_seconds = timer.Get();
+    result.peak_rss_bytes = PeakRssBytes();
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
+std::string ToJson(const BenchmarkModel& benchmark, const RunResult& result) {
+  const SetCoverModel& model = benchmark.model;
+  std::vector<std::string> curve;
+  for (const auto& [seconds, cost] : result.curve) {
+    curve.push_back(absl::StrFormat("[%.6f,%.17g]", seconds, cost));
+  }
+  return absl::StrFormat(
+      "{\"instance\":\"%s\",\"scale\":%g,\"num_elements\":%d,"
+      "\"num_subsets\":%d,\"num_nonzeros\":%d,\"generator\":\"%s\","
+      "\"improver\":\"%s\",\"load_s\":%.6f,\"init_s\":%.6f,"
+      "\"first_solution_s\":%.6f,\"time_to_first_solution_s\":%.6f,"
+      "\"first_cost\":%.17g,\"improvement_s\":%.6f,\"final_cost\":%.17g,"
+      "\"peak_rss_bytes\":%d,\"peak_rss_is_per_run\":%s,\"curve\":[%s]}",
+      benchmark.instance, benchmark.scale, model.num_elements(),
+      model.num_subsets(), model.num_nonzeros(), result.generator,
+      result.improver, benchmark.load_seconds, result.init_seconds,
+      result.first_solution_seconds,
+      result.init_seconds + result.first_solution_seconds, result.first_cost,
+      result.improvement_seconds, result.final_cost, result.peak_rss_bytes,
+      result.peak_rss_is_per_run ? "true" : "false",
+      absl::StrJoin(curve, ","));
+}
+
+// Reads the instance, with the reader matching its name, or returns false if
+// the file does not exist.
+bool ReadInstance(absl::string_view dir, absl::string_view name,
+                  BenchmarkModel* benchmark) {
+  const std::string filename = file::JoinPath(dir, name);
+  if (!file::Exists(filename, file::Defaults()).ok()) {
+    LOG(WARNING) << "Skipping missing file " << filename;
+    return false;
+  }
+  WallTimer timer;
+  timer.Start();
+  benchmark->instance = std::string(name);
+  benchmark->scale = 1.0;
+  benchmark->model = absl::StartsWith(name, "rail") ? ReadOrlibRail(filename)
+                                                     : ReadOrlibScp(filename);
+  benchmark->model.CreateSparseRowView();
+  benchmark->load_seconds = timer.Get();
+  return true;
+}
+
+void RunBenchmarks() {
+  const std::string& dir = absl::GetFlag(FLAGS_benchmarks_dir);
+  CHECK(!dir.empty()) << "--benchmarks_dir is required.";
+  std::vector<double> scales;
+  for (const std::string& scale : absl::GetFlag(FLAGS_scales)) {
+    double value;
+    CHECK(absl::SimpleAtod(scale, &value) && value > 0.0)
+        << "Invalid scale: " << scale;
+    scales.push_back(value);
+  }
+  std::sort(scales.begin(), scales.end());
+  File* output = nullptr;
+  if (!absl::GetFlag(FLAGS_output).empty()) {
+    output = file::OpenOrDie(absl::GetFlag(FLAGS_output), "w",
+                             file::Defaults());
+  }
+  std::vector<std::string> instances = absl::GetFlag(FLAGS_scp_files);
+  for (const std::string& rail : absl::GetFlag(FLAGS_rail_files)) {
+    instances.push_back(rail);
+  }
+  for (const std::string& instance : instances) {
+    BenchmarkModel seed;
+    if (!ReadInstance(dir, instance, &seed)) continue;
+    for (const double scale : scales) {
+      BenchmarkModel benchmark;
+      if (scale == 1.0) {
+        benchmark = seed;
+      } else {
+        if (seed.model.num_nonzeros() * scale >
+            absl::GetFlag(FLAGS_max_num_nonzeros)) {
+          LOG(INFO) << "Skipping " << instance << " at scale " << scale;
+          continue;
+        }
+        WallTimer timer;
+        timer.Start();
+        benchmark.instance = instance;
+        benchmark.scale = scale;
+        benchmark.model = SetCoverModel::GenerateRandomModelFrom(
+            seed.model, seed.model.num_elements() * scale,
+            seed.model.num_subsets() * scale, /*row_scale=*/1.0,
+            /*column_scale=*/1.0, /*cost_scale=*/1.0);
+        benchmark.load_seconds = timer.Get();
+      }
+      // The generators and improvers only read the flat views. The seed keeps
+      // its nested views for GenerateRandomModelFrom.
+      WallTimer release_timer;
+      release_timer.Start();
+      benchmark.model.ReleaseNestedViews();
+      benchmark.load_seconds += release_timer.Get();
+      for (const std::string& generator : absl::GetFlag(FLAGS_generators)) {
+        for (const RunResult& result :
+             RunGenerator(generator, absl::GetFlag(FLAGS_improvers),
+                          &benchmark.model)) {
+          LOG(INFO) << ", " << instance << ".x" << scale << ", "
+                    << result.generator << "+" << result.improver
+                    << ", cost, " << result.final_cost
+                    << ", time_to_first_solution, "
+                    << result.init_seconds + result.first_solution_seconds
+                    << ", s, improvement, " << result.improvement_seconds
+                    << ", s, peak_rss, " << result.peak_rss_bytes;
+          if (output != nullptr) {
+            CHECK_OK(file::WriteString(
+                output, absl::StrCat(ToJson(benchmark, result), "\n"),
+                file::Defaults()));
+          }
+        }
+      }
+    }
+  }
+  if (output != nullptr) {
+    CHECK_OK(output->Close(file::Defaults()));
+  }
+}
+}  // namespace
+}  // namespace operations_research
+
+int main(int argc, char** argv) {
+  InitGoogle(argv[0], &argc, &argv, true);
+  operations_research::RunBenchmarks();
+  return 0;
+}
@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <numeric>
@@ -31,6 +32,7 @@
 #include "ortools/algorithms/set_cover_invariant.h"
 #include "ortools/algorithms/set_cover_model.h"
 #include "ortools/base/logging.h"
+#include "ortools/base/threadpool.h"
 
 namespace operations_research {
 
@@ -327,7 +329,7 @@ std::vector<ElementIndex> GetUncoveredElementsSortedByDegree(
   degree_sorted_elements.reserve(num_elements);
   std::vector<BaseInt> keys;
   keys.reserve(num_elements);
-  const SparseRowView& rows = inv->model()->rows();
+  const FlatRowView& rows = inv->model()->flat_rows();
   BaseInt max_degree = 0;
   for (const ElementIndex element : inv->model()->ElementRange()) {
     // Already covered elements should not be considered.
@@ -390,7 +392,7 @@ bool ElementDegreeSolutionGenerator::NextSolution(
   std::vector<ElementIndex> degree_sorted_elements =
       GetUncoveredElementsSortedByDegree(inv_);
   ComputationUsefulnessStats stats(inv_, false);
-  const SparseRowView& rows = inv_->model()->rows();
+  const FlatRowView& rows = inv_->model()->flat_rows();
   for (const ElementIndex element : degree_sorted_elements) {
     // No need to cover an element that is already covered.
     if (inv_->coverage()[element] != 0) continue;
@@ -464,8 +466,8 @@ bool LazyElementDegreeSolutionGenerator::NextSolution(
   // Create the list of all the indices in the problem.
   std::vector<ElementIndex> degree_sorted_elements =
       GetUncoveredElementsSortedByDegree(inv_);
-  const SparseRowView& rows = inv_->model()->rows();
-  const SparseColumnView& columns = inv_->model()->columns();
+  const FlatRowView& rows = inv_->model()->flat_rows();
+  const FlatColumnView& columns = inv_->model()->flat_columns();
   ComputationUsefulnessStats stats(inv_, false);
   for (const ElementIndex element : degree_sorted_elements) {
     // No need to cover an element that is already covered.
@@ -504,6 +506,269 @@ bool LazyElementDegreeSolutionGenerator::NextSolution(
   return true;
 }
 
+// ParallelGreedySolutionGenerator.
+
+bool ParallelGreedySolutionGenerator::NextSolution() {
+  return NextSolution(inv_->model()->all_subsets(),
+                      inv_->model()->subset_costs());
+}
+
+bool ParallelGreedySolutionGenerator::NextSolution(
+    absl::Span<const SubsetIndex> focus) {
+  return NextSolution(focus, inv_->model()->subset_costs());
+}
+
+bool ParallelGreedySolutionGenerator::NextSolution(
+    absl::Span<const SubsetIndex> focus, const SubsetCostVector& costs) {
+  DCHECK(inv_->CheckConsistency(CL::kCostAndCoverage));
+  inv_->Recompute(CL::kFreeAndUncovered);
+  inv_->ClearTrace();
+  ThreadPool* pool = thread_pool_.get();
+  const SubsetToIntVector& num_free_elements = inv_->num_free_elements();
+  const SubsetBoolVector& is_selected = inv_->is_selected();
+  const double log_base = std::log1p(epsilon_);
+  auto priority = [&](SubsetIndex subset) {
+    return num_free_elements[subset] / costs[subset];
+  };
+  // Priorities only decrease, so the levels of the buckets do too.
+  auto level = [&](SubsetIndex subset) {
+    return static_cast<int>(std::floor(std::log(priority(subset)) / log_base));
+  };
+
+  std::vector<std::pair<int, SubsetIndex>> leveled(focus.size());
+  RunInSlices(pool, num_threads_, focus.size(),
+              [&](int, BaseInt begin, BaseInt end) {
+                for (BaseInt i = begin; i < end; ++i) {
+                  const SubsetIndex subset = focus[i];
+                  const bool is_candidate = !is_selected[subset] &&
+                                            num_free_elements[subset] != 0;
+                  leveled[i] = {is_candidate ? level(subset) : INT_MIN, subset};
+                }
+              });
+  int min_level = INT_MAX;
+  int max_level = INT_MIN;
+  for (const auto& [lvl, subset] : leveled) {
+    if (lvl == INT_MIN) continue;
+    min_level = std::min(min_level, lvl);
+    max_level = std::max(max_level, lvl);
+  }
+  std::vector<std::vector<SubsetIndex>> buckets;
+  if (max_level != INT_MIN) {
+    buckets.resize(max_level - min_level + 1);
+    for (const auto& [lvl, subset] : leveled) {
+      if (lvl != INT_MIN) buckets[lvl - min_level].push_back(subset);
+    }
+  }
+  leveled.clear();
+
+  const FlatColumnView& columns = inv_->model()->flat_columns();
+  const ElementToIntVector& coverage = inv_->coverage();
+  // claimed[element] is the round in which a subset of the batch took it.
+  ElementToIntVector claimed(inv_->model()->num_elements(), -1);
+  std::vector<std::vector<SubsetIndex>> ready(num_threads_);
+  std::vector<std::vector<std::pair<int, SubsetIndex>>> demoted(num_threads_);
+  std::vector<SubsetIndex> current, candidates, batch;
+  int top = static_cast<int>(buckets.size()) - 1;
+  for (BaseInt round = 0; inv_->num_uncovered_elements() > 0; ++round) {
+    while (top >= 0 && buckets[top].empty()) --top;
+    if (top < 0) break;
+    current.clear();
+    current.swap(buckets[top]);
+    const int num_slices =
+        current.size() < kMinParallelSize ? 1 : num_threads_;
+    RunInSlices(pool, num_slices, current.size(),
+                [&](int thread, BaseInt begin, BaseInt end) {
+                  ready[thread].clear();
+                  demoted[thread].clear();
+                  for (BaseInt i = begin; i < end; ++i) {
+                    const SubsetIndex subset = current[i];
+                    if (is_selected[subset] || num_free_elements[subset] == 0) {
+                      continue;
+                    }
+                    const int lvl = level(subset) - min_level;
+                    if (lvl < top) {
+                      demoted[thread].push_back({lvl, subset});
+                    } else {
+                      ready[thread].push_back(subset);
+                    }
+                  }
+                });
+    // The priorities can drop below the lowest level seen so far, in which
+    // case we add buckets at the bottom.
+    int lowest = 0;
+    for (int thread = 0; thread < num_slices; ++thread) {
+      for (const auto& [lvl, subset] : demoted[thread]) {
+        lowest = std::min(lowest, lvl);
+      }
+    }
+    if (lowest < 0) {
+      buckets.insert(buckets.begin(), -lowest, std::vector<SubsetIndex>());
+      top -= lowest;
+      min_level += lowest;
+    }
+    candidates.clear();
+    for (int thread = 0; thread < num_slices; ++thread) {
+      for (const auto& [lvl, subset] : demoted[thread]) {
+        buckets[lvl - lowest].push_back(subset);
+      }
+      candidates.insert(candidates.end(), ready[thread].begin(),
+                        ready[thread].end());
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [&](SubsetIndex a, SubsetIndex b) {
+                const Cost pa = priority(a);
+                const Cost pb = priority(b);
+                return pa > pb || (pa == pb && a < b);
+              });
+    batch.clear();
+    for (const SubsetIndex subset : candidates) {
+      bool interferes = false;
+      for (const ElementIndex element : columns[subset]) {
+        if (coverage[element] == 0 && claimed[element] == round) {
+          interferes = true;
+          break;
+        }
+      }
+      if (interferes) {
+        // Its priority is only known after the batch is selected.
+        buckets[top].push_back(subset);
+        continue;
+      }
+      for (const ElementIndex element : columns[subset]) {
+        if (coverage[element] == 0) claimed[element] = round;
+      }
+      batch.push_back(subset);
+    }
+    inv_->SelectBatch(batch, CL::kFreeAndUncovered, pool, num_threads_);
+    DVLOG(1) << "Round " << round << ": selected " << batch.size()
+             << " subsets, cost = " << inv_->cost()
+             << " num_uncovered_elements = " << inv_->num_uncovered_elements();
+  }
+  inv_->CompressTrace();
+  DCHECK(inv_->CheckConsistency(CL::kFreeAndUncovered));
+  return true;
+}
+
+// ParallelElementDegreeSolutionGenerator.
+
+bool ParallelElementDegreeSolutionGenerator::NextSolution() {
+  const SubsetIndex num_subsets(inv_->model()->num_subsets());
+  const SubsetBoolVector in_focus(num_subsets, true);
+  return NextSolution(in_focus, inv_->model()->subset_costs());
+}
+
+bool ParallelElementDegreeSolutionGenerator::NextSolution(
+    absl::Span<const SubsetIndex> focus) {
+  const SubsetIndex num_subsets(inv_->model()->num_subsets());
+  const SubsetBoolVector in_focus = MakeBoolVector(focus, num_subsets);
+  return NextSolution(in_focus, inv_->model()->subset_costs());
+}
+
+bool ParallelElementDegreeSolutionGenerator::NextSolution(
+    absl::Span<const SubsetIndex> focus, const SubsetCostVector& costs) {
+  const SubsetIndex num_subsets(inv_->model()->num_subsets());
+  const SubsetBoolVector in_focus = MakeBoolVector(focus, num_subsets);
+  return NextSolution(in_focus, costs);
+}
+
+bool ParallelElementDegreeSolutionGenerator::NextSolution(
+    const SubsetBoolVector& in_focus, const SubsetCostVector& costs) {
+  DVLOG(1) << "Entering ParallelElementDegreeSolutionGenerator::NextSolution";
+  DCHECK(inv_->CheckConsistency(CL::kCostAndCoverage));
+  ThreadPool* pool = thread_pool_.get();
+  const std::vector<ElementIndex> degree_sorted_elements =
+      GetUncoveredElementsSortedByDegree(inv_);
+  const FlatRowView& rows = inv_->model()->flat_rows();
+  const FlatColumnView& columns = inv_->model()->flat_columns();
+  const ElementToIntVector& coverage = inv_->coverage();
+  // Same choice as LazyElementDegreeSolutionGenerator, on the coverage as of
+  // the start of the window. Only reads the invariant.
+  auto best_subset_for = [&](ElementIndex element) {
+    SubsetIndex best_subset(-1);
+    Cost best_subset_cost = 0.0;
+    BaseInt best_subset_num_free_elts = 0;
+    for (const SubsetIndex subset : rows[element]) {
+      if (!in_focus[subset]) continue;
+      const Cost filtering_det =
+          Determinant(costs[subset], columns[subset].size(), best_subset_cost,
+                      best_subset_num_free_elts);
+      if (filtering_det > 0) continue;
+      const BaseInt num_free_elements = inv_->ComputeNumFreeElements(subset);
+      const Cost det = Determinant(costs[subset], num_free_elements,
+                                   best_subset_cost, best_subset_num_free_elts);
+      if (det < 0 ||
+          (det == 0 && num_free_elements > best_subset_num_free_elts)) {
+        best_subset = subset;
+        best_subset_cost = costs[subset];
+        best_subset_num_free_elts = num_free_elements;
+      }
+    }
+    return best_subset;
+  };
+
+  const BaseInt window_size = kElementsPerThread * num_threads_;
+  // claimed[element] is the window in which a subset of the batch took it.
+  ElementToIntVector claimed(inv_->model()->num_elements(), -1);
+  std::vector<ElementIndex> window, deferred;
+  std::vector<SubsetIndex> best, batch;
+  size_t next = 0;
+  for (BaseInt round = 0;; ++round) {
+    // Deferred elements come first, as they come first in degree order.
+    window.clear();
+    for (const ElementIndex element : deferred) {
+      if (coverage[element] == 0) window.push_back(element);
+    }
+    deferred.clear();
+    while (window.size() < static_cast<size_t>(window_size) &&
+           next < degree_sorted_elements.size()) {
+      const ElementIndex element = degree_sorted_elements[next++];
+      if (coverage[element] == 0) window.push_back(element);
+    }
+    if (window.empty()) break;
+    best.resize(window.size());
+    RunInSlices(pool, num_threads_, window.size(),
+                [&](int, BaseInt begin, BaseInt end) {
+                  for (BaseInt i = begin; i < end; ++i) {
+                    best[i] = best_subset_for(window[i]);
+                  }
+                });
+    batch.clear();
+    for (size_t i = 0; i < window.size(); ++i) {
+      const ElementIndex element = window[i];
+      // Covered by an earlier choice of this window.
+      if (claimed[element] == round) continue;
+      const SubsetIndex subset = best[i];
+      if (subset == kNotFound) {
+        LOG(WARNING) << "Best subset not found. Algorithmic error or invalid "
+                        "input.";
+        continue;
+      }
+      bool interferes = false;
+      for (const ElementIndex e : columns[subset]) {
+        if (coverage[e] == 0 && claimed[e] == round) {
+          interferes = true;
+          break;
+        }
+      }
+      if (interferes) {
+        deferred.push_back(element);
+        continue;
+      }
+      for (const ElementIndex e : columns[subset]) {
+        if (coverage[e] == 0) claimed[e] = round;
+      }
+      batch.push_back(subset);
+    }
+    inv_->SelectBatch(batch, CL::kCostAndCoverage, pool, num_threads_);
+    DVLOG(1) << "Window " << round << ": selected " << batch.size()
+             << " subsets, deferred " << deferred.size()
+             << " elements, cost = " << inv_->cost();
+  }
+  inv_->CompressTrace();
+  DCHECK(inv_->CheckConsistency(CL::kCostAndCoverage));
+  return true;
+}
+
 // SteepestSearch.
 
 void SteepestSearch::UpdatePriorities(absl::Span<const SubsetIndex>) {}
@@ -635,15 +900,13 @@ bool GuidedTabuSearch::NextSolution(absl::Span<const SubsetIndex> focus,
            << num_iterations;
   const SubsetCostVector& subset_costs = inv_->model()->subset_costs();
   Cost best_cost = inv_->cost();
-  SubsetBoolVector best_choices = inv_->is_selected();
+  // The best solution is restored by undoing the flips made since it was
+  // found, which only touches the columns of the flipped subsets.
+  inv_->CompressTrace();
+  BaseInt best_checkpoint = inv_->Checkpoint();
   Cost augmented_cost =
       std::accumulate(augmented_costs_.begin(), augmented_costs_.end(), 0.0);
-  BaseInt trace_size = inv_->trace().size();
   for (int iteration = 0; iteration < num_iterations; ++iteration) {
-    if (inv_->trace().size() > 2 * trace_size) {
-      inv_->CompressTrace();
-      trace_size = inv_->trace().size();
-    }
     Cost best_delta = kMaxPossibleCost;
     SubsetIndex best_subset = kNotFound;
     for (const SubsetIndex subset : focus) {
@@ -676,7 +939,7 @@ bool GuidedTabuSearch::NextSolution(absl::Span<const SubsetIndex> focus,
       }
     }
     if (best_subset == kNotFound) {  // Local minimum reached.
-      inv_->LoadSolution(best_choices);
+      inv_->Rollback(best_checkpoint, CL::kFreeAndUncovered);
       return true;
     }
     DVLOG(1) << "Best subset, " << best_subset.value() << ", at ,"
@@ -698,10 +961,12 @@ bool GuidedTabuSearch::NextSolution(absl::Span<const SubsetIndex> focus,
                 << ", current cost = ," << inv_->cost() << ", best cost = ,"
                 << best_cost << ", penalized cost = ," << augmented_cost;
       best_cost = inv_->cost();
-      best_choices = inv_->is_selected();
+      // Keeps the trace, hence the rollbacks, short.
+      inv_->CompressTrace();
+      best_checkpoint = inv_->Checkpoint();
     }
   }
-  inv_->LoadSolution(best_choices);
+  inv_->Rollback(best_checkpoint, CL::kFreeAndUncovered);
   inv_->CompressTrace();
   DCHECK(inv_->CheckConsistency(CL::kFreeAndUncovered));
   return true;
@@ -709,7 +974,7 @@ bool GuidedTabuSearch::NextSolution(absl::Span<const SubsetIndex> focus,
 
 // Guided Local Search
 void GuidedLocalSearch::Initialize() {
-  const SparseColumnView& columns = inv_->model()->columns();
+  const FlatColumnView& columns = inv_->model()->flat_columns();
   penalties_.assign(columns.size(), 0);
   penalization_factor_ = alpha_ * inv_->cost() * 1.0 / (columns.size());
   for (const SetCoverDecision& decision : inv_->trace()) {
@@ -742,7 +1007,8 @@ bool GuidedLocalSearch::NextSolution(absl::Span<const SubsetIndex> focus,
                                      int num_iterations) {
   inv_->Recompute(CL::kRedundancy);
   Cost best_cost = inv_->cost();
-  SubsetBoolVector best_choices = inv_->is_selected();
+  inv_->CompressTrace();
+  BaseInt best_checkpoint = inv_->Checkpoint();
 
   for (const SubsetIndex& subset : focus) {
     const float delta = ComputeDelta(subset);
@@ -802,10 +1068,11 @@ bool GuidedLocalSearch::NextSolution(absl::Span<const SubsetIndex> focus,
 
     if (inv_->cost() < best_cost) {
       best_cost = inv_->cost();
-      best_choices = inv_->is_selected();
+      inv_->CompressTrace();
+      best_checkpoint = inv_->Checkpoint();
     }
   }
-  inv_->LoadSolution(best_choices);
+  inv_->Rollback(best_checkpoint, CL::kRedundancy);
 
   // Improve the solution by removing redundant subsets.
   for (const SubsetIndex& subset : focus) {
@@ -872,7 +1139,7 @@ std::vector<SubsetIndex> ClearMostCoveredElements(
 
   const ElementToIntVector& coverage = inv->coverage();
   const BaseInt num_subsets = inv->model()->num_subsets();
-  const SparseRowView& rows = inv->model()->rows();
+  const FlatRowView& rows = inv->model()->flat_rows();
 
   // Collect the sets which have at least one element whose coverage > 1,
   // even if those sets are not removable.
@@ -14,12 +14,16 @@
 #ifndef OR_TOOLS_ALGORITHMS_SET_COVER_HEURISTICS_H_
 #define OR_TOOLS_ALGORITHMS_SET_COVER_HEURISTICS_H_
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
+#include "absl/log/check.h"
 #include "absl/types/span.h"
 #include "ortools/algorithms/adjustable_k_ary_heap.h"
 #include "ortools/algorithms/set_cover_invariant.h"
 #include "ortools/algorithms/set_cover_model.h"
+#include "ortools/base/threadpool.h"
 
 namespace operations_research {
 
@@ -41,7 +45,9 @@ namespace operations_research {
 // subproblems.
 //
 // TODO(user): make the different algorithms concurrent, solving independent
-// subproblems in different threads.
+// subproblems in different threads. ParallelGreedySolutionGenerator and
+// ParallelElementDegreeSolutionGenerator parallelize a single first
+// solution instead.
 //
 
 // An obvious idea is to take all the S_j's (or equivalently to set all the
@@ -203,6 +209,119 @@ class LazyElementDegreeSolutionGenerator {
   SetCoverInvariant* inv_;
 };
 
+// Parallel version of GreedySolutionGenerator, for first solutions on
+// instances with millions of nonzeros.
+// The subsets are kept in buckets of geometrically decreasing priority
+// (number of free elements per unit of cost, buckets (1 + epsilon) apart).
+// Each round takes the top bucket and
+// - recomputes the priorities of its subsets in parallel chunks, moving
+//   down those whose priority dropped below the bucket,
+// - scans the rest by decreasing priority and keeps a batch of subsets
+//   whose free elements are pairwise disjoint, so that each of them covers
+//   exactly the elements it was chosen for; the others wait for the next
+//   round,
+// - selects the batch with SetCoverInvariant::SelectBatch.
+// Every selected subset is within a factor 1 + epsilon of the best ratio at
+// the time, so the solution keeps the (1 + epsilon)(1 + log(n)) guarantee.
+// See Cormode, Karloff and Wirth (2010) above for the bucketing idea.
+
+// The consistency level is maintained up to kFreeAndUncovered.
+class ParallelGreedySolutionGenerator {
+ public:
+  explicit ParallelGreedySolutionGenerator(SetCoverInvariant* inv,
+                                           int num_threads = 1,
+                                           double epsilon = kDefaultEpsilon)
+      : inv_(inv),
+        num_threads_(num_threads),
+        epsilon_(epsilon),
+        thread_pool_(new ThreadPool(num_threads)) {
+    DCHECK_GT(epsilon, 0.0);
+    thread_pool_->StartWorkers();
+  }
+
+  // Returns true if a solution was found.
+  bool NextSolution();
+
+  // Computes the next partial solution considering only the subsets whose
+  // indices are in focus.
+  bool NextSolution(absl::Span<const SubsetIndex> focus);
+
+  // Same with a different set of costs.
+  bool NextSolution(absl::Span<const SubsetIndex> focus,
+                    const SubsetCostVector& costs);
+
+ private:
+  static constexpr double kDefaultEpsilon = 0.05;
+
+  // Buckets with fewer subsets are rescanned in the calling thread.
+  static constexpr size_t kMinParallelSize = 4096;
+
+  // The data structure that will maintain the invariant for the model.
+  SetCoverInvariant* inv_;
+
+  // The number of threads to use for parallelization.
+  int num_threads_;
+
+  // The ratio between the priorities of consecutive buckets is 1 + epsilon_.
+  double epsilon_;
+
+  // The thread pool used for parallelization.
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+// Parallel version of LazyElementDegreeSolutionGenerator.
+// The uncovered elements are taken by increasing degree, a window of
+// kElementsPerThread per thread at a time. The best subset for each element
+// of the window is computed in parallel chunks, with the number of free
+// elements computed on demand from the coverage. The choices are then
+// accepted in degree order, skipping elements covered by an earlier choice
+// of the window, as long as the chosen subset's free elements do not overlap
+// those of an earlier choice; otherwise the element is deferred to the next
+// window. An accepted subset thus has the same number of free elements as
+// when it was chosen, while the other candidates can only have lost some, so
+// it is the choice LazyElementDegreeSolutionGenerator would have made.
+
+// Because the number of uncovered elements is computed on-demand, the
+// consistency level only needs to be set to kCostAndCoverage.
+class ParallelElementDegreeSolutionGenerator {
+ public:
+  explicit ParallelElementDegreeSolutionGenerator(SetCoverInvariant* inv,
+                                                  int num_threads = 1)
+      : inv_(inv),
+        num_threads_(num_threads),
+        thread_pool_(new ThreadPool(num_threads)) {
+    thread_pool_->StartWorkers();
+  }
+
+  // Returns true if a solution was found.
+  bool NextSolution();
+
+  // Computes the next partial solution considering only the subsets whose
+  // indices are in focus.
+  bool NextSolution(absl::Span<const SubsetIndex> focus);
+
+  // Same with a different set of costs.
+  bool NextSolution(absl::Span<const SubsetIndex> focus,
+                    const SubsetCostVector& costs);
+
+ private:
+  static constexpr BaseInt kElementsPerThread = 256;
+
+  // Same with a different set of costs, and the focus defined as a vector of
+  // Booleans. This is the actual implementation of NextSolution.
+  bool NextSolution(const SubsetBoolVector& in_focus,
+                    const SubsetCostVector& costs);
+
+  // The data structure that will maintain the invariant for the model.
+  SetCoverInvariant* inv_;
+
+  // The number of threads to use for parallelization.
+  int num_threads_;
+
+  // The thread pool used for parallelization.
+  std::unique_ptr<ThreadPool> thread_pool_;
+};
+
 // Once we have a first solution to the problem, there may be (most often,
 // there are) elements in E that are covered several times. To decrease the
 // total cost, SteepestSearch tries to eliminate some redundant S_j's from
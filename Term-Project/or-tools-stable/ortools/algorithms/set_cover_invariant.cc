@@ -14,26 +14,50 @@
 #include "ortools/algorithms/set_cover_invariant.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <tuple>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/types/span.h"
 #include "ortools/algorithms/set_cover_model.h"
 #include "ortools/base/logging.h"
 #include "ortools/base/mathutil.h"
+#include "ortools/base/threadpool.h"
 
 namespace operations_research {
 
 using CL = SetCoverInvariant::ConsistencyLevel;
 
+void RunInSlices(ThreadPool* pool, int num_threads, BaseInt size,
+                 absl::FunctionRef<void(int, BaseInt, BaseInt)> fn) {
+  if (pool == nullptr || num_threads <= 1) {
+    fn(0, 0, size);
+    return;
+  }
+  const BaseInt block_size = 1 + std::max<BaseInt>(size - 1, 0) / num_threads;
+  absl::BlockingCounter num_slices_running(num_threads);
+  for (int slice = 0; slice < num_threads; ++slice) {
+    const BaseInt begin =
+        std::min<int64_t>(size, static_cast<int64_t>(slice) * block_size);
+    const BaseInt end = std::min<int64_t>(size, int64_t{begin} + block_size);
+    pool->Schedule([fn, &num_slices_running, slice, begin, end]() {
+      fn(slice, begin, end);
+      num_slices_running.DecrementCount();
+    });
+  }
+  num_slices_running.Wait();
+}
+
 // Note: in many of the member functions, variables have "crypterse" names
 // to avoid confusing them with member data. For example mrgnl_impcts is used
 // to avoid confusion with num_free_elements_.
 void SetCoverInvariant::Initialize() {
   DCHECK(model_->ComputeFeasibility());
-  model_->CreateSparseRowView();
+  model_->CreateFlatViews();
   Clear();
 }
 
@@ -48,7 +72,7 @@ void SetCoverInvariant::Clear() {
   num_non_overcovered_elements_.assign(num_subsets, 0);
   is_redundant_.assign(num_subsets, false);
 
-  const SparseColumnView& columns = model_->columns();
+  const FlatColumnView& columns = model_->flat_columns();
   for (const SubsetIndex subset : model_->SubsetRange()) {
     num_free_elements_[subset] = columns[subset].size();
     num_non_overcovered_elements_[subset] = columns[subset].size();
@@ -143,7 +167,7 @@ void SetCoverInvariant::Recompute(ConsistencyLevel target_consistency) {
 // faster to update the invariant. const BaseInt num_subsets =
 // model_->num_subsets(); is_redundant_.assign(num_subsets, false);
 // num_non_overcovered_elements_.assign(num_subsets, 0);
-// const SparseColumnView& columns = model_->columns();
+// const FlatColumnView& columns = model_->flat_columns();
 // for (const ElementIndex element : model_->ElementRange()) {
 //   if (coverage_[element] >= 1) {
 //     --num_uncovered_elements_;
@@ -165,7 +189,7 @@ std::tuple<Cost, ElementToIntVector> SetCoverInvariant::ComputeCostAndCoverage(
     const SubsetBoolVector& choices) const {
   Cost cst = 0.0;
   ElementToIntVector cvrg(model_->num_elements(), 0);
-  const SparseColumnView& columns = model_->columns();
+  const FlatColumnView& columns = model_->flat_columns();
   // Initialize coverage, update cost, and compute the coverage for
   // all the elements covered by the selected subsets.
   const SubsetCostVector& subset_costs = model_->subset_costs();
@@ -187,7 +211,7 @@ ElementToIntVector SetCoverInvariant::ComputeCoverageInFocus(
   ElementToIntVector coverage(coverage_.size());
   for (const SubsetIndex subset : focus) {
     if (is_selected_[subset]) {
-      for (const ElementIndex element : model_->columns()[subset]) {
+      for (const ElementIndex element : model_->flat_columns()[subset]) {
         ++coverage[element];
       }
     }
@@ -203,13 +227,13 @@ SetCoverInvariant::ComputeNumUncoveredAndFreeElements(
   const BaseInt num_subsets(model_->num_subsets());
   SubsetToIntVector num_free_elts(num_subsets, 0);
 
-  const SparseColumnView& columns = model_->columns();
+  const FlatColumnView& columns = model_->flat_columns();
   // Initialize number of free elements and number of elements covered 0 or 1.
   for (const SubsetIndex subset : model_->SubsetRange()) {
     num_free_elts[subset] = columns[subset].size();
   }
 
-  const SparseRowView& rows = model_->rows();
+  const FlatRowView& rows = model_->flat_rows();
   for (const ElementIndex element : model_->ElementRange()) {
     if (cvrg[element] >= 1) {
       --num_uncvrd_elts;
@@ -227,13 +251,13 @@ SetCoverInvariant::ComputeRedundancyInfo(const ElementToIntVector& cvrg) const {
   SubsetToIntVector num_cvrg_le_1_elts(num_subsets, 0);
   SubsetBoolVector is_rdndnt(num_subsets, false);
 
-  const SparseColumnView& columns = model_->columns();
+  const FlatColumnView& columns = model_->flat_columns();
   // Initialize number of free elements and number of elements covered 0 or 1.
   for (const SubsetIndex subset : model_->SubsetRange()) {
     num_cvrg_le_1_elts[subset] = columns[subset].size();
   }
 
-  const SparseRowView& rows = model_->rows();
+  const FlatRowView& rows = model_->flat_rows();
   for (const ElementIndex element : model_->ElementRange()) {
     if (cvrg[element] >= 2) {
       for (const SubsetIndex subset : rows[element]) {
@@ -275,13 +299,13 @@ bool SetCoverInvariant::ComputeIsRedundant(SubsetIndex subset) const {
     return is_redundant_[subset];
   }
   if (is_selected_[subset]) {
-    for (const ElementIndex element : model_->columns()[subset]) {
+    for (const ElementIndex element : model_->flat_columns()[subset]) {
       if (coverage_[element] <= 1) {  // If deselected, it will be <= 0...
         return false;
       }
     }
   } else {
-    for (const ElementIndex element : model_->columns()[subset]) {
+    for (const ElementIndex element : model_->flat_columns()[subset]) {
       if (coverage_[element] == 0) {  // Cannot be removed from the problem.
         return false;
       }
@@ -291,8 +315,8 @@ bool SetCoverInvariant::ComputeIsRedundant(SubsetIndex subset) const {
 }
 
 BaseInt SetCoverInvariant::ComputeNumFreeElements(SubsetIndex subset) const {
-  BaseInt num_free_elements = model_->columns()[subset].size();
-  for (const ElementIndex element : model_->columns()[subset]) {
+  BaseInt num_free_elements = model_->flat_columns()[subset].size();
+  for (const ElementIndex element : model_->flat_columns()[subset]) {
     if (coverage_[element] != 0) {
       --num_free_elements;
     }
@@ -309,8 +333,48 @@ void SetCoverInvariant::Flip(SubsetIndex subset,
   }
 }
 
+void SetCoverInvariant::Rollback(BaseInt checkpoint,
+                                 ConsistencyLevel consistency) {
+  DCHECK_GE(checkpoint, 0);
+  DCHECK_LE(checkpoint, static_cast<BaseInt>(trace_.size()));
+  while (static_cast<BaseInt>(trace_.size()) > checkpoint) {
+    const SetCoverDecision decision = trace_.back();
+    trace_.pop_back();
+    if (decision.decision()) {
+      DeselectNoTrace(decision.subset(), consistency);
+    } else {
+      SelectNoTrace(decision.subset(), consistency);
+    }
+  }
+}
+
+SetCoverInvariant::FlipDelta SetCoverInvariant::ComputeFlipDelta(
+    SubsetIndex subset) const {
+  DCHECK(consistency_level_ >= CL::kCostAndCoverage);
+  const Cost subset_cost = model_->subset_costs()[subset];
+  const FlatColumnView::List column = model_->flat_columns()[subset];
+  if (is_selected_[subset]) {
+    // The elements covered only by subset would become uncovered.
+    BaseInt num_newly_uncovered = 0;
+    for (const ElementIndex element : column) {
+      num_newly_uncovered += coverage_[element] == 1;
+    }
+    return {-subset_cost, num_newly_uncovered};
+  }
+  if (consistency_level_ >= CL::kFreeAndUncovered) {
+    return {subset_cost, -num_free_elements_[subset]};
+  }
+  return {subset_cost, -ComputeNumFreeElements(subset)};
+}
+
 void SetCoverInvariant::Select(SubsetIndex subset,
                                ConsistencyLevel target_consistency) {
+  trace_.push_back(SetCoverDecision(subset, true));
+  SelectNoTrace(subset, target_consistency);
+}
+
+void SetCoverInvariant::SelectNoTrace(SubsetIndex subset,
+                                      ConsistencyLevel target_consistency) {
   const bool update_redundancy_info = target_consistency >= CL::kRedundancy;
   if (update_redundancy_info) {
     ClearRemovabilityInformation();
@@ -319,12 +383,11 @@ void SetCoverInvariant::Select(SubsetIndex subset,
   DVLOG(1) << "Selecting subset " << subset;
   DCHECK(!is_selected_[subset]);
   DCHECK(CheckConsistency(target_consistency));
-  trace_.push_back(SetCoverDecision(subset, true));
   is_selected_[subset] = true;
   const SubsetCostVector& subset_costs = model_->subset_costs();
   cost_ += subset_costs[subset];
-  const SparseColumnView& columns = model_->columns();
-  const SparseRowView& rows = model_->rows();
+  const FlatColumnView& columns = model_->flat_columns();
+  const FlatRowView& rows = model_->flat_rows();
   // Fast path for kCostAndCoverage.
   if (target_consistency == CL::kCostAndCoverage) {
     for (const ElementIndex element : columns[subset]) {
@@ -370,8 +433,91 @@ void SetCoverInvariant::Select(SubsetIndex subset,
   DCHECK(CheckConsistency(target_consistency));
 }
 
+void SetCoverInvariant::SelectBatch(absl::Span<const SubsetIndex> subsets,
+                                    ConsistencyLevel target_consistency,
+                                    ThreadPool* pool, int num_threads) {
+  CHECK(target_consistency == CL::kCostAndCoverage ||
+        target_consistency == CL::kFreeAndUncovered);
+  consistency_level_ = std::min(consistency_level_, target_consistency);
+  DCHECK(CheckConsistency(target_consistency));
+  const SubsetCostVector& subset_costs = model_->subset_costs();
+  for (const SubsetIndex subset : subsets) {
+    DCHECK(!is_selected_[subset]);
+    trace_.push_back(SetCoverDecision(subset, true));
+    is_selected_[subset] = true;
+    cost_ += subset_costs[subset];
+  }
+  // Waking up the threads costs more than updating a small batch.
+  constexpr int64_t kMinParallelBatchSize = 1 << 14;
+  int64_t batch_size = 0;
+  for (const SubsetIndex subset : subsets) {
+    batch_size += model_->flat_columns()[subset].size();
+  }
+  if (pool == nullptr || batch_size < kMinParallelBatchSize) {
+    num_threads = 1;
+  }
+  const bool update_free_elements =
+      target_consistency == CL::kFreeAndUncovered;
+  const FlatColumnView& columns = model_->flat_columns();
+  const FlatRowView& rows = model_->flat_rows();
+  const BaseInt subsets_per_range =
+      1 + std::max<BaseInt>(model_->num_subsets() - 1, 0) / num_threads;
+  batch_deltas_.resize(num_threads * num_threads);
+  std::vector<BaseInt> num_newly_covered(num_threads, 0);
+  // Each thread owns the elements in [begin, end), and finds them in each
+  // column by binary search, as the columns are sorted.
+  RunInSlices(
+      pool, num_threads, model_->num_elements(),
+      [&](int thread, BaseInt begin, BaseInt end) {
+        std::vector<SubsetIndex>* deltas = &batch_deltas_[thread * num_threads];
+        for (int range = 0; range < num_threads; ++range) {
+          deltas[range].clear();
+        }
+        BaseInt num_covered = 0;
+        for (const SubsetIndex subset : subsets) {
+          const FlatColumnView::List column = columns[subset];
+          for (const ElementIndex* it = std::lower_bound(
+                   column.begin(), column.end(), ElementIndex(begin));
+               it != column.end() && it->value() < end; ++it) {
+            const ElementIndex element = *it;
+            if (update_free_elements && coverage_[element] == 0) {
+              ++num_covered;
+              for (const SubsetIndex impacted_subset : rows[element]) {
+                deltas[impacted_subset.value() / subsets_per_range].push_back(
+                    impacted_subset);
+              }
+            }
+            ++coverage_[element];
+          }
+        }
+        num_newly_covered[thread] = num_covered;
+      });
+  if (!update_free_elements) return;
+  RunInSlices(pool, num_threads, num_threads,
+              [&](int, BaseInt begin, BaseInt end) {
+                for (BaseInt range = begin; range < end; ++range) {
+                  for (int thread = 0; thread < num_threads; ++thread) {
+                    for (const SubsetIndex impacted_subset :
+                         batch_deltas_[thread * num_threads + range]) {
+                      --num_free_elements_[impacted_subset];
+                    }
+                  }
+                }
+              });
+  for (const BaseInt num_covered : num_newly_covered) {
+    num_uncovered_elements_ -= num_covered;
+  }
+  DCHECK(CheckConsistency(target_consistency));
+}
+
 void SetCoverInvariant::Deselect(SubsetIndex subset,
                                  ConsistencyLevel target_consistency) {
+  trace_.push_back(SetCoverDecision(subset, false));
+  DeselectNoTrace(subset, target_consistency);
+}
+
+void SetCoverInvariant::DeselectNoTrace(SubsetIndex subset,
+                                        ConsistencyLevel target_consistency) {
   DCHECK(CheckConsistency(target_consistency));
   const bool update_redundancy_info = target_consistency >= CL::kRedundancy;
   if (update_redundancy_info) {
@@ -379,15 +525,15 @@ void SetCoverInvariant::Deselect(SubsetIndex subset,
   }
   consistency_level_ = std::min(consistency_level_, target_consistency);
   DVLOG(1) << "Deselecting subset " << subset;
-  // If already selected, then num_free_elements == 0.
+  // If already selected, then num_free_elements == 0, when it is maintained.
   DCHECK(is_selected_[subset]);
-  DCHECK_EQ(num_free_elements_[subset], 0);
-  trace_.push_back(SetCoverDecision(subset, false));
+  DCHECK(target_consistency < CL::kFreeAndUncovered ||
+         num_free_elements_[subset] == 0);
   is_selected_[subset] = false;
   const SubsetCostVector& subset_costs = model_->subset_costs();
   cost_ -= subset_costs[subset];
-  const SparseColumnView& columns = model_->columns();
-  const SparseRowView& rows = model_->rows();
+  const FlatColumnView& columns = model_->flat_columns();
+  const FlatRowView& rows = model_->flat_rows();
   // Fast path for kCostAndCoverage.
   if (target_consistency == CL::kCostAndCoverage) {
     for (const ElementIndex element : columns[subset]) {
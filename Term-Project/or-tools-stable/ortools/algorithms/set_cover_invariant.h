@@ -17,13 +17,22 @@
 #include <tuple>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/types/span.h"
 #include "ortools/algorithms/set_cover.pb.h"
 #include "ortools/algorithms/set_cover_model.h"
+#include "ortools/base/threadpool.h"
 
 namespace operations_research {
 
+// Splits [0, size) into num_threads consecutive slices of equal length (the
+// last ones may be shorter or empty), runs fn(slice, begin, end) for each of
+// them on pool, and waits for all of them to finish. Runs fn(0, 0, size) in
+// the calling thread if pool is null or num_threads is 1.
+void RunInSlices(ThreadPool* pool, int num_threads, BaseInt size,
+                 absl::FunctionRef<void(int, BaseInt, BaseInt)> fn);
+
 // A helper class used to store the decisions made during a search.
 class SetCoverDecision {
  public:
@@ -161,6 +170,32 @@ class SetCoverInvariant {
   // This can be used to recover the solution by indices after local search.
   void CompressTrace();
 
+  // Returns a checkpoint of the current solution, to be passed to Rollback.
+  // A checkpoint is the current length of the trace, so it remains valid as
+  // long as the trace is only extended, i.e. until the next call to
+  // ClearTrace, CompressTrace, LoadSolution or Clear, including the calls made
+  // by the heuristics.
+  BaseInt Checkpoint() const { return trace_.size(); }
+
+  // Undoes the decisions taken since checkpoint, the latest first, and
+  // removes them from the trace. The invariant is updated incrementally to
+  // the given consistency level, like with Flip, so this takes time
+  // proportional to the work of the decisions undone, not to the size of the
+  // model like LoadSolution.
+  void Rollback(BaseInt checkpoint, ConsistencyLevel consistency);
+
+  // The changes that flipping a subset would bring to the cost and to the
+  // number of uncovered elements.
+  struct FlipDelta {
+    Cost cost;
+    BaseInt num_uncovered_elements;
+  };
+
+  // Returns the changes that Flip(subset, ...) would bring, without modifying
+  // the invariant. Needs the coverage to be up to date, and uses
+  // num_free_elements_ when it is up to date too.
+  FlipDelta ComputeFlipDelta(SubsetIndex subset) const;
+
   // Loads the solution and recomputes the data in the invariant.
   void LoadSolution(const SubsetBoolVector& solution);
 
@@ -198,6 +233,20 @@ class SetCoverInvariant {
   // and incrementally updating the invariant to the given consistency level.
   void Deselect(SubsetIndex subset, ConsistencyLevel consistency);
 
+  // Includes all the subsets in the solution at once, and updates the
+  // invariant to target_consistency, which must be kCostAndCoverage or
+  // kFreeAndUncovered. The result is the same as calling Select on each of
+  // them in turn.
+  // The elements are split in num_threads ranges, and each thread of pool
+  // updates the coverage of its own range. The resulting decrements of
+  // num_free_elements_ are handed over as per-thread lists, bucketed by
+  // ranges of subsets, and applied by the thread owning each range, so no two
+  // threads ever write the same counter. With a null pool, runs in the
+  // calling thread.
+  void SelectBatch(absl::Span<const SubsetIndex> subsets,
+                   ConsistencyLevel target_consistency, ThreadPool* pool,
+                   int num_threads);
+
   // Returns the current solution as a proto.
   SetCoverSolutionResponse ExportSolutionAsProto() const;
 
@@ -226,6 +275,10 @@ class SetCoverInvariant {
              SubsetBoolVector>   // Redundancy for each of the subsets.
   ComputeRedundancyInfo(const ElementToIntVector& cvrg) const;
 
+  // Select and Deselect, without recording the decision in the trace.
+  void SelectNoTrace(SubsetIndex subset, ConsistencyLevel consistency);
+  void DeselectNoTrace(SubsetIndex subset, ConsistencyLevel consistency);
+
   // Returns true if the current consistency level consistency_ is lower than
   // cheched_consistency and the desired consistency is higher than
   // cheched_consistency.
@@ -279,6 +332,10 @@ class SetCoverInvariant {
   // Takes at most |S| BaseInts. (More likely a few percent of that).
   std::vector<SubsetIndex> newly_non_removable_subsets_;
 
+  // Scratch space for SelectBatch: entry (t * num_threads + r) lists the
+  // subsets in range r whose number of free elements thread t decrements.
+  std::vector<std::vector<SubsetIndex>> batch_deltas_;
+
   // Denotes the consistency level of the invariant.
   // Some algorithms may need to recompute the invariant to a higher consistency
   // level.
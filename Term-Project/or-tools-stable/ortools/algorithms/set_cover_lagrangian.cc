@@ -14,20 +14,32 @@
 #include "ortools/algorithms/set_cover_lagrangian.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "ortools/algorithms/adjustable_k_ary_heap.h"
+#include "ortools/algorithms/set_cover_heuristics.h"
 #include "ortools/algorithms/set_cover_invariant.h"
 #include "ortools/algorithms/set_cover_model.h"
+#include "ortools/base/logging.h"
 #include "ortools/base/threadpool.h"
 
 namespace operations_research {
 
+using CL = SetCoverInvariant::ConsistencyLevel;
+
 // Notes from a discussion with Luca Accorsi (accorsi@) and Francesco Cavaliere
 // regarding [1]:
 // - the 3-phase algorithm in the paper actually uses pricing (which would
@@ -37,6 +49,85 @@ namespace operations_research {
 //   (under "queue" in the paper).
 // - the median algorithm is already in the STL (nth_element).
 
+namespace {
+// Returns num_shards + 1 bounds splitting the lists of view in ranges with
+// about the same number of entries, each list counting as one more entry.
+template <typename Index, typename View>
+std::vector<Index> ComputeShardBounds(const View& view, int num_shards) {
+  const int64_t total_weight = view.num_entries() + view.size();
+  std::vector<Index> bounds(num_shards + 1, Index(view.size()));
+  bounds[0] = Index(0);
+  for (int shard = 1; shard < num_shards; ++shard) {
+    const int64_t target = total_weight * shard / num_shards;
+    BaseInt low = bounds[shard - 1].value();
+    BaseInt high = view.size();
+    while (low < high) {
+      const BaseInt middle = low + (high - low) / 2;
+      if (view.num_entries_before(Index(middle)) + middle < target) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    bounds[shard] = Index(low);
+  }
+  return bounds;
+}
+
+// A barrier that the same num_threads threads can pass again and again.
+// absl::Barrier can only be used once.
+class CyclicBarrier {
+ public:
+  explicit CyclicBarrier(int num_threads) : num_threads_(num_threads) {}
+
+  // Blocks until num_threads threads have called Wait.
+  void Wait() {
+    absl::MutexLock lock(&mutex_);
+    const int64_t generation = generation_;
+    if (++num_waiting_ == num_threads_) {
+      num_waiting_ = 0;
+      ++generation_;
+      released_.SignalAll();
+      return;
+    }
+    while (generation_ == generation) {
+      released_.Wait(&mutex_);
+    }
+  }
+
+ private:
+  const int num_threads_;
+  absl::Mutex mutex_;
+  absl::CondVar released_;
+  int num_waiting_ ABSL_GUARDED_BY(mutex_) = 0;
+  int64_t generation_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+}  // namespace
+
+void SetCoverLagrangian::ComputeShards() {
+  subset_shards_ =
+      ComputeShardBounds<SubsetIndex>(model_.flat_columns(), num_threads_);
+  element_shards_ =
+      ComputeShardBounds<ElementIndex>(model_.flat_rows(), num_threads_);
+}
+
+void SetCoverLagrangian::RunWorkers(
+    absl::FunctionRef<void(int)> worker) const {
+  if (num_threads_ == 1) {
+    worker(0);
+    return;
+  }
+  absl::BlockingCounter num_workers_running(num_threads_ - 1);
+  for (int shard = 1; shard < num_threads_; ++shard) {
+    thread_pool_->Schedule([&num_workers_running, worker, shard]() {
+      worker(shard);
+      num_workers_running.DecrementCount();
+    });
+  }
+  worker(0);
+  num_workers_running.Wait();
+}
+
 // Denoted as u in [1], it is a dual vector: a column vector of nonnegative
 // (zero is included) multipliers for the different constraints.
 // A deterministic way to compute a feasible (non-optimal) u:
@@ -48,23 +139,28 @@ ElementCostVector SetCoverLagrangian::InitializeLagrangeMultipliers() const {
   ElementCostVector multipliers(model_.num_elements(),
                                 std::numeric_limits<Cost>::infinity());
   SubsetCostVector marginal_costs(model_.num_subsets());
-  // TODO(user): Parallelize this.
-  for (const SubsetIndex subset : model_.SubsetRange()) {
-    marginal_costs[subset] =
-        model_.subset_costs()[subset] / model_.columns()[subset].size();
-  }
-  // TODO(user): Parallelize this.
-  for (const ElementIndex element : model_.ElementRange()) {
-    // Minimum marginal cost to cover this element.
-    Cost min_marginal_cost = std::numeric_limits<Cost>::infinity();
-    const SparseRowView& rows = model_.rows();
-    // TODO(user): use std::min_element on rows[element] with a custom
-    // comparator that gets marginal_costs[subset]. Check performance.
-    for (const SubsetIndex subset : rows[element]) {
-      min_marginal_cost = std::min(min_marginal_cost, marginal_costs[subset]);
+  RunWorkers([this, &marginal_costs](int shard) {
+    for (SubsetIndex subset = subset_shards_[shard];
+         subset < subset_shards_[shard + 1]; ++subset) {
+      marginal_costs[subset] = model_.subset_costs()[subset] /
+                               model_.flat_columns()[subset].size();
     }
-    multipliers[element] = min_marginal_cost;
-  }
+  });
+  RunWorkers([this, &marginal_costs, &multipliers](int shard) {
+    const FlatRowView& rows = model_.flat_rows();
+    for (ElementIndex element = element_shards_[shard];
+         element < element_shards_[shard + 1]; ++element) {
+      // Minimum marginal cost to cover this element.
+      Cost min_marginal_cost = std::numeric_limits<Cost>::infinity();
+      // TODO(user): use std::min_element on rows[element] with a custom
+      // comparator that gets marginal_costs[subset]. Check performance.
+      for (const SubsetIndex subset : rows[element]) {
+        min_marginal_cost =
+            std::min(min_marginal_cost, marginal_costs[subset]);
+      }
+      multipliers[element] = min_marginal_cost;
+    }
+  });
   return multipliers;
 }
 
@@ -73,10 +169,12 @@ namespace {
 // Profiling has shown that this is where most of the time is spent.
 // TODO(user): make this visible to other algorithms.
 // TODO(user): Investigate.
-Cost ScalarProduct(const SparseColumn& column, const ElementCostVector& dual) {
+// Column is a list of a FlatColumnView or a CompressedColumnView.
+template <typename Column>
+Cost ScalarProduct(const Column& column, const ElementCostVector& dual) {
   Cost result = 0.0;
-  for (const ColumnEntryIndex pos : column.index_range()) {
-    result += dual[column[pos]];
+  for (const ElementIndex element : column) {
+    result += dual[element];
   }
   return result;
 }
@@ -87,10 +185,11 @@ Cost ScalarProduct(const SparseColumn& column, const ElementCostVector& dual) {
 // The reduced costs are computed using the multipliers vector.
 // The columns of the subsets are given by the columns view.
 // The result is stored in reduced_costs.
+template <typename ColumnView>
 void FillReducedCostsSlice(SubsetIndex slice_start, SubsetIndex slice_end,
                            const SubsetCostVector& costs,
                            const ElementCostVector& multipliers,
-                           const SparseColumnView& columns,
+                           const ColumnView& columns,
                            SubsetCostVector* reduced_costs) {
   for (SubsetIndex subset = slice_start; subset < slice_end; ++subset) {
     (*reduced_costs)[subset] =
@@ -98,34 +197,31 @@ void FillReducedCostsSlice(SubsetIndex slice_start, SubsetIndex slice_end,
   }
 }
 
-BaseInt BlockSize(BaseInt size, int num_threads) {
-  return 1 + (size - 1) / num_threads;
+// Same as above, using the compressed columns of model if it has them. The
+// scan is bound by memory bandwidth, so they are faster.
+void FillReducedCostsSlice(SubsetIndex slice_start, SubsetIndex slice_end,
+                           const SubsetCostVector& costs,
+                           const ElementCostVector& multipliers,
+                           const SetCoverModel& model,
+                           SubsetCostVector* reduced_costs) {
+  if (model.compressed_column_view_is_valid()) {
+    FillReducedCostsSlice(slice_start, slice_end, costs, multipliers,
+                          model.compressed_columns(), reduced_costs);
+  } else {
+    FillReducedCostsSlice(slice_start, slice_end, costs, multipliers,
+                          model.flat_columns(), reduced_costs);
+  }
 }
 }  // namespace
 
 // Computes the reduced costs for all subsets in parallel using ThreadPool.
 SubsetCostVector SetCoverLagrangian::ParallelComputeReducedCosts(
     const SubsetCostVector& costs, const ElementCostVector& multipliers) const {
-  const SubsetIndex num_subsets(model_.num_subsets());
-  const SparseColumnView& columns = model_.columns();
-  SubsetCostVector reduced_costs(num_subsets);
-  // TODO(user): compute a close-to-optimal k-subset partitioning of the columns
-  // based on their sizes. [***]
-  const SubsetIndex block_size(BlockSize(num_subsets.value(), num_threads_));
-  absl::BlockingCounter num_threads_running(num_threads_);
-  SubsetIndex slice_start(0);
-  for (int thread_index = 0; thread_index < num_threads_; ++thread_index) {
-    const SubsetIndex slice_end =
-        std::min(slice_start + block_size, num_subsets);
-    thread_pool_->Schedule([&num_threads_running, slice_start, slice_end,
-                            &costs, &multipliers, &columns, &reduced_costs]() {
-      FillReducedCostsSlice(slice_start, slice_end, costs, multipliers, columns,
-                            &reduced_costs);
-      num_threads_running.DecrementCount();
-    });
-    slice_start = slice_end;
-  }
-  num_threads_running.Wait();
+  SubsetCostVector reduced_costs(model_.num_subsets());
+  RunWorkers([this, &costs, &multipliers, &reduced_costs](int shard) {
+    FillReducedCostsSlice(subset_shards_[shard], subset_shards_[shard + 1],
+                          costs, multipliers, model_, &reduced_costs);
+  });
   return reduced_costs;
 }
 
@@ -136,10 +232,9 @@ SubsetCostVector SetCoverLagrangian::ParallelComputeReducedCosts(
 //         c_j(u) = c_j - sum_{i \in I_j} a_{ij}.u_i
 SubsetCostVector SetCoverLagrangian::ComputeReducedCosts(
     const SubsetCostVector& costs, const ElementCostVector& multipliers) const {
-  const SparseColumnView& columns = model_.columns();
   SubsetCostVector reduced_costs(costs.size());
   FillReducedCostsSlice(SubsetIndex(0), SubsetIndex(reduced_costs.size()),
-                        costs, multipliers, columns, &reduced_costs);
+                        costs, multipliers, model_, &reduced_costs);
   return reduced_costs;
 }
 
@@ -149,7 +244,7 @@ namespace {
 // slice_end. This is a helper function for ParallelComputeSubgradient(). The
 // subgradient is computed using the reduced costs vector.
 void FillSubgradientSlice(SubsetIndex slice_start, SubsetIndex slice_end,
-                          const SparseColumnView& columns,
+                          const FlatColumnView& columns,
                           const SubsetCostVector& reduced_costs,
                           ElementCostVector* subgradient) {
   for (SubsetIndex subset(slice_start); subset < slice_end; ++subset) {
@@ -160,6 +255,46 @@ void FillSubgradientSlice(SubsetIndex slice_start, SubsetIndex slice_end,
     }
   }
 }
+
+// Appends to negative_subsets the subsets in [slice_start, slice_end) whose
+// reduced cost is negative, i.e. the part of the Lagrangian solution in the
+// slice. Returns the sum of their reduced costs.
+Cost CollectNegativeSubsets(SubsetIndex slice_start, SubsetIndex slice_end,
+                            const SubsetCostVector& reduced_costs,
+                            std::vector<SubsetIndex>* negative_subsets) {
+  Cost sum = 0.0;
+  for (SubsetIndex subset(slice_start); subset < slice_end; ++subset) {
+    if (reduced_costs[subset] < 0.0) {
+      sum += reduced_costs[subset];
+      negative_subsets->push_back(subset);
+    }
+  }
+  return sum;
+}
+
+// Computes the subgradient of the elements in [slice_start, slice_end) from
+// the Lagrangian solution, given as lists of subsets. The columns are sorted,
+// so each of them is only scanned over the range of the slice. Hence several
+// threads can fill disjoint slices without any other synchronization.
+void FillSubgradientSliceByElement(
+    ElementIndex slice_start, ElementIndex slice_end,
+    const FlatColumnView& columns,
+    const std::vector<std::vector<SubsetIndex>>& negative_subsets,
+    ElementCostVector* subgradient) {
+  for (ElementIndex element(slice_start); element < slice_end; ++element) {
+    (*subgradient)[element] = 1.0;
+  }
+  for (const std::vector<SubsetIndex>& subsets : negative_subsets) {
+    for (const SubsetIndex subset : subsets) {
+      const auto column = columns[subset];
+      for (const ElementIndex* it =
+               std::lower_bound(column.begin(), column.end(), slice_start);
+           it != column.end() && *it < slice_end; ++it) {
+        (*subgradient)[*it] -= 1.0;
+      }
+    }
+  }
+}
 }  // namespace
 
 // Vector of primal slack variable. Denoted as s_i(u) in [1], equation (6).
@@ -172,42 +307,26 @@ ElementCostVector SetCoverLagrangian::ComputeSubgradient(
   // NOTE(user): Should the initialization be done with coverage[element]?
   ElementCostVector subgradient(model_.num_elements(), 1.0);
   FillSubgradientSlice(SubsetIndex(0), SubsetIndex(reduced_costs.size()),
-                       model_.columns(), reduced_costs, &subgradient);
+                       model_.flat_columns(), reduced_costs, &subgradient);
   return subgradient;
 }
 
 ElementCostVector SetCoverLagrangian::ParallelComputeSubgradient(
     const SubsetCostVector& reduced_costs) const {
-  const SubsetIndex num_subsets(model_.num_subsets());
-  const SparseColumnView& columns = model_.columns();
-  ElementCostVector subgradient(model_.num_elements(), 1.0);
-  // The subgradient has one component per element, each thread processes
-  // several subsets. Hence, have one vector per thread to avoid data races.
-  // TODO(user): it may be better to split the elements among the threads,
-  // although this might be less well-balanced.
-  std::vector<ElementCostVector> subgradients(
-      num_threads_, ElementCostVector(model_.num_elements()));
-  absl::BlockingCounter num_threads_running(num_threads_);
-  const SubsetIndex block_size(BlockSize(num_subsets.value(), num_threads_));
-  SubsetIndex slice_start(0);
-  for (int thread_index = 0; thread_index < num_threads_; ++thread_index) {
-    const SubsetIndex slice_end =
-        std::min(slice_start + block_size, num_subsets);
-    thread_pool_->Schedule([&num_threads_running, slice_start, slice_end,
-                            &reduced_costs, &columns, &subgradients,
-                            thread_index]() {
-      FillSubgradientSlice(slice_start, slice_end, columns, reduced_costs,
-                           &subgradients[thread_index]);
-      num_threads_running.DecrementCount();
-    });
-    slice_start = slice_end;
-  }
-  num_threads_running.Wait();
-  for (int thread_index = 0; thread_index < num_threads_; ++thread_index) {
-    for (const ElementIndex element : model_.ElementRange()) {
-      subgradient[element] += subgradients[thread_index][element];
-    }
-  }
+  // Each thread collects the Lagrangian solution over its subsets, then
+  // computes the subgradient over its elements. This avoids a vector of
+  // partial subgradients per thread.
+  std::vector<std::vector<SubsetIndex>> negative_subsets(num_threads_);
+  RunWorkers([this, &reduced_costs, &negative_subsets](int shard) {
+    CollectNegativeSubsets(subset_shards_[shard], subset_shards_[shard + 1],
+                           reduced_costs, &negative_subsets[shard]);
+  });
+  ElementCostVector subgradient(model_.num_elements());
+  RunWorkers([this, &negative_subsets, &subgradient](int shard) {
+    FillSubgradientSliceByElement(
+        element_shards_[shard], element_shards_[shard + 1],
+        model_.flat_columns(), negative_subsets, &subgradient);
+  });
   return subgradient;
 }
 
@@ -262,25 +381,10 @@ Cost SetCoverLagrangian::ParallelComputeLagrangianValue(
     lagrangian_value += u;
   }
   std::vector<Cost> lagrangian_values(num_threads_, 0.0);
-  absl::BlockingCounter num_threads_running(num_threads_);
-  const SubsetIndex block_size(BlockSize(model_.num_subsets(), num_threads_));
-  const SubsetIndex num_subsets(model_.num_subsets());
-  SubsetIndex slice_start(0);
-  for (int thread_index = 0; thread_index < num_threads_; ++thread_index) {
-    const SubsetIndex slice_end =
-        std::min(slice_start + block_size, num_subsets);
-    thread_pool_->Schedule([&num_threads_running, slice_start, block_size,
-                            num_subsets, thread_index, &reduced_costs,
-                            &lagrangian_values]() {
-      const SubsetIndex slice_end =
-          std::min(slice_start + block_size, num_subsets);
-      FillLagrangianValueSlice(slice_start, slice_end, reduced_costs,
-                               &lagrangian_values[thread_index]);
-      num_threads_running.DecrementCount();
-    });
-    slice_start = slice_end;
-  }
-  num_threads_running.Wait();
+  RunWorkers([this, &reduced_costs, &lagrangian_values](int shard) {
+    FillLagrangianValueSlice(subset_shards_[shard], subset_shards_[shard + 1],
+                             reduced_costs, &lagrangian_values[shard]);
+  });
   for (const Cost l : lagrangian_values) {
     lagrangian_value += l;
   }
@@ -374,7 +478,7 @@ SubsetCostVector SetCoverLagrangian::ComputeDelta(
   SubsetCostVector delta(model_.num_subsets());
   const ElementToIntVector& coverage = inv_->coverage();
   // This is definition (9) in [1].
-  const SparseColumnView& columns = model_.columns();
+  const FlatColumnView& columns = model_.flat_columns();
   // TODO(user): Parallelize this.
   for (const SubsetIndex subset : model_.SubsetRange()) {
     delta[subset] = std::max(reduced_costs[subset], 0.0);
@@ -489,31 +593,296 @@ class TopKHeap {
 std::tuple<Cost, SubsetCostVector, ElementCostVector>
 SetCoverLagrangian::ComputeLowerBound(const SubsetCostVector& costs,
                                       Cost upper_bound) {
-  Cost lower_bound = 0.0;
   ElementCostVector multipliers = InitializeLagrangeMultipliers();
-  double step_size = 0.1;               // [***] arbitrary, from [1].
-  StepSizer step_sizer(20, step_size);  // [***] arbitrary, from [1].
-  Stopper stopper(100);                 // [***] arbitrary, from [1].
-  SubsetCostVector reduced_costs(costs);
   // For the time being, 4 threads seems to be the fastest.
   // Running linux perf of the process shows that up to 60% of the cycles are
   // lost as idle cycles in the CPU backend, probably because the algorithm is
   // memory bound.
-  for (int iter = 0; iter < 1000; ++iter) {
-    reduced_costs = ParallelComputeReducedCosts(costs, multipliers);
+  // The step size should be updated by a StepSizer. For the time being, we
+  // keep the step size, because the implementation of the rest is not adequate
+  // yet.
+  auto [lower_bound, reduced_costs] =
+      RunSubgradient(costs, upper_bound, /*num_iterations=*/1000,
+                     /*adapt_step_size=*/false, &multipliers);
+  return std::make_tuple(std::max(lower_bound, 0.0), std::move(reduced_costs),
+                         std::move(multipliers));
+}
+
+std::tuple<Cost, SubsetCostVector> SetCoverLagrangian::RunSubgradient(
+    const SubsetCostVector& costs, Cost upper_bound, int num_iterations,
+    bool adapt_step_size, ElementCostVector* multipliers) {
+  // Sums computed by each worker over its shards. They are aligned on cache
+  // lines so that the workers do not write to the same line.
+  struct alignas(64) PartialSums {
+    Cost negative_reduced_costs = 0.0;
+    Cost multipliers = 0.0;
+    Cost square_subgradient = 0.0;
+  };
+  std::vector<PartialSums> partial_sums(num_threads_);
+  // The Lagrangian solution, collected per subset shard.
+  std::vector<std::vector<SubsetIndex>> negative_subsets(num_threads_);
+  SubsetCostVector reduced_costs(model_.num_subsets());
+  SubsetCostVector best_reduced_costs(model_.num_subsets());
+  ElementCostVector subgradient(model_.num_elements());
+  ElementCostVector best_multipliers = *multipliers;
+  ElementCostVector& u = *multipliers;
+  Cost best_value = -std::numeric_limits<Cost>::infinity();
+  CyclicBarrier barrier(num_threads_);
+  RunWorkers([&](int shard) {
+    const SubsetIndex subset_start = subset_shards_[shard];
+    const SubsetIndex subset_end = subset_shards_[shard + 1];
+    const ElementIndex element_start = element_shards_[shard];
+    const ElementIndex element_end = element_shards_[shard + 1];
+    // Every worker follows the step size on its own, they all get the same.
+    double step_size = 0.1;               // [***] arbitrary, from [1].
+    StepSizer step_sizer(20, step_size);  // [***] arbitrary, from [1].
+    Cost shard_best_value = -std::numeric_limits<Cost>::infinity();
+    for (int iter = 0; iter < num_iterations; ++iter) {
+      // Reduced costs and Lagrangian solution over the subsets of the shard.
+      FillReducedCostsSlice(subset_start, subset_end, costs, u, model_,
+                            &reduced_costs);
+      negative_subsets[shard].clear();
+      partial_sums[shard].negative_reduced_costs =
+          CollectNegativeSubsets(subset_start, subset_end, reduced_costs,
+                                 &negative_subsets[shard]);
+      barrier.Wait();
+
+      // Subgradient over the elements of the shard.
+      FillSubgradientSliceByElement(element_start, element_end,
+                                    model_.flat_columns(), negative_subsets,
+                                    &subgradient);
+      Cost multiplier_sum = 0.0;
+      Cost square_norm = 0.0;
+      for (ElementIndex element = element_start; element < element_end;
+           ++element) {
+        multiplier_sum += u[element];
+        square_norm += subgradient[element] * subgradient[element];
+      }
+      partial_sums[shard].multipliers = multiplier_sum;
+      partial_sums[shard].square_subgradient = square_norm;
+      barrier.Wait();
+
+      // The workers add the partial sums up in the same order, hence take
+      // the same decisions without a serial section.
+      Cost lagrangian_value = 0.0;
+      Cost subgradient_square_norm = 0.0;
+      for (const PartialSums& sums : partial_sums) {
+        lagrangian_value += sums.multipliers + sums.negative_reduced_costs;
+        subgradient_square_norm += sums.square_subgradient;
+      }
+      if (lagrangian_value > shard_best_value) {
+        shard_best_value = lagrangian_value;
+        std::copy(reduced_costs.begin() + subset_start.value(),
+                  reduced_costs.begin() + subset_end.value(),
+                  best_reduced_costs.begin() + subset_start.value());
+        std::copy(u.begin() + element_start.value(),
+                  u.begin() + element_end.value(),
+                  best_multipliers.begin() + element_start.value());
+      }
+      // A null subgradient means that the Lagrangian solution covers each
+      // element exactly once, i.e. is optimal.
+      if (upper_bound - shard_best_value <= kGapTolerance * upper_bound ||
+          subgradient_square_norm == 0.0) {
+        break;
+      }
+      // This is the update of ParallelUpdateMultipliers, see above.
+      const Cost factor = step_size * (upper_bound - lagrangian_value) /
+                          subgradient_square_norm;
+      for (ElementIndex element = element_start; element < element_end;
+           ++element) {
+        const Cost kRoof = 1e6;  // Arbitrary value, from [1].
+        u[element] =
+            std::clamp(u[element] + factor * subgradient[element], 0.0, kRoof);
+      }
+      if (adapt_step_size) {
+        step_size = step_sizer.UpdateStepSize(iter, lagrangian_value);
+      }
+      barrier.Wait();
+    }
+    if (shard == 0) best_value = shard_best_value;
+  });
+  *multipliers = std::move(best_multipliers);
+  return std::make_tuple(best_value, std::move(best_reduced_costs));
+}
+
+std::vector<SubsetIndex> SetCoverLagrangian::ComputeCore(
+    const SubsetCostVector& reduced_costs,
+    const SubsetBoolVector& solution) const {
+  SubsetBoolVector in_core(model_.num_subsets(), false);
+  std::vector<std::pair<Cost, SubsetIndex>> candidates;
+  // For each element, the subsets with the lowest reduced costs.
+  const FlatRowView& rows = model_.flat_rows();
+  for (const ElementIndex element : model_.ElementRange()) {
+    candidates.clear();
+    for (const SubsetIndex subset : rows[element]) {
+      if (!std::isinf(reduced_costs[subset])) {
+        candidates.push_back({reduced_costs[subset], subset});
+      }
+    }
+    const size_t num_kept =
+        std::min<size_t>(kCoreSubsetsPerElement, candidates.size());
+    std::nth_element(candidates.begin(), candidates.begin() + num_kept,
+                     candidates.end());
+    for (size_t i = 0; i < num_kept; ++i) {
+      in_core[candidates[i].second] = true;
+    }
+  }
+  // The subsets with low reduced costs.
+  candidates.clear();
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (!in_core[subset] &&
+        reduced_costs[subset] < kCoreReducedCostThreshold) {
+      candidates.push_back({reduced_costs[subset], subset});
+    }
+  }
+  const size_t max_num_candidates =
+      static_cast<size_t>(kCoreSubsetsPerElement) * model_.num_elements();
+  if (candidates.size() > max_num_candidates) {
+    std::nth_element(candidates.begin(),
+                     candidates.begin() + max_num_candidates,
+                     candidates.end());
+    candidates.resize(max_num_candidates);
+  }
+  for (const auto& [reduced_cost, subset] : candidates) {
+    in_core[subset] = true;
+  }
+  std::vector<SubsetIndex> core;
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (in_core[subset] || solution[subset]) {
+      core.push_back(subset);
+    }
+  }
+  return core;
+}
+
+SubsetBoolVector SetCoverLagrangian::SolveCore(
+    absl::Span<const SubsetIndex> core,
+    const SubsetCostVector& core_reduced_costs,
+    SetCoverInvariant* core_inv) const {
+  const SetCoverModel& core_model = *core_inv->model();
+  SubsetCostVector guided_costs(core_model.num_subsets());
+  for (const SubsetIndex subset : core_model.SubsetRange()) {
+    guided_costs[subset] = std::max(core_reduced_costs[subset], 0.0) +
+                           kMinCostFraction * core_model.subset_costs()[subset];
+  }
+  core_inv->Clear();
+  GreedySolutionGenerator greedy(core_inv);
+  CHECK(greedy.NextSolution(core_model.all_subsets(), guided_costs));
+  // The greedy generator only traces the subsets it selected itself.
+  core_inv->LoadSolution(core_inv->is_selected());
+  SteepestSearch steepest(core_inv);
+  CHECK(steepest.NextSolution(core_model.num_subsets()));
+  if (core_solver_) {
+    CHECK(core_solver_(core_inv));
+  } else {
+    GuidedLocalSearch gls(core_inv);
+    CHECK(gls.NextSolution(kNumCoreSolverIterations));
+  }
+  core_inv->Recompute(CL::kFreeAndUncovered);
+  DCHECK_EQ(core_inv->num_uncovered_elements(), 0);
+  SubsetBoolVector solution(model_.num_subsets(), false);
+  for (const SubsetIndex subset : core_model.SubsetRange()) {
+    if (core_inv->is_selected()[subset]) {
+      solution[core[subset.value()]] = true;
+    }
+  }
+  return solution;
+}
+
+void SetCoverLagrangian::ThreePhase(const SubsetBoolVector& in_focus,
+                                    Cost upper_bound) {
+  constexpr Cost kInfinity = std::numeric_limits<Cost>::infinity();
+  SubsetBoolVector best_solution = inv_->is_selected();
+  Cost best_cost = upper_bound;
+  // A subset fixed to zero gets an infinite cost. Its reduced cost is then
+  // infinite too, and it enters neither the Lagrangian solutions nor the
+  // cores.
+  SubsetCostVector costs = model_.subset_costs();
+  num_fixed_subsets_ = 0;
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (!in_focus[subset] && !best_solution[subset]) {
+      costs[subset] = kInfinity;
+      ++num_fixed_subsets_;
+    }
+  }
+  lower_bound_ = 0.0;
+  core_size_ = 0;
+  ElementCostVector multipliers = InitializeLagrangeMultipliers();
+  int num_rounds_without_improvement = 0;
+  for (int round = 0; round < kMaxNumRounds; ++round) {
+    // Pricing: the Lagrangian value over the whole model is a lower bound for
+    // any multipliers.
+    SubsetCostVector reduced_costs =
+        ParallelComputeReducedCosts(costs, multipliers);
     const Cost lagrangian_value =
         ParallelComputeLagrangianValue(reduced_costs, multipliers);
-    ParallelUpdateMultipliers(step_size, lagrangian_value, upper_bound,
-                              reduced_costs, &multipliers);
-    lower_bound = std::max(lower_bound, lagrangian_value);
-    // step_size should be updated like this. For the time besing, we keep the
-    // step size, because the implementation of the rest is not adequate yet
-    // step_size = step_sizer.UpdateStepSize(iter, lagrangian_value);
-    // if (stopper.DecideWhetherToStop(iter, lower_bound)) {
-    //   break;
-    // }
-  }
-  return std::make_tuple(lower_bound, reduced_costs, multipliers);
+    lower_bound_ = std::max(lower_bound_, lagrangian_value);
+    if (best_cost - lower_bound_ <= kGapTolerance * best_cost) break;
+
+    // Fixing: a solution containing subset costs at least
+    // lagrangian_value + reduced_costs[subset]. The subsets of the best
+    // solution are kept, so that the cores always contain it.
+    const Cost gap = best_cost - lagrangian_value;
+    for (const SubsetIndex subset : model_.SubsetRange()) {
+      if (!std::isinf(costs[subset]) && !best_solution[subset] &&
+          reduced_costs[subset] > gap) {
+        costs[subset] = kInfinity;
+        reduced_costs[subset] = kInfinity;
+        ++num_fixed_subsets_;
+      }
+    }
+
+    // Core: the multipliers are refined on the core, whose subgradient steps
+    // are much cheaper, then the core is solved heuristically.
+    const std::vector<SubsetIndex> core =
+        ComputeCore(reduced_costs, best_solution);
+    core_size_ = core.size();
+    SetCoverModel core_model = model_.ExtractSubModel(core);
+    SetCoverInvariant core_inv(&core_model);
+    SetCoverLagrangian core_lagrangian(&core_inv, num_threads_);
+    const auto [core_value, core_reduced_costs] =
+        core_lagrangian.RunSubgradient(core_model.subset_costs(), best_cost,
+                                       kNumCoreSubgradientIterations,
+                                       /*adapt_step_size=*/true, &multipliers);
+    const SubsetBoolVector solution =
+        SolveCore(core, core_reduced_costs, &core_inv);
+    VLOG(1) << "ThreePhase round " << round << ": lower bound "
+            << lower_bound_ << ", core lower bound " << core_value
+            << ", fixed subsets " << num_fixed_subsets_ << ", core size "
+            << core_size_ << ", core solution cost " << core_inv.cost()
+            << ", best cost " << best_cost;
+    if (core_inv.cost() < best_cost) {
+      best_cost = core_inv.cost();
+      best_solution = solution;
+      num_rounds_without_improvement = 0;
+    } else if (++num_rounds_without_improvement >=
+               kMaxNumRoundsWithoutImprovement) {
+      break;
+    }
+  }
+  inv_->LoadSolution(best_solution);
+}
+
+bool SetCoverLagrangian::NextSolution() {
+  return NextSolution(model_.all_subsets());
+}
+
+bool SetCoverLagrangian::NextSolution(const std::vector<SubsetIndex>& focus) {
+  inv_->Recompute(CL::kFreeAndUncovered);
+  if (inv_->num_uncovered_elements() != 0) {
+    GreedySolutionGenerator greedy(inv_);
+    if (!greedy.NextSolution(focus) || inv_->num_uncovered_elements() != 0) {
+      return false;
+    }
+    inv_->LoadSolution(inv_->is_selected());
+  }
+  SubsetBoolVector in_focus(model_.num_subsets(), false);
+  for (const SubsetIndex subset : focus) {
+    in_focus[subset] = true;
+  }
+  ThreePhase(in_focus, inv_->cost());
+  inv_->Recompute(CL::kFreeAndUncovered);
+  return true;
 }
 
 }  // namespace operations_research
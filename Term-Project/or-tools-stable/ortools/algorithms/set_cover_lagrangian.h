@@ -14,11 +14,15 @@
 #ifndef OR_TOOLS_ALGORITHMS_SET_COVER_LAGRANGIAN_H_
 #define OR_TOOLS_ALGORITHMS_SET_COVER_LAGRANGIAN_H_
 
+#include <functional>
 #include <memory>
 #include <new>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#include "absl/functional/function_ref.h"
+#include "absl/types/span.h"
 #include "ortools/algorithms/set_cover_invariant.h"
 #include "ortools/algorithms/set_cover_model.h"
 #include "ortools/base/threadpool.h"
@@ -50,17 +54,40 @@ class SetCoverLagrangian {
         num_threads_(num_threads),
         thread_pool_(new ThreadPool(num_threads)) {
     thread_pool_->StartWorkers();
+    ComputeShards();
   }
 
   // Returns true if a solution was found.
+  // Starts from the solution in inv_, or from a greedy one if inv_ does not
+  // cover all the elements, and improves it with ThreePhase. inv_ holds the
+  // best solution found on return.
   // TODO(user): Add time-outs and exit with a partial solution. This seems
   // unlikely, though.
   bool NextSolution();
 
   // Computes the next partial solution considering only the subsets whose
-  // indices are in focus.
+  // indices are in focus. The subsets selected in inv_ are kept available.
   bool NextSolution(const std::vector<SubsetIndex>& focus);
 
+  // Sets the algorithm used by ThreePhase to improve the solutions of the
+  // core problems. It is called with an invariant of the core model holding a
+  // complete solution, and must leave a complete solution in it. By default,
+  // GuidedLocalSearch is run. SetCoverMip can be used instead once the core is
+  // small enough.
+  void SetCoreSolver(std::function<bool(SetCoverInvariant*)> core_solver) {
+    core_solver_ = std::move(core_solver);
+  }
+
+  // Returns the best lower bound proven by the last call to NextSolution.
+  Cost lower_bound() const { return lower_bound_; }
+
+  // Returns the number of subsets fixed to zero by the last call to
+  // NextSolution, including the ones outside the focus.
+  BaseInt num_fixed_subsets() const { return num_fixed_subsets_; }
+
+  // Returns the number of subsets in the last core problem.
+  BaseInt core_size() const { return core_size_; }
+
   // Initializes the multipliers vector (u) based on the cost per subset.
   ElementCostVector InitializeLagrangeMultipliers() const;
 
@@ -124,8 +151,28 @@ class SetCoverLagrangian {
                   const SubsetBoolVector& solution,
                   const ElementCostVector& multipliers) const;
 
-  // Performs the three-phase algorithm.
-  void ThreePhase(Cost upper_bound);
+  // Performs the three-phase algorithm of [1] on the subsets in focus, from
+  // the solution in inv_ whose cost is upper_bound. Each round
+  // - prices all the subsets that are not fixed, which gives a lower bound,
+  // - fixes to zero the subsets whose reduced cost exceeds the gap between
+  //   upper_bound and the lower bound, since they cannot be part of a better
+  //   solution,
+  // - builds a core problem from the subsets with the lowest reduced costs
+  //   and those of the best solution, runs subgradient steps on it, and
+  //   solves it heuristically with the core solver.
+  // The core is rebuilt from the whole model at the next round. Stops when
+  // the gap is closed or when the best solution does not improve anymore.
+  // inv_ holds the best solution found on return.
+  void ThreePhase(const SubsetBoolVector& in_focus, Cost upper_bound);
+
+  // Returns the subsets of the core problem, sorted: for each element, the
+  // kCoreSubsetsPerElement subsets with the lowest reduced costs, the subsets
+  // whose reduced cost is below kCoreReducedCostThreshold (at most
+  // kCoreSubsetsPerElement times the number of elements of them), and the
+  // subsets in solution. Subsets whose reduced cost is infinite are fixed and
+  // never part of the core.
+  std::vector<SubsetIndex> ComputeCore(const SubsetCostVector& reduced_costs,
+                                       const SubsetBoolVector& solution) const;
 
   // Computes a lower bound on the optimal cost.
   // The returned value is the lower bound, the reduced costs, and the
@@ -134,6 +181,52 @@ class SetCoverLagrangian {
       const SubsetCostVector& costs, Cost upper_bound);
 
  private:
+  // Splits the subsets and the elements in num_threads_ shards each, with
+  // about the same number of nonzeros.
+  void ComputeShards();
+
+  // Runs worker(shard) for each shard, shard 0 in the calling thread and the
+  // others on thread_pool_, and waits for all of them.
+  void RunWorkers(absl::FunctionRef<void(int)> worker) const;
+
+  // Runs at most num_iterations subgradient steps from multipliers for the
+  // given costs. If adapt_step_size is false, the step size stays at its
+  // initial value. Returns the best Lagrangian value found and the reduced
+  // costs for the multipliers that reached it, which are stored in
+  // multipliers.
+  // The loop runs on persistent workers, one per shard, which meet at a
+  // barrier between the phases of each step instead of being scheduled anew:
+  // - each worker computes the reduced costs of its subsets, their part of the
+  //   Lagrangian value and of the Lagrangian solution,
+  // - each worker computes the subgradient for its elements, from the
+  //   Lagrangian solution, and their part of the subgradient norm,
+  // - each worker adds up the partial sums, in the same order as the others,
+  //   so that they all take the same decisions, and updates the multipliers
+  //   of its elements.
+  std::tuple<Cost, SubsetCostVector> RunSubgradient(
+      const SubsetCostVector& costs, Cost upper_bound, int num_iterations,
+      bool adapt_step_size, ElementCostVector* multipliers);
+
+  // Solves the core problem held by core_inv, whose subset i is core[i]: first
+  // greedily, on costs guided by core_reduced_costs, then with the core
+  // solver. Returns the solution found, on the whole model.
+  SubsetBoolVector SolveCore(absl::Span<const SubsetIndex> core,
+                             const SubsetCostVector& core_reduced_costs,
+                             SetCoverInvariant* core_inv) const;
+
+  // Parameters of ThreePhase. The values follow [1] when it gives them.
+  static constexpr int kCoreSubsetsPerElement = 5;
+  static constexpr double kCoreReducedCostThreshold = 0.1;
+  static constexpr int kNumCoreSubgradientIterations = 1000;
+  static constexpr int kMaxNumRounds = 20;
+  static constexpr int kMaxNumRoundsWithoutImprovement = 3;
+  static constexpr int kNumCoreSolverIterations = 1000;
+  // Fraction of the actual cost added to the reduced costs that guide the
+  // greedy algorithm, so that the guided costs are positive.
+  static constexpr double kMinCostFraction = 1e-3;
+  // Relative gap under which the best solution is considered optimal.
+  static constexpr double kGapTolerance = 1e-9;
+
   // The invariant on which the algorithm will run.
   SetCoverInvariant* inv_;
 
@@ -146,12 +239,26 @@ class SetCoverLagrangian {
   // The thread pool used for parallelization.
   std::unique_ptr<ThreadPool> thread_pool_;
 
+  // Bounds of the shards of subsets and elements processed by each thread.
+  // Shard i is [shards[i], shards[i + 1]).
+  std::vector<SubsetIndex> subset_shards_;
+  std::vector<ElementIndex> element_shards_;
+
   // Total (scalar) Lagrangian cost.
   Cost lagrangian_;
 
   // Lagrangian cost vector, per subset.
   SubsetCostVector lagrangians_;
 
+  // Improves the solutions of the core problems. If empty, GuidedLocalSearch
+  // is used.
+  std::function<bool(SetCoverInvariant*)> core_solver_;
+
+  // Statistics of the last call to NextSolution.
+  Cost lower_bound_ = 0.0;
+  BaseInt num_fixed_subsets_ = 0;
+  BaseInt core_size_ = 0;
+
   // Computes the delta vector.
   // This is definition (9) in [1].
   SubsetCostVector ComputeDelta(const SubsetCostVector& reduced_costs,
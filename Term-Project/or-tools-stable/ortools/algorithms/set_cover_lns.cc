@@ -0,0 +1,230 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/algorithms/set_cover_lns.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/random/distributions.h"
+#include "absl/types/span.h"
+#include "ortools/algorithms/set_cover_heuristics.h"
+#include "ortools/algorithms/set_cover_invariant.h"
+#include "ortools/algorithms/set_cover_lagrangian.h"
+#include "ortools/algorithms/set_cover_mip.h"
+#include "ortools/algorithms/set_cover_model.h"
+#include "ortools/base/logging.h"
+
+namespace operations_research {
+
+using CL = SetCoverInvariant::ConsistencyLevel;
+
+SetCoverLns::SetCoverLns(SetCoverInvariant* inv, SetCoverMipSolver mip_solver)
+    : inv_(inv), mip_solver_(mip_solver) {
+  // IntersectingSubsetsIterator needs the flat views.
+  inv_->model()->CreateFlatViews();
+}
+
+bool SetCoverLns::NextSolution(int num_iterations,
+                               double time_limit_in_seconds) {
+  return NextSolution(inv_->model()->all_subsets(), num_iterations,
+                      time_limit_in_seconds);
+}
+
+bool SetCoverLns::NextSolution(absl::Span<const SubsetIndex> focus,
+                               int num_iterations,
+                               double time_limit_in_seconds) {
+  DCHECK(!neighborhoods_.empty());
+  inv_->Recompute(CL::kFreeAndUncovered);
+  if (inv_->num_uncovered_elements() != 0) {
+    GreedySolutionGenerator greedy(inv_);
+    if (!greedy.NextSolution(focus) || inv_->num_uncovered_elements() != 0) {
+      return false;
+    }
+  }
+  // From now on, the trace only grows with the iterations, and is rolled back
+  // when they fail.
+  inv_->CompressTrace();
+  SubsetBoolVector in_focus(inv_->model()->num_subsets(), false);
+  for (const SubsetIndex subset : focus) {
+    in_focus[subset] = true;
+  }
+  for (int iteration = 0; iteration < num_iterations; ++iteration) {
+    const Neighborhood neighborhood =
+        neighborhoods_[iteration % neighborhoods_.size()];
+    if (RunIteration(neighborhood, in_focus, time_limit_in_seconds)) {
+      ++num_improvements_;
+      VLOG(1) << "LNS iteration " << iteration << ": cost " << inv_->cost()
+              << ", neighborhood size " << neighborhood_size_;
+    }
+    if (static_cast<BaseInt>(inv_->trace().size()) >
+        inv_->model()->num_subsets()) {
+      inv_->CompressTrace();
+    }
+  }
+  inv_->CompressTrace();
+  inv_->Recompute(CL::kFreeAndUncovered);
+  return true;
+}
+
+bool SetCoverLns::RunIteration(Neighborhood neighborhood,
+                               const SubsetBoolVector& in_focus,
+                               double time_limit_in_seconds) {
+  const SetCoverModel& model = *inv_->model();
+  const std::vector<SubsetIndex> deselected =
+      ChooseNeighborhood(neighborhood, in_focus);
+  if (deselected.empty()) return false;
+  const Cost cost_before = inv_->cost();
+  const BaseInt checkpoint = inv_->Checkpoint();
+  for (const SubsetIndex subset : deselected) {
+    inv_->Deselect(subset, CL::kCostAndCoverage);
+  }
+
+  // The sub-problem covers the free elements with the subsets in focus that
+  // cover them, which include the deselected ones.
+  const ElementToIntVector& coverage = inv_->coverage();
+  const FlatColumnView& columns = model.flat_columns();
+  const FlatRowView& rows = model.flat_rows();
+  ElementBoolVector is_free(model.num_elements(), false);
+  SubsetBoolVector in_sub_problem(model.num_subsets(), false);
+  std::vector<ElementIndex> free_elements;
+  std::vector<SubsetIndex> sub_problem;
+  for (const SubsetIndex subset : deselected) {
+    for (const ElementIndex element : columns[subset]) {
+      if (coverage[element] != 0 || is_free[element]) continue;
+      is_free[element] = true;
+      free_elements.push_back(element);
+      for (const SubsetIndex candidate : rows[element]) {
+        if (in_focus[candidate] && !in_sub_problem[candidate]) {
+          in_sub_problem[candidate] = true;
+          sub_problem.push_back(candidate);
+        }
+      }
+    }
+  }
+
+  bool covered = true;
+  if (!free_elements.empty()) {
+    SetCoverMip mip(inv_, mip_solver_);
+    covered = mip.NextSolution(sub_problem, /*use_integers=*/true,
+                               time_limit_in_seconds);
+    for (const ElementIndex element : free_elements) {
+      covered = covered && coverage[element] != 0;
+    }
+    if (!mip.solved_to_optimality()) {
+      neighborhood_size_ = std::max<BaseInt>(
+          kMinNeighborhoodSize,
+          static_cast<BaseInt>(std::floor(neighborhood_size_ * kShrinkFactor)));
+    } else if (covered && inv_->cost() >= cost_before) {
+      neighborhood_size_ = std::max<BaseInt>(
+          neighborhood_size_ + 1,
+          static_cast<BaseInt>(neighborhood_size_ * kGrowthFactor));
+    }
+  }
+  // Moves to solutions of the same cost are kept, to diversify the search.
+  if (!covered || inv_->cost() > cost_before) {
+    inv_->Rollback(checkpoint, CL::kCostAndCoverage);
+    return false;
+  }
+  return inv_->cost() < cost_before;
+}
+
+std::vector<SubsetIndex> SetCoverLns::ChooseNeighborhood(
+    Neighborhood neighborhood, const SubsetBoolVector& in_focus) {
+  std::vector<SubsetIndex> candidates;
+  for (const SubsetIndex subset : inv_->model()->SubsetRange()) {
+    if (in_focus[subset] && inv_->is_selected()[subset]) {
+      candidates.push_back(subset);
+    }
+  }
+  if (candidates.empty()) return candidates;
+  switch (neighborhood) {
+    case Neighborhood::kRandom:
+      return ChooseRandomSubsets(std::move(candidates));
+    case Neighborhood::kElementCluster:
+      return ChooseElementCluster(candidates, in_focus);
+    case Neighborhood::kReducedCost:
+      return ChooseHighReducedCostSubsets(std::move(candidates));
+  }
+  LOG(FATAL) << "Unknown neighborhood.";
+}
+
+std::vector<SubsetIndex> SetCoverLns::ChooseRandomSubsets(
+    std::vector<SubsetIndex> candidates) {
+  std::shuffle(candidates.begin(), candidates.end(), bitgen_);
+  candidates.resize(std::min<size_t>(neighborhood_size_, candidates.size()));
+  return candidates;
+}
+
+std::vector<SubsetIndex> SetCoverLns::ChooseElementCluster(
+    const std::vector<SubsetIndex>& candidates,
+    const SubsetBoolVector& in_focus) {
+  const SetCoverModel& model = *inv_->model();
+  const size_t size = std::min<size_t>(neighborhood_size_, candidates.size());
+  std::vector<SubsetIndex> cluster;
+  SubsetBoolVector in_cluster(model.num_subsets(), false);
+  // The cluster is grown breadth-first through the selected subsets that
+  // share an element. When it cannot be grown anymore, it is restarted from
+  // another random subset.
+  size_t next = 0;  // Index in cluster of the next subset to expand.
+  while (cluster.size() < size) {
+    if (next == cluster.size()) {
+      SubsetIndex seed;
+      do {
+        seed = candidates[absl::Uniform<size_t>(bitgen_, 0, candidates.size())];
+      } while (in_cluster[seed]);
+      in_cluster[seed] = true;
+      cluster.push_back(seed);
+      continue;
+    }
+    for (IntersectingSubsetsIterator it(model, cluster[next]);
+         !it.at_end() && cluster.size() < size; ++it) {
+      const SubsetIndex subset = *it;
+      if (in_cluster[subset] || !in_focus[subset] ||
+          !inv_->is_selected()[subset]) {
+        continue;
+      }
+      in_cluster[subset] = true;
+      cluster.push_back(subset);
+    }
+    ++next;
+  }
+  return cluster;
+}
+
+std::vector<SubsetIndex> SetCoverLns::ChooseHighReducedCostSubsets(
+    std::vector<SubsetIndex> candidates) {
+  if (reduced_costs_.empty()) {
+    SetCoverLagrangian lagrangian(inv_);
+    reduced_costs_ = std::get<1>(lagrangian.ComputeLowerBound(
+        inv_->model()->subset_costs(), inv_->cost()));
+  }
+  // The neighborhood is drawn among the twice as many subsets with the
+  // highest reduced costs, so that it changes from one iteration to the next.
+  const size_t pool_size =
+      std::min<size_t>(2 * neighborhood_size_, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + pool_size,
+                    candidates.end(),
+                    [this](const SubsetIndex a, const SubsetIndex b) {
+                      return reduced_costs_[a] > reduced_costs_[b];
+                    });
+  candidates.resize(pool_size);
+  return ChooseRandomSubsets(std::move(candidates));
+}
+
+}  // namespace operations_research
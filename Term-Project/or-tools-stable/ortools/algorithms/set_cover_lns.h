@@ -0,0 +1,138 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OR_TOOLS_ALGORITHMS_SET_COVER_LNS_H_
+#define OR_TOOLS_ALGORITHMS_SET_COVER_LNS_H_
+
+#include <utility>
+#include <vector>
+
+#include "absl/random/random.h"
+#include "absl/types/span.h"
+#include "ortools/algorithms/set_cover_invariant.h"
+#include "ortools/algorithms/set_cover_mip.h"
+#include "ortools/algorithms/set_cover_model.h"
+
+namespace operations_research {
+
+// Large neighborhood search (LNS) for the weighted set covering problem, with
+// SetCoverMip as the sub-problem solver.
+//
+// Each iteration starts from the solution held by the invariant, and:
+// - picks a neighborhood, i.e. some subsets of the solution,
+// - deselects them, which uncovers some elements, called free elements,
+// - solves with SetCoverMip the sub-problem of covering the free elements
+//   with the subsets that cover them, the rest of the solution being frozen,
+// - keeps the new solution if it is not more expensive, and rolls back to the
+//   previous one otherwise.
+// The sub-problems are small enough to be solved exactly within a short time
+// limit, which on hard unicost instances finds moves that are out of reach of
+// the local search heuristics.
+//
+// The neighborhoods are used in turn:
+// - kRandom: subsets of the solution drawn at random,
+// - kElementCluster: subsets of the solution that intersect one another,
+//   grown from a random subset with IntersectingSubsetsIterator,
+// - kReducedCost: subsets of the solution drawn among the ones with the
+//   highest Lagrangian reduced costs, i.e. the least likely to be in an
+//   optimal solution according to the Lagrangian relaxation. The multipliers
+//   are computed once, the first time this neighborhood is used.
+// The number of subsets in a neighborhood adapts to the sub-problems: it grows
+// when a sub-problem is solved to optimality without improving the solution,
+// and shrinks when the time limit is reached.
+//
+// The consistency level is maintained up to kCostAndCoverage.
+class SetCoverLns {
+ public:
+  enum class Neighborhood { kRandom, kElementCluster, kReducedCost };
+
+  explicit SetCoverLns(SetCoverInvariant* inv)
+      : SetCoverLns(inv, SetCoverMipSolver::SCIP) {}
+
+  SetCoverLns(SetCoverInvariant* inv, SetCoverMipSolver mip_solver);
+
+  // Returns true if a solution was found.
+  // Starts from the solution in inv_, or from a greedy one if inv_ does not
+  // cover all the elements, and runs num_iterations LNS iterations, each
+  // sub-problem being solved with a time limit of time_limit_in_seconds.
+  bool NextSolution(int num_iterations, double time_limit_in_seconds);
+
+  // Computes the next partial solution considering only the subsets whose
+  // indices are in focus.
+  bool NextSolution(absl::Span<const SubsetIndex> focus, int num_iterations,
+                    double time_limit_in_seconds);
+
+  // Sets the neighborhoods to use in turn. All of them are used by default.
+  void SetNeighborhoods(std::vector<Neighborhood> neighborhoods) {
+    neighborhoods_ = std::move(neighborhoods);
+  }
+
+  // Sets the initial number of subsets in a neighborhood.
+  void SetNeighborhoodSize(BaseInt size) { neighborhood_size_ = size; }
+
+  // Returns the current number of subsets in a neighborhood.
+  BaseInt neighborhood_size() const { return neighborhood_size_; }
+
+  // Returns the number of iterations that decreased the cost.
+  int num_improvements() const { return num_improvements_; }
+
+ private:
+  // Bounds and adaptation factors for the size of the neighborhoods.
+  static constexpr BaseInt kDefaultNeighborhoodSize = 20;
+  static constexpr BaseInt kMinNeighborhoodSize = 2;
+  static constexpr double kGrowthFactor = 1.1;
+  static constexpr double kShrinkFactor = 0.8;
+
+  // Runs one LNS iteration with the given neighborhood. Returns true if the
+  // cost decreased.
+  bool RunIteration(Neighborhood neighborhood,
+                    const SubsetBoolVector& in_focus,
+                    double time_limit_in_seconds);
+
+  // Returns the subsets to deselect, according to the neighborhood, among
+  // the selected subsets in focus.
+  std::vector<SubsetIndex> ChooseNeighborhood(Neighborhood neighborhood,
+                                              const SubsetBoolVector& in_focus);
+  std::vector<SubsetIndex> ChooseRandomSubsets(
+      std::vector<SubsetIndex> candidates);
+  std::vector<SubsetIndex> ChooseElementCluster(
+      const std::vector<SubsetIndex>& candidates,
+      const SubsetBoolVector& in_focus);
+  std::vector<SubsetIndex> ChooseHighReducedCostSubsets(
+      std::vector<SubsetIndex> candidates);
+
+  // The invariant holding the incumbent solution.
+  SetCoverInvariant* inv_;
+
+  // The MIP solver used for the sub-problems.
+  SetCoverMipSolver mip_solver_;
+
+  std::vector<Neighborhood> neighborhoods_ = {Neighborhood::kRandom,
+                                              Neighborhood::kElementCluster,
+                                              Neighborhood::kReducedCost};
+
+  // The number of subsets in a neighborhood, adapted during the search.
+  BaseInt neighborhood_size_ = kDefaultNeighborhoodSize;
+
+  // The Lagrangian reduced costs used by kReducedCost. Empty until the first
+  // use.
+  SubsetCostVector reduced_costs_;
+
+  int num_improvements_ = 0;
+
+  absl::BitGen bitgen_;
+};
+
+}  // namespace operations_research
+
+#endif  // OR_TOOLS_ALGORITHMS_SET_COVER_LNS_H_
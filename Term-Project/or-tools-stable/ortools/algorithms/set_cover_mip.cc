@@ -107,7 +107,7 @@ bool SetCoverMip::NextSolution(absl::Span<const SubsetIndex> focus,
   for (const SubsetIndex subset : focus) {
     vars[subset] = solver.MakeVar(0, 1, use_integers, "");
     objective->SetCoefficient(vars[subset], model->subset_costs()[subset]);
-    for (const ElementIndex element : model->columns()[subset]) {
+    for (const ElementIndex element : model->flat_columns()[subset]) {
       // The model should only contain elements that are not forcibly covered by
       // subsets outside the focus.
       if (coverage_outside_focus[element] != 0) continue;
@@ -123,6 +123,7 @@ bool SetCoverMip::NextSolution(absl::Span<const SubsetIndex> focus,
 
   // Call the solver.
   const MPSolver::ResultStatus solve_status = solver.Solve();
+  solved_to_optimality_ = solve_status == MPSolver::OPTIMAL;
   switch (solve_status) {
     case MPSolver::OPTIMAL:
       break;
@@ -134,6 +135,10 @@ bool SetCoverMip::NextSolution(absl::Span<const SubsetIndex> focus,
     case MPSolver::UNBOUNDED:
       LOG(ERROR) << "Did not find solution. Problem is unbounded.";
       break;
+    case MPSolver::NOT_SOLVED:
+      // Expected when the time limit is short, e.g. in SetCoverLns.
+      VLOG(1) << "No solution found within the time limit.";
+      return false;
     default:
       LOG(ERROR) << "Solving resulted in an error.";
       return false;
@@ -54,6 +54,10 @@ class SetCoverMip {
   // Returns the lower bound of the linear relaxation of the problem.
   double lower_bound() const { return lower_bound_; }
 
+  // Returns true if the last call to NextSolution proved its solution, or its
+  // lower bound, optimal within the time limit.
+  bool solved_to_optimality() const { return solved_to_optimality_; }
+
  private:
   // The invariant used to maintain the state of the problem.
   SetCoverInvariant* inv_;
@@ -64,6 +68,9 @@ class SetCoverMip {
   // The lower bound of the problem, when use_integers is false. The MIP with
   // continuous variables becomes a computationally simpler linear program.
   double lower_bound_;
+
+  // Whether the last solve ended with the status OPTIMAL.
+  bool solved_to_optimality_ = false;
 };
 }  // namespace operations_research
 
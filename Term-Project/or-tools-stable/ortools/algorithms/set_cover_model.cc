@@ -147,6 +147,8 @@ SetCoverModel SetCoverModel::GenerateRandomModelFrom(
         ++num_tries;
       } while (num_tries < kMaxTries &&
                subset_already_contains_element[element]);
+      // The subset ends up smaller rather than with a repeated element.
+      if (subset_already_contains_element[element]) continue;
       ++model.num_nonzeros_;
       model.columns_[subset].push_back(element);
       subset_already_contains_element[element] = true;
@@ -188,6 +190,7 @@ SetCoverModel SetCoverModel::GenerateRandomModelFrom(
             ++num_tries;
           } while (num_tries < kMaxTries &&
                    element_already_in_subset[subset_index]);
+          if (element_already_in_subset[subset_index]) continue;
           ++model.num_nonzeros_;
           model.columns_[subset_index].push_back(element);
           element_already_in_subset[subset_index] = true;
@@ -236,7 +239,14 @@ void SetCoverModel::UpdateAllSubsetsList() {
   }
 }
 
+void SetCoverModel::InvalidateViews() {
+  row_view_is_valid_ = false;
+  flat_views_are_valid_ = false;
+  compressed_column_view_is_valid_ = false;
+}
+
 void SetCoverModel::AddEmptySubset(Cost cost) {
+  CheckNestedViewsAreNotReleased();
   elements_in_subsets_are_sorted_ = false;
   subset_costs_.push_back(cost);
   columns_.push_back(SparseColumn());
@@ -245,16 +255,17 @@ void SetCoverModel::AddEmptySubset(Cost cost) {
   CHECK_EQ(columns_.size(), num_subsets());
   CHECK_EQ(subset_costs_.size(), num_subsets());
   CHECK_EQ(all_subsets_.size(), num_subsets());
-  row_view_is_valid_ = false;
+  InvalidateViews();
 }
 
 void SetCoverModel::AddElementToLastSubset(BaseInt element) {
+  CheckNestedViewsAreNotReleased();
   elements_in_subsets_are_sorted_ = false;
   columns_.back().push_back(ElementIndex(element));
   num_elements_ = std::max(num_elements_, element + 1);
   // No need to update the list all_subsets_.
   ++num_nonzeros_;
-  row_view_is_valid_ = false;
+  InvalidateViews();
 }
 
 void SetCoverModel::AddElementToLastSubset(ElementIndex element) {
@@ -262,6 +273,7 @@ void SetCoverModel::AddElementToLastSubset(ElementIndex element) {
 }
 
 void SetCoverModel::SetSubsetCost(BaseInt subset, Cost cost) {
+  CheckNestedViewsAreNotReleased();
   elements_in_subsets_are_sorted_ = false;
   CHECK(std::isfinite(cost));
   DCHECK_GE(subset, 0);
@@ -269,7 +281,7 @@ void SetCoverModel::SetSubsetCost(BaseInt subset, Cost cost) {
     num_subsets_ = std::max(num_subsets_, subset + 1);
     columns_.resize(num_subsets_, SparseColumn());
     subset_costs_.resize(num_subsets_, 0.0);
-    row_view_is_valid_ = false;
+    InvalidateViews();
     UpdateAllSubsetsList();
   }
   subset_costs_[SubsetIndex(subset)] = cost;
@@ -280,6 +292,7 @@ void SetCoverModel::SetSubsetCost(SubsetIndex subset, Cost cost) {
 }
 
 void SetCoverModel::AddElementToSubset(BaseInt element, BaseInt subset) {
+  CheckNestedViewsAreNotReleased();
   elements_in_subsets_are_sorted_ = false;
   if (subset >= num_subsets()) {
     num_subsets_ = subset + 1;
@@ -290,7 +303,7 @@ void SetCoverModel::AddElementToSubset(BaseInt element, BaseInt subset) {
   columns_[SubsetIndex(subset)].push_back(ElementIndex(element));
   num_elements_ = std::max(num_elements_, element + 1);
   ++num_nonzeros_;
-  row_view_is_valid_ = false;
+  InvalidateViews();
 }
 
 void SetCoverModel::AddElementToSubset(ElementIndex element,
@@ -300,6 +313,12 @@ void SetCoverModel::AddElementToSubset(ElementIndex element,
 
 // Reserves num_subsets columns in the model.
 void SetCoverModel::ReserveNumSubsets(BaseInt num_subsets) {
+  CheckNestedViewsAreNotReleased();
+  if (num_subsets > num_subsets_) {
+    // Empty columns leave the rows unchanged, but not the frozen views.
+    flat_views_are_valid_ = false;
+    compressed_column_view_is_valid_ = false;
+  }
   num_subsets_ = std::max(num_subsets_, num_subsets);
   columns_.resize(num_subsets_, SparseColumn());
   subset_costs_.resize(num_subsets_, 0.0);
@@ -323,6 +342,7 @@ void SetCoverModel::ReserveNumElementsInSubset(ElementIndex num_elements,
 }
 
 void SetCoverModel::SortElementsInSubsets() {
+  CheckNestedViewsAreNotReleased();
   for (const SubsetIndex subset : SubsetRange()) {
     // std::sort(columns_[subset].begin(), columns_[subset].end());
     BaseInt* data = reinterpret_cast<BaseInt*>(columns_[subset].data());
@@ -335,6 +355,8 @@ void SetCoverModel::CreateSparseRowView() {
   if (row_view_is_valid_) {
     return;
   }
+  CheckNestedViewsAreNotReleased();
+  rows_.clear();
   rows_.resize(num_elements_, SparseRow());
   ElementToIntVector row_sizes(num_elements_, 0);
   for (const SubsetIndex subset : SubsetRange()) {
@@ -362,21 +384,68 @@ void SetCoverModel::CreateSparseRowView() {
   elements_in_subsets_are_sorted_ = true;
 }
 
+void SetCoverModel::CreateFlatViews() {
+  if (flat_views_are_valid_) {
+    return;
+  }
+  CreateSparseRowView();
+  flat_columns_ = FlatColumnView(columns_);
+  flat_rows_ = FlatRowView(rows_);
+  flat_views_are_valid_ = true;
+  VLOG(1) << "Flat views take "
+          << flat_columns_.MemoryUsage() + flat_rows_.MemoryUsage()
+          << " bytes for " << num_nonzeros_ << " nonzeros.";
+}
+
+void SetCoverModel::ReleaseNestedViews() {
+  CreateFlatViews();
+  // Swapping with empty vectors frees the memory, unlike clear().
+  SparseColumnView().swap(columns_);
+  SparseRowView().swap(rows_);
+  nested_views_are_released_ = true;
+}
+
+void SetCoverModel::CreateCompressedColumnView() {
+  if (compressed_column_view_is_valid_) {
+    return;
+  }
+  CheckNestedViewsAreNotReleased();
+  if (!elements_in_subsets_are_sorted_) {
+    SortElementsInSubsets();
+  }
+  compressed_columns_ = CompressedColumnView(columns_);
+  compressed_column_view_is_valid_ = true;
+  VLOG(1) << "Compressed column view takes "
+          << compressed_columns_.MemoryUsage() << " bytes for "
+          << num_nonzeros_ << " nonzeros.";
+}
+
 bool SetCoverModel::ComputeFeasibility() const {
   CHECK_GT(num_elements(), 0);
   CHECK_GT(num_subsets(), 0);
-  CHECK_EQ(columns_.size(), num_subsets());
+  if (nested_views_are_released_) {
+    CHECK_EQ(flat_columns_.size(), num_subsets());
+  } else {
+    CHECK_EQ(columns_.size(), num_subsets());
+  }
   CHECK_EQ(subset_costs_.size(), num_subsets());
   CHECK_EQ(all_subsets_.size(), num_subsets());
   ElementToIntVector coverage(num_elements_, 0);
   for (const Cost cost : subset_costs_) {
     CHECK_GT(cost, 0.0);
   }
-  for (const SparseColumn& column : columns_) {
+  // This is called by SetCoverInvariant, so it also works on the flat view
+  // when the nested views were released.
+  const auto add_coverage = [&coverage](const auto& column) {
     CHECK_GT(column.size(), 0);
     for (const ElementIndex element : column) {
       ++coverage[element];
     }
+  };
+  if (nested_views_are_released_) {
+    for (const auto& column : flat_columns_) add_coverage(column);
+  } else {
+    for (const SparseColumn& column : columns_) add_coverage(column);
   }
   for (const ElementIndex element : ElementRange()) {
     CHECK_GE(coverage[element], 0);
@@ -392,7 +461,30 @@ bool SetCoverModel::ComputeFeasibility() const {
   return true;
 }
 
+SetCoverModel SetCoverModel::ExtractSubModel(
+    absl::Span<const SubsetIndex> subsets) const {
+  SetCoverModel sub_model;
+  sub_model.num_elements_ = num_elements_;
+  sub_model.num_subsets_ = subsets.size();
+  sub_model.elements_in_subsets_are_sorted_ = elements_in_subsets_are_sorted_;
+  sub_model.subset_costs_.reserve(subsets.size());
+  sub_model.columns_.reserve(subsets.size());
+  for (const SubsetIndex subset : subsets) {
+    sub_model.subset_costs_.push_back(subset_costs_[subset]);
+    if (nested_views_are_released_) {
+      const FlatColumnView::List column = flat_columns_[subset];
+      sub_model.columns_.push_back(SparseColumn(column.begin(), column.end()));
+    } else {
+      sub_model.columns_.push_back(columns_[subset]);
+    }
+    sub_model.num_nonzeros_ += sub_model.columns_.back().size();
+  }
+  sub_model.UpdateAllSubsetsList();
+  return sub_model;
+}
+
 SetCoverProto SetCoverModel::ExportModelAsProto() const {
+  CheckNestedViewsAreNotReleased();
   CHECK(elements_in_subsets_are_sorted_);
   SetCoverProto message;
   for (const SubsetIndex subset : SubsetRange()) {
@@ -414,6 +506,8 @@ SetCoverProto SetCoverModel::ExportModelAsProto() const {
 }
 
 void SetCoverModel::ImportModelFromProto(const SetCoverProto& message) {
+  InvalidateViews();
+  nested_views_are_released_ = false;
   columns_.clear();
   subset_costs_.clear();
   ReserveNumSubsets(message.subset_size());
@@ -529,6 +623,7 @@ SetCoverModel::Stats SetCoverModel::ComputeCostStats() {
 }
 
 SetCoverModel::Stats SetCoverModel::ComputeRowStats() {
+  CheckNestedViewsAreNotReleased();
   std::vector<int64_t> row_sizes(num_elements(), 0);
   for (const SparseColumn& column : columns_) {
     for (const ElementIndex element : column) {
@@ -539,6 +634,7 @@ SetCoverModel::Stats SetCoverModel::ComputeRowStats() {
 }
 
 SetCoverModel::Stats SetCoverModel::ComputeColumnStats() {
+  CheckNestedViewsAreNotReleased();
   std::vector<int64_t> column_sizes(columns_.size());
   for (const SubsetIndex subset : SubsetRange()) {
     column_sizes[subset.value()] = columns_[subset].size();
@@ -547,6 +643,7 @@ SetCoverModel::Stats SetCoverModel::ComputeColumnStats() {
 }
 
 std::vector<int64_t> SetCoverModel::ComputeRowDeciles() const {
+  CheckNestedViewsAreNotReleased();
   std::vector<int64_t> row_sizes(num_elements(), 0);
   for (const SparseColumn& column : columns_) {
     for (const ElementIndex element : column) {
@@ -557,6 +654,7 @@ std::vector<int64_t> SetCoverModel::ComputeRowDeciles() const {
 }
 
 std::vector<int64_t> SetCoverModel::ComputeColumnDeciles() const {
+  CheckNestedViewsAreNotReleased();
   std::vector<int64_t> column_sizes(columns_.size());
   for (const SubsetIndex subset : SubsetRange()) {
     column_sizes[subset.value()] = columns_[subset].size();
@@ -573,6 +671,7 @@ BaseInt Base128SizeInBytes(BaseInt x) {
 }  // namespace
 
 SetCoverModel::Stats SetCoverModel::ComputeColumnDeltaSizeStats() const {
+  CheckNestedViewsAreNotReleased();
   StatsAccumulator acc;
   for (const SparseColumn& column : columns_) {
     int64_t previous = 0;
@@ -586,6 +685,7 @@ SetCoverModel::Stats SetCoverModel::ComputeColumnDeltaSizeStats() const {
 }
 
 SetCoverModel::Stats SetCoverModel::ComputeRowDeltaSizeStats() const {
+  CheckNestedViewsAreNotReleased();
   StatsAccumulator acc;
   for (const SparseRow& row : rows_) {
     int64_t previous = 0;
@@ -20,6 +20,7 @@
 
 #include "absl/log/check.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "ortools/algorithms/set_cover.pb.h"
 #include "ortools/base/strong_int.h"
 #include "ortools/base/strong_vector.h"
@@ -91,6 +92,218 @@ using SubsetToIntVector = util_intops::StrongVector<SubsetIndex, BaseInt>;
 using SparseColumnView = util_intops::StrongVector<SubsetIndex, SparseColumn>;
 using SparseRowView = util_intops::StrongVector<ElementIndex, SparseRow>;
 
+// A frozen copy of a SparseColumnView or SparseRowView in compressed sparse
+// row (CSR) form: list i is entries_[offsets_[i]] .. entries_[offsets_[i+1]-1].
+// It takes NNZ + |lists| + 1 integers in two allocations, instead of one heap
+// allocation per list, so that scanning consecutive lists scans memory
+// linearly. view[i] can be iterated over, has a size() and can be indexed
+// by EntryIndex, just like the lists of the nested views.
+template <typename ListIndex, typename EntryIndex, typename Value>
+class FlatSparseView {
+ public:
+  class List {
+   public:
+    List(const Value* begin, const Value* end) : begin_(begin), end_(end) {}
+    const Value* begin() const { return begin_; }
+    const Value* end() const { return end_; }
+    BaseInt size() const { return static_cast<BaseInt>(end_ - begin_); }
+    bool empty() const { return begin_ == end_; }
+    const Value& operator[](EntryIndex entry) const {
+      DCHECK_LT(entry.value(), size());
+      return begin_[entry.value()];
+    }
+    util_intops::StrongIntRange<EntryIndex> index_range() const {
+      return util_intops::StrongIntRange<EntryIndex>(EntryIndex(size()));
+    }
+
+   private:
+    const Value* begin_;
+    const Value* end_;
+  };
+
+  // Iterates over the lists, as range-for over a StrongVector does.
+  class Iterator {
+   public:
+    Iterator(const FlatSparseView* view, ListIndex index)
+        : view_(view), index_(index) {}
+    List operator*() const { return (*view_)[index_]; }
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    const FlatSparseView* view_;
+    ListIndex index_;
+  };
+
+  FlatSparseView() : offsets_(1, 0) {}
+
+  // Copies a StrongVector of StrongVectors, e.g. a SparseColumnView.
+  template <typename NestedView>
+  explicit FlatSparseView(const NestedView& lists) {
+    offsets_.reserve(lists.size() + 1);
+    offsets_.push_back(0);
+    for (const auto& list : lists) {
+      offsets_.push_back(offsets_.back() + list.size());
+    }
+    entries_.reserve(offsets_.back());
+    for (const auto& list : lists) {
+      entries_.insert(entries_.end(), list.begin(), list.end());
+    }
+  }
+
+  List operator[](ListIndex index) const {
+    DCHECK_LT(index.value(), size());
+    const Value* data = entries_.data();
+    return List(data + offsets_[index.value()],
+                data + offsets_[index.value() + 1]);
+  }
+
+  BaseInt size() const { return static_cast<BaseInt>(offsets_.size() - 1); }
+  bool empty() const { return size() == 0; }
+  Iterator begin() const { return Iterator(this, ListIndex(0)); }
+  Iterator end() const { return Iterator(this, ListIndex(size())); }
+
+  int64_t num_entries() const { return entries_.size(); }
+
+  // Returns the number of entries in the lists before index.
+  int64_t num_entries_before(ListIndex index) const {
+    return offsets_[index.value()];
+  }
+
+  // Number of bytes held by the view.
+  int64_t MemoryUsage() const {
+    return offsets_.capacity() * sizeof(int64_t) +
+           entries_.capacity() * sizeof(Value);
+  }
+
+ private:
+  // The value is an int64_t because there can be more than 1 << 31 entries.
+  std::vector<int64_t> offsets_;
+  std::vector<Value> entries_;
+};
+
+// A frozen copy of a view whose lists are sorted, stored as the gaps between
+// consecutive entries in a variable-length base-128 encoding (the encoding
+// measured by SetCoverModel::ComputeColumnDeltaSizeStats()). The first gap is
+// the first entry itself. Lists can only be scanned front to back, but most
+// entries take one or two bytes instead of sizeof(BaseInt).
+template <typename ListIndex, typename Value>
+class DeltaEncodedSparseView {
+ public:
+  class List {
+   public:
+    class Iterator {
+     public:
+      Iterator(const uint8_t* pos, const uint8_t* end)
+          : pos_(pos), next_(pos), end_(end), value_(0) {
+        Decode();
+      }
+      Value operator*() const { return Value(value_); }
+      Iterator& operator++() {
+        pos_ = next_;
+        Decode();
+        return *this;
+      }
+      bool operator==(const Iterator& other) const {
+        return pos_ == other.pos_;
+      }
+      bool operator!=(const Iterator& other) const {
+        return !(*this == other);
+      }
+
+     private:
+      void Decode() {
+        if (next_ == end_) return;
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+          byte = *next_++;
+          delta |= static_cast<uint32_t>(byte & 0x7f) << shift;
+          shift += 7;
+        } while (byte & 0x80);
+        value_ += static_cast<BaseInt>(delta);
+      }
+
+      const uint8_t* pos_;   // First byte of the current entry.
+      const uint8_t* next_;  // First byte of the next entry.
+      const uint8_t* end_;
+      BaseInt value_;
+    };
+
+    List(const uint8_t* begin, const uint8_t* end, BaseInt size)
+        : begin_(begin), end_(end), size_(size) {}
+    Iterator begin() const { return Iterator(begin_, end_); }
+    Iterator end() const { return Iterator(end_, end_); }
+    BaseInt size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+   private:
+    const uint8_t* begin_;
+    const uint8_t* end_;
+    BaseInt size_;
+  };
+
+  DeltaEncodedSparseView() : offsets_(1, 0) {}
+
+  // Encodes a StrongVector of sorted StrongVectors, e.g. a SparseColumnView
+  // after SetCoverModel::SortElementsInSubsets().
+  template <typename NestedView>
+  explicit DeltaEncodedSparseView(const NestedView& lists) {
+    offsets_.reserve(lists.size() + 1);
+    offsets_.push_back(0);
+    sizes_.reserve(lists.size());
+    for (const auto& list : lists) {
+      BaseInt previous = 0;
+      for (const auto entry : list) {
+        DCHECK_GE(entry.value(), previous);
+        uint32_t delta = static_cast<uint32_t>(entry.value() - previous);
+        previous = entry.value();
+        while (delta >= 0x80) {
+          bytes_.push_back(static_cast<uint8_t>(delta | 0x80));
+          delta >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(delta));
+      }
+      offsets_.push_back(bytes_.size());
+      sizes_.push_back(static_cast<BaseInt>(list.size()));
+    }
+    bytes_.shrink_to_fit();
+  }
+
+  List operator[](ListIndex index) const {
+    DCHECK_LT(index.value(), size());
+    const uint8_t* data = bytes_.data();
+    return List(data + offsets_[index.value()],
+                data + offsets_[index.value() + 1], sizes_[index.value()]);
+  }
+
+  BaseInt size() const { return static_cast<BaseInt>(sizes_.size()); }
+  bool empty() const { return sizes_.empty(); }
+
+  // Number of bytes held by the view.
+  int64_t MemoryUsage() const {
+    return offsets_.capacity() * sizeof(int64_t) +
+           sizes_.capacity() * sizeof(BaseInt) + bytes_.capacity();
+  }
+
+ private:
+  std::vector<int64_t> offsets_;  // In bytes.
+  std::vector<BaseInt> sizes_;    // In entries.
+  std::vector<uint8_t> bytes_;
+};
+
+using FlatColumnView =
+    FlatSparseView<SubsetIndex, ColumnEntryIndex, ElementIndex>;
+using FlatRowView = FlatSparseView<ElementIndex, RowEntryIndex, SubsetIndex>;
+using CompressedColumnView = DeltaEncodedSparseView<SubsetIndex, ElementIndex>;
+
 using SubsetBoolVector = util_intops::StrongVector<SubsetIndex, bool>;
 using ElementBoolVector = util_intops::StrongVector<ElementIndex, bool>;
 
@@ -110,6 +323,9 @@ class SetCoverModel {
         num_nonzeros_(0),
         row_view_is_valid_(false),
         elements_in_subsets_are_sorted_(false),
+        flat_views_are_valid_(false),
+        compressed_column_view_is_valid_(false),
+        nested_views_are_released_(false),
         subset_costs_(),
         columns_(),
         rows_(),
@@ -141,7 +357,12 @@ class SetCoverModel {
 
   // Returns true if the model is empty, i.e. has no elements, no subsets, and
   // no nonzeros.
-  bool IsEmpty() const { return rows_.empty() || columns_.empty(); }
+  bool IsEmpty() const {
+    if (nested_views_are_released_) {
+      return num_elements_ == 0 || num_subsets_ == 0;
+    }
+    return rows_.empty() || columns_.empty();
+  }
 
   // Current number of elements to be covered in the model, i.e. the number of
   // elements in S. In matrix terms, this is the number of rows.
@@ -162,10 +383,14 @@ class SetCoverModel {
   const SubsetCostVector& subset_costs() const { return subset_costs_; }
 
   // Column view of the set covering problem.
-  const SparseColumnView& columns() const { return columns_; }
+  const SparseColumnView& columns() const {
+    CheckNestedViewsAreNotReleased();
+    return columns_;
+  }
 
   // Row view of the set covering problem.
   const SparseRowView& rows() const {
+    CheckNestedViewsAreNotReleased();
     DCHECK(row_view_is_valid_);
     return rows_;
   }
@@ -173,6 +398,37 @@ class SetCoverModel {
   // Returns true if rows_ and columns_ represent the same problem.
   bool row_view_is_valid() const { return row_view_is_valid_; }
 
+  // Frozen, contiguous copies of columns() and rows(), built by
+  // CreateFlatViews(). The heuristics iterate on these.
+  // These CHECK-fail if the flat views are not up-to-date, since reading stale
+  // views would silently solve another problem.
+  const FlatColumnView& flat_columns() const {
+    CHECK(flat_views_are_valid_);
+    return flat_columns_;
+  }
+  const FlatRowView& flat_rows() const {
+    CHECK(flat_views_are_valid_);
+    return flat_rows_;
+  }
+
+  // Returns true if the flat views represent the current problem.
+  bool flat_views_are_valid() const { return flat_views_are_valid_; }
+
+  // Returns true if ReleaseNestedViews() was called, i.e. if only the flat
+  // views are left.
+  bool nested_views_are_released() const { return nested_views_are_released_; }
+
+  // Delta/varint-encoded copy of columns(), built on request by
+  // CreateCompressedColumnView().
+  const CompressedColumnView& compressed_columns() const {
+    CHECK(compressed_column_view_is_valid_);
+    return compressed_columns_;
+  }
+
+  bool compressed_column_view_is_valid() const {
+    return compressed_column_view_is_valid_;
+  }
+
   // Access to the ranges of subsets and elements.
   util_intops::StrongIntRange<SubsetIndex> SubsetRange() const {
     return util_intops::StrongIntRange<SubsetIndex>(SubsetIndex(num_subsets_));
@@ -213,10 +469,34 @@ class SetCoverModel {
   // the elements in each subset.
   void CreateSparseRowView();
 
+  // Creates the row view if needed, then the flat views of the columns and
+  // rows. Any later change to the model invalidates them.
+  void CreateFlatViews();
+
+  // Creates the flat views if needed, then frees columns() and rows(), which
+  // take about the same memory as the flat views. This is meant for models
+  // that are only used through SetCoverInvariant and the heuristics of
+  // set_cover_heuristics.h once built. Afterwards, the model cannot be
+  // modified, and columns(), rows() and the functions that read them
+  // (ExportModelAsProto(), the statistics, ...) CHECK-fail, except
+  // ComputeFeasibility() and ExtractSubModel() which read the flat column view
+  // instead. ImportModelFromProto() makes the model usable again.
+  void ReleaseNestedViews();
+
+  // Creates the delta/varint-encoded column view, meant for read-only scans
+  // over all the columns. On sparse instances most entries take one or two
+  // bytes instead of four. Sorts the columns if needed.
+  void CreateCompressedColumnView();
+
   // Returns true if the problem is feasible, i.e. if the subsets cover all
   // the elements.
   bool ComputeFeasibility() const;
 
+  // Returns the model restricted to the given subsets. Subset i of the result
+  // is subsets[i]. The elements keep their indices, so the result has the same
+  // number of elements even if some of them are not covered anymore.
+  SetCoverModel ExtractSubModel(absl::Span<const SubsetIndex> subsets) const;
+
   // Reserves num_subsets columns in the model.
   void ReserveNumSubsets(BaseInt num_subsets);
   void ReserveNumSubsets(SubsetIndex num_subsets);
@@ -269,8 +549,8 @@ class SetCoverModel {
   // Computes basic statistics on the deltas of the row and column elements and
   // returns a Stats structure. The deltas are computed as the difference
   // between two consecutive indices in rows or columns. The number of bytes
-  // computed is meant using a variable-length base-128 encoding.
-  // TODO(user): actually use this to compress the rows and columns.
+  // computed is meant using a variable-length base-128 encoding, i.e. the one
+  // used by CompressedColumnView.
   Stats ComputeRowDeltaSizeStats() const;
   Stats ComputeColumnDeltaSizeStats() const;
 
@@ -279,6 +559,15 @@ class SetCoverModel {
   // columns.size() - 1
   void UpdateAllSubsetsList();
 
+  // Marks the row view and the frozen views as out of date.
+  void InvalidateViews();
+
+  // CHECK-fails if ReleaseNestedViews() was called.
+  void CheckNestedViewsAreNotReleased() const {
+    CHECK(!nested_views_are_released_)
+        << "The nested views of the model were released.";
+  }
+
   // Number of elements.
   BaseInt num_elements_;
 
@@ -295,6 +584,15 @@ class SetCoverModel {
   // True when the elements in each subset are sorted.
   bool elements_in_subsets_are_sorted_;
 
+  // True when flat_columns_ and flat_rows_ are up-to-date.
+  bool flat_views_are_valid_;
+
+  // True when compressed_columns_ is up-to-date.
+  bool compressed_column_view_is_valid_;
+
+  // True when columns_ and rows_ were freed by ReleaseNestedViews().
+  bool nested_views_are_released_;
+
   // Costs for each subset.
   SubsetCostVector subset_costs_;
 
@@ -304,8 +602,9 @@ class SetCoverModel {
   // On classical benchmarks, the fill rate is in the 2 to 5% range.
   // Some synthetic benchmarks have fill rates of 20%, while benchmarks for
   // rail rotations have a fill rate of 0.2 to 0.4%.
-  // TODO(user): try using a compressed representation like VarInt or LEB128,
-  // since the data is only iterated upon.
+  // This is the representation the model is built in; flat_columns_ and
+  // compressed_columns_ are frozen copies of it. It is empty after
+  // ReleaseNestedViews().
   SparseColumnView columns_;
 
   // Vector of rows. Each row corresponds to an element and contains the
@@ -313,6 +612,15 @@ class SetCoverModel {
   // The size is exactly the same as for columns_.
   SparseRowView rows_;
 
+  // CSR copies of columns_ and rows_. Each takes NNZ + |S| (resp. |E|)
+  // integers in two allocations.
+  FlatColumnView flat_columns_;
+  FlatRowView flat_rows_;
+
+  // Delta/varint-encoded copy of columns_. Entries take 1 to 5 bytes,
+  // mostly 1 or 2 on sparse instances.
+  CompressedColumnView compressed_columns_;
+
   // Vector of indices from 0 to columns.size() - 1. (Like std::iota, but built
   // incrementally.) Used to (un)focus optimization algorithms on the complete
   // problem.
@@ -328,7 +636,7 @@ class SetCoverModel {
 // allows a speedup in getting the intersecting subsets
 // by not storing them in memory.
 // The iterator is at the end when the last intersecting subset has been
-// returned.
+// returned. It reads the flat views, which must be up-to-date.
 // TODO(user): Add the possibility for range-for loops.
 class IntersectingSubsetsIterator {
  public:
@@ -339,15 +647,15 @@ class IntersectingSubsetsIterator {
         subset_entry_(0),
         seed_subset_(seed_subset),
         model_(model),
-        subset_seen_(model_.columns().size(), false) {
-    CHECK(model_.row_view_is_valid());
+        subset_seen_(model_.num_subsets(), false) {
+    CHECK(model_.flat_views_are_valid());
     subset_seen_[seed_subset] = true;  // Avoid iterating on `seed_subset`.
     ++(*this);                         // Move to the first intersecting subset.
   }
 
   // Returns (true) whether the iterator is at the end.
   bool at_end() const {
-    return element_entry_.value() == model_.columns()[seed_subset_].size();
+    return element_entry_.value() == model_.flat_columns()[seed_subset_].size();
   }
 
   // Returns the intersecting subset.
@@ -355,13 +663,12 @@ class IntersectingSubsetsIterator {
 
   // Move the iterator to the next intersecting subset.
   IntersectingSubsetsIterator& operator++() {
-    DCHECK(model_.row_view_is_valid());
     DCHECK(!at_end());
-    const SparseRowView& rows = model_.rows();
-    const SparseColumn& column = model_.columns()[seed_subset_];
+    const FlatRowView& rows = model_.flat_rows();
+    const FlatColumnView::List column = model_.flat_columns()[seed_subset_];
     for (; element_entry_ < ColumnEntryIndex(column.size()); ++element_entry_) {
       const ElementIndex current_element = column[element_entry_];
-      const SparseRow& current_row = rows[current_element];
+      const FlatRowView::List current_row = rows[current_element];
       for (; subset_entry_ < RowEntryIndex(current_row.size());
            ++subset_entry_) {
         intersecting_subset_ = current_row[subset_entry_];
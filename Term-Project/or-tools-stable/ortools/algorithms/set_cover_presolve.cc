@@ -0,0 +1,349 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/algorithms/set_cover_presolve.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "ortools/algorithms/set_cover_model.h"
+#include "ortools/base/hash.h"
+#include "ortools/base/logging.h"
+
+namespace operations_research {
+
+namespace {
+// Returns a hash of the sorted list, which is a StrongVector of StrongInts.
+template <typename List>
+uint64_t HashList(const List& list) {
+  return fasthash64(list.data(), list.size() * sizeof(*list.data()),
+                    list.size());
+}
+
+// Returns a 64-bit signature of the list, with one bit set per entry. If list
+// a is included in list b, Signature(a) & ~Signature(b) is zero, which rules
+// out most of the candidate inclusions without scanning the lists.
+template <typename List>
+uint64_t Signature(const List& list) {
+  uint64_t signature = 0;
+  for (const auto entry : list) {
+    signature |= uint64_t{1} << (entry.value() & 63);
+  }
+  return signature;
+}
+
+// Sorts the (hash, index) pairs and calls process(begin, end) on each run of
+// entries with the same hash.
+template <typename Index, typename ProcessRun>
+void ForEachRunOfEqualHashes(std::vector<std::pair<uint64_t, Index>>* hashes,
+                             ProcessRun process) {
+  std::sort(hashes->begin(), hashes->end());
+  for (size_t begin = 0; begin < hashes->size();) {
+    size_t end = begin + 1;
+    while (end < hashes->size() &&
+           (*hashes)[end].first == (*hashes)[begin].first) {
+      ++end;
+    }
+    if (end - begin > 1) process(begin, end);
+    begin = end;
+  }
+}
+}  // namespace
+
+SetCoverPresolver::SetCoverPresolver(const SetCoverModel& model)
+    : model_(model),
+      is_live_subset_(model.num_subsets(), true),
+      is_live_element_(model.num_elements(), true),
+      columns_(model.columns()),
+      rows_(model.num_elements()),
+      subset_stamps_(model.num_subsets(), 0),
+      element_stamps_(model.num_elements(), 0) {
+  // The inclusion tests and the hashes need sorted columns, and Compact
+  // keeps the rows sorted by building them in the order of the subsets.
+  for (SparseColumn& column : columns_) {
+    std::sort(column.begin(), column.end());
+  }
+}
+
+void SetCoverPresolver::Compact() {
+  for (SparseRow& row : rows_) {
+    row.clear();
+  }
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    SparseColumn& column = columns_[subset];
+    if (!is_live_subset_[subset]) {
+      column.clear();
+      continue;
+    }
+    ColumnEntryIndex w(0);  // Write index.
+    for (const ElementIndex element : column) {
+      if (is_live_element_[element]) {
+        column[w] = element;
+        ++w;
+        rows_[element].push_back(subset);
+      }
+    }
+    column.resize(w.value());
+  }
+}
+
+void SetCoverPresolver::RemoveSubset(SubsetIndex subset, bool forced) {
+  DCHECK(is_live_subset_[subset]);
+  is_live_subset_[subset] = false;
+  ++num_removed_subsets_;
+  if (!forced) return;
+  forced_subsets_.push_back(subset);
+  fixed_cost_ += model_.subset_costs()[subset];
+  for (const ElementIndex element : columns_[subset]) {
+    if (is_live_element_[element]) {
+      RemoveElement(element);
+    }
+  }
+}
+
+void SetCoverPresolver::RemoveElement(ElementIndex element) {
+  DCHECK(is_live_element_[element]);
+  is_live_element_[element] = false;
+  ++num_removed_elements_;
+}
+
+bool SetCoverPresolver::ForceSingletons(bool* changed) {
+  for (const ElementIndex element : model_.ElementRange()) {
+    if (!is_live_element_[element]) continue;
+    // The subsets forced earlier in the loop are not in the row, since they
+    // would have covered element.
+    const SparseRow& row = rows_[element];
+    if (row.empty()) {
+      VLOG(1) << "Element " << element << " cannot be covered.";
+      return false;
+    }
+    if (row.size() == 1) {
+      RemoveSubset(row[RowEntryIndex(0)], /*forced=*/true);
+      *changed = true;
+    }
+  }
+  return true;
+}
+
+bool SetCoverPresolver::RemoveDominatedElements() {
+  // No subset is removed during this pass, so all the entries of the rows are
+  // live.
+  const BaseInt num_removed_before = num_removed_elements_;
+  // Identical rows: all but one are removed.
+  std::vector<std::pair<uint64_t, ElementIndex>> hashes;
+  for (const ElementIndex element : model_.ElementRange()) {
+    if (is_live_element_[element]) {
+      hashes.push_back({HashList(rows_[element]), element});
+    }
+  }
+  ForEachRunOfEqualHashes(&hashes, [this, &hashes](size_t begin, size_t end) {
+    const SparseRow& kept_row = rows_[hashes[begin].second];
+    for (size_t i = begin + 1; i < end; ++i) {
+      const ElementIndex element = hashes[i].second;
+      if (rows_[element] == kept_row) {
+        RemoveElement(element);
+      }
+    }
+  });
+  // Strict inclusions. Every element e2 whose row contains the row of e1
+  // also appears in the shortest column of the subsets covering e1.
+  std::vector<uint64_t> signatures(model_.num_elements(), 0);
+  for (const ElementIndex element : model_.ElementRange()) {
+    if (is_live_element_[element]) {
+      signatures[element.value()] = Signature(rows_[element]);
+    }
+  }
+  int64_t work = 0;
+  for (const ElementIndex e1 : model_.ElementRange()) {
+    if (!is_live_element_[e1]) continue;
+    if (work > kWorkLimit) {
+      VLOG(1) << "Work limit reached while removing dominated elements.";
+      break;
+    }
+    const SparseRow& row1 = rows_[e1];
+    ++stamp_;
+    SubsetIndex shortest = row1[RowEntryIndex(0)];
+    for (const SubsetIndex subset : row1) {
+      subset_stamps_[subset] = stamp_;
+      if (columns_[subset].size() < columns_[shortest].size()) {
+        shortest = subset;
+      }
+    }
+    work += columns_[shortest].size();
+    for (const ElementIndex e2 : columns_[shortest]) {
+      if (e2 == e1 || (signatures[e1.value()] & ~signatures[e2.value()]) ||
+          !is_live_element_[e2] || rows_[e2].size() < row1.size()) {
+        continue;
+      }
+      BaseInt num_common = 0;
+      for (const SubsetIndex subset : rows_[e2]) {
+        num_common += subset_stamps_[subset] == stamp_;
+      }
+      work += rows_[e2].size();
+      if (num_common == static_cast<BaseInt>(row1.size())) {
+        RemoveElement(e2);
+      }
+    }
+  }
+  return num_removed_elements_ > num_removed_before;
+}
+
+bool SetCoverPresolver::RemoveDominatedSubsets() {
+  // No element is removed during this pass, so all the entries of the
+  // columns are live.
+  const BaseInt num_removed_before = num_removed_subsets_;
+  const SubsetCostVector& costs = model_.subset_costs();
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (is_live_subset_[subset] && columns_[subset].empty()) {
+      RemoveSubset(subset, /*forced=*/false);
+    }
+  }
+  // Identical columns: only the cheapest one is kept.
+  std::vector<std::pair<uint64_t, SubsetIndex>> hashes;
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (is_live_subset_[subset]) {
+      hashes.push_back({HashList(columns_[subset]), subset});
+    }
+  }
+  ForEachRunOfEqualHashes(
+      &hashes, [this, &hashes, &costs](size_t begin, size_t end) {
+        std::sort(hashes.begin() + begin, hashes.begin() + end,
+                  [&costs](const auto& a, const auto& b) {
+                    return std::tie(costs[a.second], a.second) <
+                           std::tie(costs[b.second], b.second);
+                  });
+        const SparseColumn& kept_column = columns_[hashes[begin].second];
+        for (size_t i = begin + 1; i < end; ++i) {
+          const SubsetIndex subset = hashes[i].second;
+          if (columns_[subset] == kept_column) {
+            RemoveSubset(subset, /*forced=*/false);
+          }
+        }
+      });
+  // Strict inclusions. Every subset s2 whose column contains the column of s1
+  // appears in the shortest row of the elements of s1.
+  std::vector<uint64_t> signatures(model_.num_subsets(), 0);
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (is_live_subset_[subset]) {
+      signatures[subset.value()] = Signature(columns_[subset]);
+    }
+  }
+  int64_t work = 0;
+  for (const SubsetIndex s1 : model_.SubsetRange()) {
+    if (!is_live_subset_[s1]) continue;
+    if (work > kWorkLimit) {
+      VLOG(1) << "Work limit reached while removing dominated subsets.";
+      break;
+    }
+    const SparseColumn& column1 = columns_[s1];
+    ++stamp_;
+    ElementIndex shortest = column1[ColumnEntryIndex(0)];
+    for (const ElementIndex element : column1) {
+      element_stamps_[element] = stamp_;
+      if (rows_[element].size() < rows_[shortest].size()) {
+        shortest = element;
+      }
+    }
+    work += rows_[shortest].size();
+    for (const SubsetIndex s2 : rows_[shortest]) {
+      if (s2 == s1 || (signatures[s1.value()] & ~signatures[s2.value()]) ||
+          costs[s2] > costs[s1] || !is_live_subset_[s2] ||
+          columns_[s2].size() < column1.size()) {
+        continue;
+      }
+      BaseInt num_common = 0;
+      for (const ElementIndex element : columns_[s2]) {
+        num_common += element_stamps_[element] == stamp_;
+      }
+      work += columns_[s2].size();
+      if (num_common == static_cast<BaseInt>(column1.size())) {
+        RemoveSubset(s1, /*forced=*/false);
+        break;
+      }
+    }
+  }
+  return num_removed_subsets_ > num_removed_before;
+}
+
+bool SetCoverPresolver::Presolve() {
+  bool changed = true;
+  while (changed) {
+    ++num_rounds_;
+    changed = false;
+    Compact();
+    if (!ForceSingletons(&changed)) {
+      reduced_model_ = SetCoverModel();
+      return false;
+    }
+    if (changed) Compact();
+    if (RemoveDominatedElements()) {
+      changed = true;
+      Compact();
+    }
+    changed |= RemoveDominatedSubsets();
+  }
+  BuildReducedModel();
+  VLOG(1) << "Presolve removed " << num_removed_subsets_ << " subsets out of "
+          << model_.num_subsets() << " (" << forced_subsets_.size()
+          << " forced, for a cost of " << fixed_cost_ << ") and "
+          << num_removed_elements_ << " elements out of "
+          << model_.num_elements() << " in " << num_rounds_ << " rounds.";
+  return true;
+}
+
+void SetCoverPresolver::BuildReducedModel() {
+  // The last round did not remove anything, so the lists are compact.
+  ElementToIntVector new_index(model_.num_elements(), -1);
+  for (const ElementIndex element : model_.ElementRange()) {
+    if (is_live_element_[element]) {
+      new_index[element] = original_elements_.size();
+      original_elements_.push_back(element);
+    }
+  }
+  reduced_model_ = SetCoverModel();
+  for (const SubsetIndex subset : model_.SubsetRange()) {
+    if (!is_live_subset_[subset]) continue;
+    original_subsets_.push_back(subset);
+    reduced_model_.AddEmptySubset(model_.subset_costs()[subset]);
+    reduced_model_.ReserveNumElementsInSubset(columns_[subset].size(),
+                                              reduced_model_.num_subsets() - 1);
+    for (const ElementIndex element : columns_[subset]) {
+      reduced_model_.AddElementToLastSubset(new_index[element]);
+    }
+  }
+  DCHECK_EQ(reduced_model_.num_elements(), original_elements_.size());
+  reduced_model_.CreateSparseRowView();
+}
+
+SubsetBoolVector SetCoverPresolver::Postsolve(
+    const SubsetBoolVector& reduced_solution) const {
+  DCHECK_EQ(reduced_solution.size(), original_subsets_.size());
+  SubsetBoolVector solution(model_.num_subsets(), false);
+  for (const SubsetIndex subset : forced_subsets_) {
+    solution[subset] = true;
+  }
+  for (BaseInt i = 0; i < static_cast<BaseInt>(original_subsets_.size());
+       ++i) {
+    if (reduced_solution[SubsetIndex(i)]) {
+      solution[original_subsets_[i]] = true;
+    }
+  }
+  return solution;
+}
+
+}  // namespace operations_research
@@ -0,0 +1,150 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OR_TOOLS_ALGORITHMS_SET_COVER_PRESOLVE_H_
+#define OR_TOOLS_ALGORITHMS_SET_COVER_PRESOLVE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "ortools/algorithms/set_cover_model.h"
+
+namespace operations_research {
+
+// Reduces a set covering problem before it is handed to the heuristics, the
+// MIP or the Lagrangian. The following reductions are applied in turn, until
+// none of them applies anymore:
+// - Singleton forcing: a subset that is the only one to cover some element is
+//   in every solution. It is fixed, and the elements it covers are removed.
+// - Element (row) dominance: if every subset covering element e1 also covers
+//   e2, covering e1 implies covering e2, so e2 is removed.
+// - Subset (column) dominance: if subset s2 covers all the remaining elements
+//   of s1 at no higher cost, s1 can be replaced by s2 in any solution, so s1
+//   is removed. Subsets left without elements are removed too.
+// Identical rows and columns are first found by hashing them, which is linear
+// in the number of nonzeros. The search for strict inclusions is bounded by
+// a work limit per pass.
+//
+// The costs are expected to be non-negative, as in the rest of the module.
+//
+// Usage:
+//   SetCoverPresolver presolver(model);
+//   if (!presolver.Presolve()) { ... the problem is infeasible ... }
+//   SetCoverInvariant inv(presolver.reduced_model());
+//   ... solve inv ...
+//   SubsetBoolVector solution = presolver.Postsolve(inv.is_selected());
+class SetCoverPresolver {
+ public:
+  // The model must outlive the presolver, and may not change in between.
+  explicit SetCoverPresolver(const SetCoverModel& model);
+
+  // Applies the reductions until a fixpoint is reached, and builds the
+  // reduced model. Returns false if some element cannot be covered, in which
+  // case the reduced model is left empty.
+  bool Presolve();
+
+  // The reduced model, whose subsets and elements are renumbered from 0.
+  // It is empty when all the elements are covered by the forced subsets.
+  SetCoverModel* reduced_model() { return &reduced_model_; }
+
+  // Returns a solution to the original model from a solution to the reduced
+  // one: the forced subsets plus the selected subsets, in original indices.
+  // It covers all the elements if reduced_solution covers the reduced model,
+  // and it has the same cost plus fixed_cost().
+  SubsetBoolVector Postsolve(const SubsetBoolVector& reduced_solution) const;
+
+  // The original index of each subset of the reduced model.
+  const std::vector<SubsetIndex>& original_subsets() const {
+    return original_subsets_;
+  }
+
+  // The original index of each element of the reduced model.
+  const std::vector<ElementIndex>& original_elements() const {
+    return original_elements_;
+  }
+
+  // The subsets fixed in every solution, in original indices.
+  const std::vector<SubsetIndex>& forced_subsets() const {
+    return forced_subsets_;
+  }
+
+  // The total cost of the forced subsets.
+  Cost fixed_cost() const { return fixed_cost_; }
+
+  // Statistics on the reductions.
+  BaseInt num_removed_subsets() const { return num_removed_subsets_; }
+  BaseInt num_removed_elements() const { return num_removed_elements_; }
+  int num_rounds() const { return num_rounds_; }
+
+ private:
+  // Maximum number of candidates and list entries scanned by each dominance
+  // pass.
+  static constexpr int64_t kWorkLimit = int64_t{1} << 25;
+
+  // Rebuilds columns_ and rows_ from the live subsets and elements.
+  void Compact();
+
+  // Fixes the subsets that are the only cover of some element. Returns false
+  // if an element has no cover left. Sets *changed if anything was fixed.
+  bool ForceSingletons(bool* changed);
+
+  // Removes the elements whose row contains another row. Returns true if
+  // anything was removed.
+  bool RemoveDominatedElements();
+
+  // Removes the subsets whose column is contained in a column of no higher
+  // cost, and the empty ones. Returns true if anything was removed.
+  bool RemoveDominatedSubsets();
+
+  // Removes subset, and the elements it covers if forced is true.
+  void RemoveSubset(SubsetIndex subset, bool forced);
+
+  // Removes element.
+  void RemoveElement(ElementIndex element);
+
+  // Builds reduced_model_ and the index maps from the live subsets and
+  // elements.
+  void BuildReducedModel();
+
+  const SetCoverModel& model_;
+
+  // Whether each subset or element is still in the problem.
+  SubsetBoolVector is_live_subset_;
+  ElementBoolVector is_live_element_;
+
+  // The live elements of each live subset, and the live subsets covering each
+  // live element, as of the last call to Compact. Entries may have been
+  // removed since, which is checked with is_live_subset_ and
+  // is_live_element_.
+  SparseColumnView columns_;
+  SparseRowView rows_;
+
+  // Stamps used to test inclusions of lists in O(size of the lists).
+  SubsetToIntVector subset_stamps_;
+  ElementToIntVector element_stamps_;
+  BaseInt stamp_ = 0;
+
+  SetCoverModel reduced_model_;
+  std::vector<SubsetIndex> original_subsets_;
+  std::vector<ElementIndex> original_elements_;
+  std::vector<SubsetIndex> forced_subsets_;
+  Cost fixed_cost_ = 0.0;
+
+  BaseInt num_removed_subsets_ = 0;
+  BaseInt num_removed_elements_ = 0;
+  int num_rounds_ = 0;
+};
+
+}  // namespace operations_research
+
+#endif  // OR_TOOLS_ALGORITHMS_SET_COVER_PRESOLVE_H_
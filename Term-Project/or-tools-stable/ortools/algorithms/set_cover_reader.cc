@@ -13,84 +13,211 @@
 
 #include "ortools/algorithms/set_cover_reader.h"
 
+#include <sys/stat.h>
 #include <sys/types.h>
+#if !defined(_MSC_VER)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-#include <cctype>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/log/check.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "ortools/algorithms/set_cover.pb.h"
 #include "ortools/algorithms/set_cover_model.h"
 #include "ortools/base/file.h"
 #include "ortools/base/helpers.h"
 #include "ortools/base/logging.h"
 #include "ortools/base/options.h"
-#include "ortools/util/filelineiter.h"
+#include "ortools/base/threadpool.h"
+#include "zlib.h"
 
 namespace operations_research {
 
+namespace {
+// The contents of a file, memory-mapped when possible, and read in one go
+// otherwise. Files compressed with gzip, recognized by their magic number, are
+// inflated into memory block by block.
+class FileContents {
+ public:
+  explicit FileContents(absl::string_view filename);
+  ~FileContents();
+
+  // This type is neither copyable nor movable.
+  FileContents(const FileContents&) = delete;
+  FileContents& operator=(const FileContents&) = delete;
+
+  absl::string_view data() const { return data_; }
+
+ private:
+  // Maps the file in memory. Returns false if this is not possible.
+  bool Map(absl::string_view filename);
+  void Unmap();
+
+  // Inflates data_ into buffer_, and makes data_ point to the result.
+  void Inflate();
+
+  // The mapping, or nullptr if the file is held in buffer_.
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+  std::string buffer_;
+  absl::string_view data_;
+};
+
+FileContents::FileContents(absl::string_view filename) {
+  if (!Map(filename)) {
+    CHECK_OK(file::GetContents(filename, &buffer_, file::Defaults()));
+    data_ = buffer_;
+  }
+  if (data_.size() >= 2 && static_cast<unsigned char>(data_[0]) == 0x1f &&
+      static_cast<unsigned char>(data_[1]) == 0x8b) {
+    Inflate();
+  }
+}
+
+FileContents::~FileContents() { Unmap(); }
+
+#if defined(_MSC_VER)
+bool FileContents::Map(absl::string_view filename) { return false; }
+void FileContents::Unmap() {}
+#else
+bool FileContents::Map(absl::string_view filename) {
+  const int fd = open(std::string(filename).c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat info;
+  // Empty files cannot be mapped, and neither can pipes.
+  if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);  // The mapping keeps the file open.
+  if (mapping == MAP_FAILED) return false;
+  // The readers go through the file from the beginning to the end.
+  madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+  mapping_ = mapping;
+  mapping_size_ = info.st_size;
+  data_ = absl::string_view(static_cast<const char*>(mapping), mapping_size_);
+  return true;
+}
+
+void FileContents::Unmap() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+    mapping_ = nullptr;
+  }
+}
+#endif  // _MSC_VER
+
+void FileContents::Inflate() {
+  std::string inflated;
+  z_stream stream = {};
+  // 16 tells zlib to expect the gzip header and trailer.
+  CHECK_EQ(inflateInit2(&stream, /*windowBits=*/15 + 16), Z_OK);
+  // avail_in and avail_out are 32-bit, so the input is fed in blocks too.
+  constexpr size_t kBlockSize = size_t{1} << 20;
+  size_t input_pos = 0;
+  int status = Z_OK;
+  while (true) {
+    if (stream.avail_in == 0 && input_pos < data_.size()) {
+      const size_t input_size = std::min(kBlockSize, data_.size() - input_pos);
+      stream.next_in = reinterpret_cast<Bytef*>(
+          const_cast<char*>(data_.data() + input_pos));
+      stream.avail_in = input_size;
+      input_pos += input_size;
+    }
+    const size_t output_size = inflated.size();
+    inflated.resize(output_size + kBlockSize);
+    stream.next_out = reinterpret_cast<Bytef*>(inflated.data() + output_size);
+    stream.avail_out = kBlockSize;
+    status = inflate(&stream, Z_NO_FLUSH);
+    inflated.resize(output_size + kBlockSize - stream.avail_out);
+    if (status == Z_STREAM_END) {
+      // Like gzip, decompress the concatenated streams as a single one.
+      if (stream.avail_in == 0 && input_pos == data_.size()) break;
+      CHECK_EQ(inflateReset(&stream), Z_OK);
+    } else {
+      CHECK(status == Z_OK || status == Z_BUF_ERROR)
+          << "Error " << status << " while inflating: "
+          << (stream.msg == nullptr ? "" : stream.msg);
+      CHECK(stream.avail_in > 0 || input_pos < data_.size() ||
+            stream.avail_out == 0)
+          << "Truncated compressed file.";
+    }
+  }
+  inflateEnd(&stream);
+  Unmap();
+  buffer_ = std::move(inflated);
+  data_ = buffer_;
+}
+
+// Returns true for the characters std::isspace considers as blanks, without
+// going through the locale.
+inline bool IsBlank(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+}  // namespace
+
 class SetCoverReader {
  public:
-  explicit SetCoverReader(File* file);
+  explicit SetCoverReader(absl::string_view data);
   absl::string_view GetNextToken();
   double ParseNextDouble();
   int64_t ParseNextInteger();
 
+  // Returns true when only blanks are left.
+  bool AtEnd();
+
  private:
   size_t SkipBlanks(size_t pos) const;
   size_t SkipNonBlanks(size_t pos) const;
-  FileLineIterator line_iter_;
-  absl::string_view line_;
-  int start_pos_;
-  int end_pos_;
+  absl::string_view data_;
+  size_t pos_;
 };
 
-SetCoverReader::SetCoverReader(File* file)
-    : line_iter_(file, FileLineIterator::REMOVE_INLINE_CR |
-                           FileLineIterator::REMOVE_BLANK_LINES),
-      start_pos_(0),
-      end_pos_(0) {
-  line_ = *line_iter_;
-}
+SetCoverReader::SetCoverReader(absl::string_view data) : data_(data), pos_(0) {}
 
 size_t SetCoverReader::SkipBlanks(size_t pos) const {
-  const size_t size = line_.size();
+  const size_t size = data_.size();
   // As it is expected that the blanks will be spaces, we can skip them faster
   // by checking for spaces only.
-  for (; pos < size && line_[pos] == ' '; ++pos) {
+  for (; pos < size && data_[pos] == ' '; ++pos) {
   }
   // We skip all forms of blanks to be on the safe side.
-  for (; pos < size && std::isspace(line_[pos]); ++pos) {
+  for (; pos < size && IsBlank(data_[pos]); ++pos) {
   }
   return pos;
 }
 
 size_t SetCoverReader::SkipNonBlanks(size_t pos) const {
-  const size_t size = line_.size();
-  for (; pos < size && !std::isspace(line_[pos]); ++pos) {
+  const size_t size = data_.size();
+  for (; pos < size && !IsBlank(data_[pos]); ++pos) {
   }
   return pos;
 }
 
+bool SetCoverReader::AtEnd() {
+  pos_ = SkipBlanks(pos_);
+  return pos_ >= data_.size();
+}
+
 absl::string_view SetCoverReader::GetNextToken() {
-  const size_t size = line_.size();
-  start_pos_ = SkipBlanks(end_pos_);
-  if (start_pos_ >= size) {
-    ++line_iter_;
-    line_ = *line_iter_;
-    start_pos_ = SkipBlanks(0);
-  }
-  end_pos_ = SkipNonBlanks(start_pos_);
-  return line_.substr(start_pos_, end_pos_ - start_pos_);
+  const size_t start = SkipBlanks(pos_);
+  pos_ = SkipNonBlanks(start);
+  return data_.substr(start, pos_ - start);
 }
 
 double SetCoverReader::ParseNextDouble() {
@@ -99,17 +226,33 @@ double SetCoverReader::ParseNextDouble() {
   return value;
 }
 
+// Integers make up almost all of the files, so they are parsed here directly
+// instead of going through a token.
 int64_t SetCoverReader::ParseNextInteger() {
-  int64_t value = 0;
-  CHECK(absl::SimpleAtoi(GetNextToken(), &value));
-  return value;
+  const size_t size = data_.size();
+  size_t pos = SkipBlanks(pos_);
+  const size_t start = pos;
+  const bool negative = pos < size && data_[pos] == '-';
+  if (pos < size && (data_[pos] == '-' || data_[pos] == '+')) ++pos;
+  const size_t first_digit = pos;
+  uint64_t value = 0;
+  for (; pos < size; ++pos) {
+    const unsigned digit = static_cast<unsigned char>(data_[pos]) - '0';
+    if (digit > 9) break;
+    value = 10 * value + digit;
+  }
+  CHECK(pos > first_digit && pos - first_digit <= 18 &&
+        (pos == size || IsBlank(data_[pos])))
+      << "Not an integer: " << data_.substr(start, SkipNonBlanks(pos) - start);
+  pos_ = pos;
+  return negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
 }
 
 // This is a row-based format where the elements are 1-indexed.
 SetCoverModel ReadOrlibScp(absl::string_view filename) {
   SetCoverModel model;
-  File* file(file::OpenOrDie(filename, "r", file::Defaults()));
-  SetCoverReader reader(file);
+  const FileContents contents(filename);
+  SetCoverReader reader(contents.data());
   const ElementIndex num_rows(reader.ParseNextInteger());
   const SubsetIndex num_cols(reader.ParseNextInteger());
   model.ReserveNumSubsets(num_cols.value());
@@ -117,19 +260,39 @@ SetCoverModel ReadOrlibScp(absl::string_view filename) {
     const double cost(reader.ParseNextDouble());
     model.SetSubsetCost(subset.value(), cost);
   }
+  // The rows are read first, counting the size of each column, so that the
+  // columns can then be filled without any reallocation.
+  std::vector<int64_t> row_starts;
+  row_starts.reserve(num_rows.value() + 1);
+  row_starts.push_back(0);
+  std::vector<BaseInt> row_entries;
+  SubsetToIntVector column_sizes(num_cols.value(), 0);
   for (ElementIndex element : ElementRange(num_rows)) {
     LOG_EVERY_N_SEC(INFO, 5)
         << absl::StrFormat("Reading element %d (%.1f%%)", element.value(),
-                           100.0 * element.value() / model.num_elements());
+                           100.0 * element.value() / num_rows.value());
     const RowEntryIndex row_size(reader.ParseNextInteger());
     for (RowEntryIndex entry(0); entry < row_size; ++entry) {
       // Correct the 1-indexing.
-      const int subset(reader.ParseNextInteger() - 1);
-      model.AddElementToSubset(element.value(), subset);
+      const BaseInt subset(reader.ParseNextInteger() - 1);
+      CHECK(subset >= 0 && subset < num_cols.value())
+          << "Subset " << subset + 1 << " out of range for element "
+          << element.value() + 1;
+      row_entries.push_back(subset);
+      ++column_sizes[SubsetIndex(subset)];
+    }
+    row_starts.push_back(row_entries.size());
+  }
+  for (SubsetIndex subset : SubsetRange(num_cols)) {
+    model.ReserveNumElementsInSubset(column_sizes[subset], subset.value());
+  }
+  for (ElementIndex element : ElementRange(num_rows)) {
+    for (int64_t entry = row_starts[element.value()];
+         entry < row_starts[element.value() + 1]; ++entry) {
+      model.AddElementToSubset(element.value(), row_entries[entry]);
     }
   }
   LOG(INFO) << "Finished reading the model.";
-  file->Close(file::Defaults()).IgnoreError();
   model.CreateSparseRowView();
   return model;
 }
@@ -137,8 +300,8 @@ SetCoverModel ReadOrlibScp(absl::string_view filename) {
 // This is a column-based format where the elements are 1-indexed.
 SetCoverModel ReadOrlibRail(absl::string_view filename) {
   SetCoverModel model;
-  File* file(file::OpenOrDie(filename, "r", file::Defaults()));
-  SetCoverReader reader(file);
+  const FileContents contents(filename);
+  SetCoverReader reader(contents.data());
   const ElementIndex num_rows(reader.ParseNextInteger());
   const BaseInt num_cols(reader.ParseNextInteger());
   model.ReserveNumSubsets(num_cols);
@@ -157,31 +320,99 @@ SetCoverModel ReadOrlibRail(absl::string_view filename) {
     }
   }
   LOG(INFO) << "Finished reading the model.";
-  file->Close(file::Defaults()).IgnoreError();
   model.CreateSparseRowView();
   return model;
 }
 
+namespace {
+// The subsets read from a range of lines of a FIMI file, in compressed sparse
+// column form: subset i contains elements[starts[i]] to
+// elements[starts[i + 1] - 1].
+struct FimiChunk {
+  std::vector<int64_t> starts = {0};
+  std::vector<BaseInt> elements;
+};
+
+// Parses the lines in text, which ends at the end of a line. The elements are
+// 1-indexed in the file, and 0-indexed in chunk.
+void ParseFimiLines(absl::string_view text, FimiChunk* chunk) {
+  const char* const end = text.data() + text.size();
+  for (const char* line = text.data(); line < end;) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(line, '\n', end - line));
+    if (line_end == nullptr) line_end = end;
+    SetCoverReader reader(absl::string_view(line, line_end - line));
+    while (!reader.AtEnd()) {
+      const int64_t element = reader.ParseNextInteger();
+      CHECK_GT(element, 0);
+      CHECK_LE(element, std::numeric_limits<BaseInt>::max());
+      chunk->elements.push_back(element - 1);
+    }
+    chunk->starts.push_back(chunk->elements.size());
+    line = line_end + 1;
+  }
+}
+}  // namespace
+
 SetCoverModel ReadFimiDat(absl::string_view filename) {
+  return ReadFimiDat(filename, /*num_threads=*/1);
+}
+
+SetCoverModel ReadFimiDat(absl::string_view filename, int num_threads) {
+  const FileContents contents(filename);
+  const absl::string_view data = contents.data();
+  // Small files are not worth the threads.
+  constexpr size_t kMinChunkSize = size_t{1} << 20;
+  const int num_chunks = static_cast<int>(std::clamp<size_t>(
+      data.size() / kMinChunkSize, 1, std::max(num_threads, 1)));
+  // Cut the file in chunks of about the same size, at the ends of lines.
+  std::vector<size_t> chunk_starts(num_chunks + 1, data.size());
+  chunk_starts[0] = 0;
+  for (int chunk = 1; chunk < num_chunks; ++chunk) {
+    const size_t pos = std::max(chunk_starts[chunk - 1],
+                                data.size() / num_chunks * chunk);
+    const size_t line_end = data.find('\n', pos);
+    chunk_starts[chunk] =
+        line_end == absl::string_view::npos ? data.size() : line_end + 1;
+  }
+  std::vector<FimiChunk> chunks(num_chunks);
+  const auto parse_chunk = [&data, &chunk_starts, &chunks](int chunk) {
+    ParseFimiLines(data.substr(chunk_starts[chunk],
+                               chunk_starts[chunk + 1] - chunk_starts[chunk]),
+                   &chunks[chunk]);
+  };
+  if (num_chunks == 1) {
+    parse_chunk(0);
+  } else {
+    ThreadPool pool(num_chunks);
+    pool.StartWorkers();
+    absl::BlockingCounter num_chunks_running(num_chunks);
+    for (int chunk = 0; chunk < num_chunks; ++chunk) {
+      pool.Schedule([&parse_chunk, &num_chunks_running, chunk]() {
+        parse_chunk(chunk);
+        num_chunks_running.DecrementCount();
+      });
+    }
+    num_chunks_running.Wait();
+  }
   SetCoverModel model;
+  int64_t num_subsets = 0;
+  for (const FimiChunk& chunk : chunks) {
+    num_subsets += chunk.starts.size() - 1;
+  }
+  model.ReserveNumSubsets(num_subsets);
   BaseInt subset(0);
-  for (const std::string& line : FileLines(filename)) {
-    LOG_EVERY_N_SEC(INFO, 5)
-        << absl::StrFormat("Reading subset %d (%.1f%%)", subset,
-                           100.0 * subset / model.num_subsets());
-    std::vector<std::string> elements = absl::StrSplit(line, ' ');
-    if (elements.back().empty() || elements.back()[0] == '\0') {
-      elements.pop_back();
+  for (const FimiChunk& chunk : chunks) {
+    for (size_t i = 0; i + 1 < chunk.starts.size(); ++i) {
+      model.SetSubsetCost(subset, 1.0);
+      model.ReserveNumElementsInSubset(chunk.starts[i + 1] - chunk.starts[i],
+                                       subset);
+      for (int64_t entry = chunk.starts[i]; entry < chunk.starts[i + 1];
+           ++entry) {
+        model.AddElementToSubset(chunk.elements[entry], subset);
+      }
+      ++subset;
     }
-    model.AddEmptySubset(1);
-    for (const std::string& number : elements) {
-      BaseInt element;
-      CHECK(absl::SimpleAtoi(number, &element));
-      CHECK_GT(element, 0);
-      // Correct the 1-indexing.
-      model.AddElementToLastSubset(ElementIndex(element - 1));
-    }
-    ++subset;
   }
   LOG(INFO) << "Finished reading the model.";
   model.CreateSparseRowView();
@@ -300,8 +531,8 @@ void WriteSetCoverProto(const SetCoverModel& model, absl::string_view filename,
 
 SubsetBoolVector ReadSetCoverSolutionText(absl::string_view filename) {
   SubsetBoolVector solution;
-  File* file(file::OpenOrDie(filename, "r", file::Defaults()));
-  SetCoverReader reader(file);
+  const FileContents contents(filename);
+  SetCoverReader reader(contents.data());
   const BaseInt num_cols(reader.ParseNextInteger());
   solution.resize(num_cols, false);
   const BaseInt cardinality(reader.ParseNextInteger());
@@ -310,7 +541,6 @@ SubsetBoolVector ReadSetCoverSolutionText(absl::string_view filename) {
     const SubsetIndex subset(reader.ParseNextInteger());
     solution[subset] = true;
   }
-  file->Close(file::Defaults()).IgnoreError();
   return solution;
 }
 
@@ -29,6 +29,10 @@ namespace operations_research {
 // Also, note that the indices in the files, when mentioned, start from 1, while
 // SetCoverModel starts from 0, The translation is done at read time.
 
+// The text readers map the file in memory when the platform allows it, and
+// read it in one go otherwise. Files compressed with gzip are recognized by
+// their header, whatever their name, and inflated on the fly.
+
 // Reads a rail set cover problem create by Beasley and returns a SetCoverModel.
 // The format of all of these 80 data files is:
 // number of rows (m), number of columns (n)
@@ -57,6 +61,10 @@ SetCoverModel ReadOrlibRail(absl::string_view filename);
 // The cost of each subset is 1.
 SetCoverModel ReadFimiDat(absl::string_view filename);
 
+// Same as above, with the file cut in up to num_threads chunks of lines that
+// are parsed in parallel. Only files of a few megabytes or more are cut.
+SetCoverModel ReadFimiDat(absl::string_view filename, int num_threads);
+
 // Reads a set cover problem from a SetCoverProto.
 // The proto is either read from a binary (if binary is true) or a text file.
 SetCoverModel ReadSetCoverProto(absl::string_view filename, bool binary);
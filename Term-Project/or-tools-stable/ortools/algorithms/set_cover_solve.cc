@@ -11,21 +11,32 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/log/check.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "ortools/algorithms/set_cover_heuristics.h"
 #include "ortools/algorithms/set_cover_invariant.h"
+#include "ortools/algorithms/set_cover_lagrangian.h"
 #include "ortools/algorithms/set_cover_model.h"
+#include "ortools/algorithms/set_cover_presolve.h"
 #include "ortools/algorithms/set_cover_reader.h"
 #include "ortools/base/init_google.h"
 #include "ortools/base/logging.h"
+#include "ortools/base/threadpool.h"
 #include "ortools/base/timer.h"
 
 ABSL_FLAG(std::string, input, "", "REQUIRED: Input file name.");
@@ -58,6 +69,20 @@ ABSL_FLAG(std::string, improvement, "", "Solution improvement method.");
 ABSL_FLAG(int, num_threads, 1,
           "Number of threads to use by the underlying solver.");
 
+ABSL_FLAG(bool, portfolio, false,
+          "Solve with a portfolio of --num_threads generator/improver "
+          "pipelines running concurrently and sharing their best solution.");
+ABSL_FLAG(double, portfolio_time_limit, 10.0,
+          "Time limit in seconds for the portfolio.");
+ABSL_FLAG(int, portfolio_iterations, 100,
+          "Number of improvement iterations per round of a pipeline.");
+ABSL_FLAG(int, portfolio_exchange_period, 10,
+          "Number of rounds without improvement after which a pipeline "
+          "restarts from the best solution of the portfolio.");
+
+ABSL_FLAG(bool, presolve, false,
+          "Presolve the model before solving it, and postsolve the solution.");
+
 ABSL_FLAG(bool, solve, false, "Solve the model.");
 ABSL_FLAG(bool, stats, false, "Log stats about the model.");
 
@@ -149,7 +174,7 @@ SetCoverModel ReadModel(absl::string_view input_file, FileFormat input_format) {
     case FileFormat::ORLIB_RAIL:
       return ReadOrlibRail(input_file);
     case FileFormat::FIMI_DAT:
-      return ReadFimiDat(input_file);
+      return ReadFimiDat(input_file, absl::GetFlag(FLAGS_num_threads));
     case FileFormat::PROTO:
       return ReadSetCoverProto(input_file, /*binary=*/false);
     case FileFormat::PROTO_BIN:
@@ -229,6 +254,349 @@ SetCoverInvariant RunLazyElementDegree(std::string name, SetCoverModel* model) {
   return inv;
 }
 
+// The best solution found so far by the pipelines of a portfolio, and the best
+// lower bound proven on the way. cost() and lower_bound() are lock-free so
+// that the pipelines can check them after each round.
+class SharedIncumbent {
+ public:
+  explicit SharedIncumbent(absl::Time deadline)
+      : deadline_(deadline),
+        cost_(std::numeric_limits<Cost>::max()),
+        lower_bound_(0.0) {}
+
+  Cost cost() const { return cost_.load(std::memory_order_relaxed); }
+
+  Cost lower_bound() const {
+    return lower_bound_.load(std::memory_order_relaxed);
+  }
+
+  // Returns true when the pipelines should stop, i.e. when the time limit is
+  // reached or when the incumbent meets the lower bound.
+  bool ShouldStop() const {
+    const Cost lower_bound = this->lower_bound();
+    return absl::Now() >= deadline_ ||
+           cost() <= lower_bound + kTolerance * std::max(1.0, lower_bound);
+  }
+
+  // Records the solution of inv if it is better than the incumbent. Returns
+  // true if it was. inv must be consistent at level kFreeAndUncovered.
+  bool Offer(absl::string_view name, const SetCoverInvariant& inv) {
+    if (inv.num_uncovered_elements() != 0 || inv.cost() >= cost()) {
+      return false;
+    }
+    absl::MutexLock lock(&mutex_);
+    if (inv.cost() >= cost()) return false;
+    solution_ = inv.is_selected();
+    cost_.store(inv.cost(), std::memory_order_relaxed);
+    VLOG(1) << "New incumbent from " << name << ", cost = " << inv.cost();
+    return true;
+  }
+
+  void OfferLowerBound(Cost lower_bound) {
+    absl::MutexLock lock(&mutex_);
+    if (lower_bound > this->lower_bound()) {
+      lower_bound_.store(lower_bound, std::memory_order_relaxed);
+    }
+  }
+
+  // Returns a copy of the incumbent.
+  SubsetBoolVector solution() const {
+    absl::MutexLock lock(&mutex_);
+    return solution_;
+  }
+
+ private:
+  // Relative gap under which the incumbent is considered optimal.
+  static constexpr double kTolerance = 1e-9;
+
+  const absl::Time deadline_;
+  mutable absl::Mutex mutex_;
+  SubsetBoolVector solution_ ABSL_GUARDED_BY(mutex_);
+  std::atomic<Cost> cost_;
+  std::atomic<Cost> lower_bound_;
+};
+
+// Clears a fraction of the selected subsets of inv, covers the elements again
+// greedily with respect to costs, and removes the redundant subsets with at
+// most num_iterations steps of SteepestSearch. The move is undone if it does
+// not decrease the cost.
+void RepairRandomNeighborhood(const SubsetCostVector& costs,
+                              int num_iterations, SetCoverInvariant* inv) {
+  // Proportion of the selected subsets cleared at each round.
+  constexpr double kClearedFraction = 0.1;
+  const SubsetBoolVector previous = inv->is_selected();
+  const Cost previous_cost = inv->cost();
+  const BaseInt num_selected =
+      std::count(previous.begin(), previous.end(), true);
+  ClearRandomSubsets(std::max<BaseInt>(1, num_selected * kClearedFraction),
+                     inv);
+  GreedySolutionGenerator greedy(inv);
+  CHECK(greedy.NextSolution(inv->model()->all_subsets(), costs));
+  // The greedy generator only traces the subsets it selected itself.
+  inv->LoadSolution(inv->is_selected());
+  SteepestSearch steepest(inv);
+  CHECK(steepest.NextSolution(num_iterations));
+  if (inv->cost() >= previous_cost) {
+    inv->LoadSolution(previous);
+  }
+}
+
+// A generator/improver pipeline run by the portfolio on its own invariant.
+// The model is shared, read-only, by all the pipelines.
+class PortfolioPipeline {
+ public:
+  PortfolioPipeline(absl::string_view name, SetCoverModel* model)
+      : name_(name), inv_(model) {}
+  virtual ~PortfolioPipeline() = default;
+
+  // Builds a first solution in inv_.
+  virtual void Generate() = 0;
+
+  // Runs one round of about num_iterations improvement steps on inv_. The cost
+  // of inv_ must not increase.
+  virtual void Improve(int num_iterations) = 0;
+
+  // Generates a solution, then improves it round after round until the
+  // incumbent says to stop. After exchange_period rounds without improvement,
+  // restarts from the incumbent if it is better.
+  void Run(int num_iterations, int exchange_period,
+           SharedIncumbent* incumbent);
+
+ protected:
+  std::string name_;
+  SetCoverInvariant inv_;
+};
+
+void PortfolioPipeline::Run(int num_iterations, int exchange_period,
+                            SharedIncumbent* incumbent) {
+  WallTimer timer;
+  timer.Start();
+  Generate();
+  inv_.Recompute(CL::kFreeAndUncovered);
+  LogCostAndTiming(name_, "Generate", inv_, timer);
+  incumbent->Offer(name_, inv_);
+  Cost best_cost = inv_.cost();
+  int num_rounds = 0;
+  int num_rounds_without_improvement = 0;
+  while (!incumbent->ShouldStop()) {
+    Improve(num_iterations);
+    ++num_rounds;
+    if (inv_.cost() < best_cost) {
+      best_cost = inv_.cost();
+      num_rounds_without_improvement = 0;
+      inv_.Recompute(CL::kFreeAndUncovered);
+      incumbent->Offer(name_, inv_);
+    } else if (++num_rounds_without_improvement >= exchange_period) {
+      num_rounds_without_improvement = 0;
+      if (incumbent->cost() < inv_.cost()) {
+        inv_.LoadSolution(incumbent->solution());
+        best_cost = inv_.cost();
+      }
+    }
+  }
+  inv_.Recompute(CL::kFreeAndUncovered);
+  LOG(INFO) << ", " << name_ << ", num_rounds, " << num_rounds;
+  LogCostAndTiming(name_, "Improve", inv_, timer);
+}
+
+// Greedy, then large neighborhood search with SteepestSearch.
+class GreedySteepestPipeline : public PortfolioPipeline {
+ public:
+  using PortfolioPipeline::PortfolioPipeline;
+
+  void Generate() override {
+    GreedySolutionGenerator greedy(&inv_);
+    CHECK(greedy.NextSolution());
+    inv_.LoadSolution(inv_.is_selected());
+  }
+
+  void Improve(int num_iterations) override {
+    RepairRandomNeighborhood(inv_.model()->subset_costs(), num_iterations,
+                             &inv_);
+  }
+};
+
+// Lazy element degree, then Guided Tabu Search. The penalties of the search
+// persist from one round to the next.
+class ElementDegreeTabuPipeline : public PortfolioPipeline {
+ public:
+  ElementDegreeTabuPipeline(absl::string_view name, SetCoverModel* model)
+      : PortfolioPipeline(name, model), tabu_(&inv_) {}
+
+  void Generate() override {
+    LazyElementDegreeSolutionGenerator element_degree(&inv_);
+    CHECK(element_degree.NextSolution());
+  }
+
+  void Improve(int num_iterations) override {
+    inv_.Recompute(CL::kFreeAndUncovered);
+    CHECK(tabu_.NextSolution(num_iterations));
+  }
+
+ private:
+  GuidedTabuSearch tabu_;
+};
+
+// Computes a Lagrangian lower bound, which is shared with the other pipelines,
+// and uses the reduced costs to guide the greedy construction and the repairs.
+// The subgradient optimization is not interruptible, so on large models this
+// pipeline may overrun the time limit.
+class LagrangianPipeline : public PortfolioPipeline {
+ public:
+  LagrangianPipeline(absl::string_view name, SetCoverModel* model,
+                     SharedIncumbent* incumbent)
+      : PortfolioPipeline(name, model), incumbent_(incumbent) {}
+
+  void Generate() override {
+    // The subgradient step sizes need an upper bound.
+    LazyElementDegreeSolutionGenerator element_degree(&inv_);
+    CHECK(element_degree.NextSolution());
+    const Cost upper_bound = std::min(inv_.cost(), incumbent_->cost());
+    SetCoverLagrangian lagrangian(&inv_, /*num_threads=*/1);
+    const SubsetCostVector& costs = inv_.model()->subset_costs();
+    const auto [lower_bound, reduced_costs, multipliers] =
+        lagrangian.ComputeLowerBound(costs, upper_bound);
+    incumbent_->OfferLowerBound(lower_bound);
+    // Subsets with a non-positive reduced cost belong to the Lagrangian
+    // solution. They get a small positive cost so that the greedy generator
+    // picks them first.
+    guided_costs_.resize(costs.size());
+    for (const SubsetIndex subset : inv_.model()->SubsetRange()) {
+      guided_costs_[subset] = std::max(reduced_costs[subset], 0.0) +
+                              kMinCostFraction * costs[subset];
+    }
+    inv_.Clear();
+    GreedySolutionGenerator greedy(&inv_);
+    CHECK(greedy.NextSolution(inv_.model()->all_subsets(), guided_costs_));
+    inv_.LoadSolution(inv_.is_selected());
+    SteepestSearch steepest(&inv_);
+    CHECK(steepest.NextSolution(inv_.model()->num_subsets()));
+  }
+
+  void Improve(int num_iterations) override {
+    RepairRandomNeighborhood(guided_costs_, num_iterations, &inv_);
+  }
+
+ private:
+  // Fraction of the actual cost that is kept in the guided costs, so that they
+  // are all positive.
+  static constexpr double kMinCostFraction = 1e-3;
+
+  SharedIncumbent* incumbent_;
+  SubsetCostVector guided_costs_;
+};
+
+// Random solution, then Guided Local Search.
+class RandomGuidedLocalSearchPipeline : public PortfolioPipeline {
+ public:
+  using PortfolioPipeline::PortfolioPipeline;
+
+  void Generate() override {
+    RandomSolutionGenerator random(&inv_);
+    CHECK(random.NextSolution());
+    // GuidedLocalSearch reads the solution when it is built.
+    gls_ = std::make_unique<GuidedLocalSearch>(&inv_);
+  }
+
+  void Improve(int num_iterations) override {
+    CHECK(gls_->NextSolution(num_iterations));
+  }
+
+ private:
+  std::unique_ptr<GuidedLocalSearch> gls_;
+};
+
+// Runs --num_threads pipelines concurrently, cycling through greedy+steepest,
+// element degree+tabu, Lagrangian and random+GLS. Returns an invariant holding
+// the best solution found.
+SetCoverInvariant RunPortfolio(std::string name, SetCoverModel* model) {
+  const int num_threads = std::max(1, absl::GetFlag(FLAGS_num_threads));
+  const int num_iterations = absl::GetFlag(FLAGS_portfolio_iterations);
+  const int exchange_period = absl::GetFlag(FLAGS_portfolio_exchange_period);
+  WallTimer timer;
+  timer.Start();
+  // The views are built once here, since the pipelines share the model.
+  model->CreateFlatViews();
+  SharedIncumbent incumbent(
+      absl::Now() + absl::Seconds(absl::GetFlag(FLAGS_portfolio_time_limit)));
+  std::vector<std::unique_ptr<PortfolioPipeline>> pipelines;
+  for (int i = 0; i < num_threads; ++i) {
+    switch (i % 4) {
+      case 0:
+        pipelines.push_back(std::make_unique<GreedySteepestPipeline>(
+            absl::StrCat(name, ".", i, ".greedy_steepest"), model));
+        break;
+      case 1:
+        pipelines.push_back(std::make_unique<ElementDegreeTabuPipeline>(
+            absl::StrCat(name, ".", i, ".element_degree_tabu"), model));
+        break;
+      case 2:
+        pipelines.push_back(std::make_unique<LagrangianPipeline>(
+            absl::StrCat(name, ".", i, ".lagrangian"), model, &incumbent));
+        break;
+      default:
+        pipelines.push_back(std::make_unique<RandomGuidedLocalSearchPipeline>(
+            absl::StrCat(name, ".", i, ".random_gls"), model));
+        break;
+    }
+  }
+  {
+    ThreadPool pool(num_threads);
+    pool.StartWorkers();
+    absl::BlockingCounter num_running(num_threads);
+    for (const std::unique_ptr<PortfolioPipeline>& pipeline : pipelines) {
+      pool.Schedule([&, pipeline = pipeline.get()]() {
+        pipeline->Run(num_iterations, exchange_period, &incumbent);
+        num_running.DecrementCount();
+      });
+    }
+    num_running.Wait();
+  }
+  SetCoverInvariant inv(model);
+  inv.LoadSolution(incumbent.solution());
+  LOG(INFO) << ", " << name << ", lower_bound, " << incumbent.lower_bound();
+  LogCostAndTiming(name, "Portfolio", inv, timer);
+  return inv;
+}
+
+// Solves the model with the portfolio if --portfolio is set, and with the
+// lazy element degree heuristic otherwise. Both only read the flat views, so
+// the nested ones are released first.
+SetCoverInvariant Solve(std::string name, SetCoverModel* model) {
+  model->ReleaseNestedViews();
+  return absl::GetFlag(FLAGS_portfolio) ? RunPortfolio(name, model)
+                                        : RunLazyElementDegree(name, model);
+}
+
+// Presolves the model, solves the reduced model with Solve, and maps the
+// solution back to the original model.
+SetCoverInvariant PresolveAndSolve(std::string name, SetCoverModel* model) {
+  WallTimer timer;
+  timer.Start();
+  SetCoverPresolver presolver(*model);
+  CHECK(presolver.Presolve()) << name << " is infeasible.";
+  // The presolver has its own copy of the columns, and the original model is
+  // only needed again to evaluate the postsolved solution.
+  model->ReleaseNestedViews();
+  SetCoverModel* reduced_model = presolver.reduced_model();
+  LOG(INFO) << ", " << name << ", presolve, removed_subsets, "
+            << presolver.num_removed_subsets() << ", removed_elements, "
+            << presolver.num_removed_elements() << ", forced_subsets, "
+            << presolver.forced_subsets().size() << ", fixed_cost, "
+            << presolver.fixed_cost() << ", rounds, "
+            << presolver.num_rounds() << ", "
+            << absl::ToInt64Microseconds(timer.GetDuration()) << "e-6, s";
+  SubsetBoolVector reduced_solution(reduced_model->num_subsets(), false);
+  if (reduced_model->num_elements() > 0) {
+    reduced_solution =
+        Solve(absl::StrCat(name, ".presolved"), reduced_model).is_selected();
+  }
+  SetCoverInvariant inv(model);
+  inv.LoadSolution(presolver.Postsolve(reduced_solution));
+  LogCostAndTiming(name, "PresolveAndSolve", inv, timer);
+  return inv;
+}
+
 void Run() {
   const auto& input = absl::GetFlag(FLAGS_input);
   const auto& input_format = ParseFileFormat(absl::GetFlag(FLAGS_input_fmt));
@@ -264,7 +632,9 @@ void Run() {
   if (absl::GetFlag(FLAGS_solve)) {
     LOG(INFO) << "Solving " << problem;
     model.CreateSparseRowView();
-    SetCoverInvariant inv = RunLazyElementDegree(problem, &model);
+    SetCoverInvariant inv = absl::GetFlag(FLAGS_presolve)
+                                ? PresolveAndSolve(problem, &model)
+                                : Solve(problem, &model);
   }
 }
 }  // namespace operations_research
@@ -11,22 +11,33 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <string>
 #include <vector>
 
 #include "absl/log/check.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 #include "ortools/algorithms/set_cover.pb.h"
 #include "ortools/algorithms/set_cover_heuristics.h"
 #include "ortools/algorithms/set_cover_invariant.h"
+#include "ortools/algorithms/set_cover_lagrangian.h"
+#include "ortools/algorithms/set_cover_lns.h"
 #include "ortools/algorithms/set_cover_mip.h"
 #include "ortools/algorithms/set_cover_model.h"
+#include "ortools/algorithms/set_cover_presolve.h"
+#include "ortools/algorithms/set_cover_reader.h"
 #include "ortools/base/gmock.h"
+#include "ortools/base/helpers.h"
 #include "ortools/base/logging.h"
+#include "ortools/base/options.h"
 #include "ortools/base/parse_text_proto.h"
+#include "ortools/base/path.h"
+#include "zlib.h"
 
 namespace operations_research {
 namespace {
@@ -133,6 +144,190 @@ TEST(SetCoverProtoTest, SaveReload) {
   EXPECT_EQ(model.columns(), reloaded.columns());
 }
 
+TEST(SetCoverModelTest, FlatAndCompressedViews) {
+  SetCoverModel model = KnightsCover(10, 10).model();
+  model.CreateFlatViews();
+  model.CreateCompressedColumnView();
+  const FlatColumnView& flat_columns = model.flat_columns();
+  const CompressedColumnView& compressed = model.compressed_columns();
+  ASSERT_EQ(flat_columns.size(), model.num_subsets());
+  ASSERT_EQ(compressed.size(), model.num_subsets());
+  for (const SubsetIndex subset : model.SubsetRange()) {
+    const SparseColumn& column = model.columns()[subset];
+    EXPECT_EQ(flat_columns[subset].size(), column.size());
+    EXPECT_EQ(compressed[subset].size(), column.size());
+    std::vector<ElementIndex> decoded;
+    for (const ElementIndex element : compressed[subset]) {
+      decoded.push_back(element);
+    }
+    EXPECT_EQ(decoded, std::vector<ElementIndex>(column.begin(), column.end()));
+    EXPECT_TRUE(std::equal(column.begin(), column.end(),
+                           flat_columns[subset].begin(),
+                           flat_columns[subset].end()));
+  }
+  const FlatRowView& flat_rows = model.flat_rows();
+  ASSERT_EQ(flat_rows.size(), model.num_elements());
+  for (const ElementIndex element : model.ElementRange()) {
+    const SparseRow& row = model.rows()[element];
+    EXPECT_TRUE(std::equal(row.begin(), row.end(), flat_rows[element].begin(),
+                           flat_rows[element].end()));
+  }
+  model.AddEmptySubset(1.0);
+  EXPECT_FALSE(model.flat_views_are_valid());
+  EXPECT_FALSE(model.compressed_column_view_is_valid());
+}
+
+TEST(SetCoverModelTest, ReleaseNestedViews) {
+  SetCoverModel reference = KnightsCover(10, 10).model();
+  reference.SortElementsInSubsets();
+  SetCoverModel model = KnightsCover(10, 10).model();
+  model.ReleaseNestedViews();
+  EXPECT_TRUE(model.nested_views_are_released());
+  EXPECT_TRUE(model.flat_views_are_valid());
+  EXPECT_FALSE(model.IsEmpty());
+  EXPECT_EQ(model.num_nonzeros(), reference.num_nonzeros());
+  for (const SubsetIndex subset : model.SubsetRange()) {
+    const SparseColumn& column = reference.columns()[subset];
+    EXPECT_TRUE(std::equal(column.begin(), column.end(),
+                           model.flat_columns()[subset].begin(),
+                           model.flat_columns()[subset].end()));
+  }
+  EXPECT_DEATH(model.columns(), "released");
+  EXPECT_DEATH(model.AddEmptySubset(1.0), "released");
+
+  SetCoverInvariant inv(&model);
+  GreedySolutionGenerator greedy(&inv);
+  CHECK(greedy.NextSolution());
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+
+  SetCoverModel greedy_reference = KnightsCover(10, 10).model();
+  SetCoverInvariant reference_inv(&greedy_reference);
+  GreedySolutionGenerator reference_greedy(&reference_inv);
+  CHECK(reference_greedy.NextSolution());
+  EXPECT_EQ(inv.cost(), reference_inv.cost());
+}
+
+TEST(SetCoverModelTest, ExtractSubModel) {
+  SetCoverProto proto = ParseTextProtoOrDie(R"pb(
+    subset { cost: 1 element: 1 element: 2 }
+    subset { cost: 2 element: 0 }
+    subset { cost: 3 element: 0 element: 2 })pb");
+  SetCoverModel model;
+  model.ImportModelFromProto(proto);
+  const std::vector<SubsetIndex> subsets = {SubsetIndex(2), SubsetIndex(0)};
+  SetCoverModel sub_model = model.ExtractSubModel(subsets);
+  EXPECT_EQ(sub_model.num_elements(), 3);
+  EXPECT_EQ(sub_model.num_subsets(), 2);
+  EXPECT_EQ(sub_model.num_nonzeros(), 4);
+  EXPECT_EQ(sub_model.subset_costs()[SubsetIndex(0)], 3);
+  EXPECT_EQ(sub_model.subset_costs()[SubsetIndex(1)], 1);
+  EXPECT_EQ(sub_model.columns()[SubsetIndex(0)].size(), 2);
+  EXPECT_TRUE(sub_model.ComputeFeasibility());
+
+  // The flat column view is used once the nested views are released.
+  model.ReleaseNestedViews();
+  SetCoverModel released_sub_model = model.ExtractSubModel(subsets);
+  EXPECT_EQ(released_sub_model.num_nonzeros(), 4);
+  for (const SubsetIndex subset : sub_model.SubsetRange()) {
+    EXPECT_EQ(released_sub_model.columns()[subset],
+              sub_model.columns()[subset]);
+  }
+  EXPECT_TRUE(released_sub_model.ComputeFeasibility());
+}
+
+TEST(SetCoverModelTest, GenerateRandomModelFromDenseSeed) {
+  // Each subset of the seed has all the elements but one, so the elements
+  // drawn for a generated subset are often already in it.
+  SetCoverModel seed;
+  for (int subset = 0; subset < 6; ++subset) {
+    seed.AddEmptySubset(1.0);
+    for (int element = 0; element < 6; ++element) {
+      if (element != subset) seed.AddElementToLastSubset(element);
+    }
+  }
+  seed.CreateSparseRowView();
+  const SetCoverModel model = SetCoverModel::GenerateRandomModelFrom(
+      seed, /*num_elements=*/6, /*num_subsets=*/1000, /*row_scale=*/1.0,
+      /*column_scale=*/1.0, /*cost_scale=*/1.0);
+  EXPECT_EQ(model.num_elements(), 6);
+  EXPECT_EQ(model.num_subsets(), 1000);
+  BaseInt num_nonzeros = 0;
+  for (const SparseColumn& column : model.columns()) {
+    // The generated columns are not sorted.
+    std::vector<ElementIndex> sorted(column.begin(), column.end());
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_TRUE(std::adjacent_find(sorted.begin(), sorted.end()) ==
+                sorted.end());
+    num_nonzeros += column.size();
+  }
+  EXPECT_EQ(model.num_nonzeros(), num_nonzeros);
+  EXPECT_TRUE(model.ComputeFeasibility());
+}
+
+std::string TmpFileName(absl::string_view name) {
+  return file::JoinPath(::testing::TempDir(), name);
+}
+
+// Compresses text in the gzip format.
+std::string Gzip(absl::string_view text) {
+  z_stream stream = {};
+  CHECK_EQ(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                        /*windowBits=*/15 + 16, /*memLevel=*/8,
+                        Z_DEFAULT_STRATEGY),
+           Z_OK);
+  std::string compressed(deflateBound(&stream, text.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+  stream.avail_in = text.size();
+  stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+  stream.avail_out = compressed.size();
+  CHECK_EQ(deflate(&stream, Z_FINISH), Z_STREAM_END);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+TEST(SetCoverReaderTest, OrlibWriteReload) {
+  SetCoverModel model = KnightsCover(10, 10).model();
+  model.CreateSparseRowView();
+  const std::string scp_file = TmpFileName("knights.scp");
+  const std::string rail_file = TmpFileName("knights.rail");
+  WriteOrlibScp(model, scp_file);
+  WriteOrlibRail(model, rail_file);
+  for (const SetCoverModel& reloaded :
+       {ReadOrlibScp(scp_file), ReadOrlibRail(rail_file)}) {
+    EXPECT_EQ(model.num_subsets(), reloaded.num_subsets());
+    EXPECT_EQ(model.num_elements(), reloaded.num_elements());
+    EXPECT_EQ(model.subset_costs(), reloaded.subset_costs());
+    EXPECT_EQ(model.columns(), reloaded.columns());
+  }
+}
+
+TEST(SetCoverReaderTest, FimiGzipAndThreads) {
+  // Large enough for the file to be cut in chunks.
+  constexpr int kNumRepeats = 1 << 18;
+  std::string text;
+  for (int i = 0; i < kNumRepeats; ++i) {
+    absl::StrAppend(&text, "1 3\n2\n\n3 1 2 \r\n4\n");
+  }
+  const std::string dat_file = TmpFileName("repeated.dat");
+  const std::string gz_file = TmpFileName("repeated.dat.gz");
+  CHECK_OK(file::SetContents(dat_file, text, file::Defaults()));
+  CHECK_OK(file::SetContents(gz_file, Gzip(text), file::Defaults()));
+  const SetCoverModel model = ReadFimiDat(dat_file);
+  ASSERT_EQ(model.num_subsets(), 5 * kNumRepeats);
+  EXPECT_EQ(model.num_elements(), 4);
+  EXPECT_EQ(model.num_nonzeros(), 7 * kNumRepeats);
+  EXPECT_EQ(model.subset_costs()[SubsetIndex(3)], 1.0);
+  EXPECT_TRUE(model.columns()[SubsetIndex(2)].empty());
+  EXPECT_EQ(model.columns()[SubsetIndex(3)].size(), 3);
+  for (const SetCoverModel& reloaded :
+       {ReadFimiDat(gz_file), ReadFimiDat(dat_file, /*num_threads=*/4)}) {
+    EXPECT_EQ(model.num_subsets(), reloaded.num_subsets());
+    EXPECT_EQ(model.num_elements(), reloaded.num_elements());
+    EXPECT_EQ(model.columns(), reloaded.columns());
+  }
+}
+
 TEST(SolutionProtoTest, SaveReloadTwice) {
   SetCoverModel model = KnightsCover(3, 3).model();
   SetCoverInvariant inv(&model);
@@ -189,6 +384,53 @@ TEST(SetCoverTest, Infeasible) {
   EXPECT_FALSE(model.ComputeFeasibility());
 }
 
+TEST(SetCoverPresolveTest, SmallReductions) {
+  // Subset 0 is the only one covering element 0, so it is forced and removes
+  // element 1. The row of element 5 is contained in those of elements 2 and 6,
+  // and subset 2 is dominated by subset 1.
+  SetCoverProto proto = ParseTextProtoOrDie(R"pb(
+    subset { cost: 3 element: 0 element: 1 }
+    subset { cost: 1 element: 1 element: 2 element: 3 element: 5 element: 6 }
+    subset { cost: 2 element: 2 element: 3 }
+    subset { cost: 1 element: 3 element: 4 element: 6 }
+    subset { cost: 1 element: 2 element: 4 element: 5 element: 6 })pb");
+  SetCoverModel model;
+  model.ImportModelFromProto(proto);
+  SetCoverPresolver presolver(model);
+  ASSERT_TRUE(presolver.Presolve());
+  EXPECT_THAT(presolver.forced_subsets(),
+              testing::ElementsAre(SubsetIndex(0)));
+  EXPECT_EQ(presolver.fixed_cost(), 3.0);
+  EXPECT_EQ(presolver.num_removed_subsets(), 2);
+  EXPECT_EQ(presolver.num_removed_elements(), 4);
+  EXPECT_THAT(presolver.original_subsets(),
+              testing::ElementsAre(SubsetIndex(1), SubsetIndex(3),
+                                   SubsetIndex(4)));
+  EXPECT_THAT(presolver.original_elements(),
+              testing::ElementsAre(ElementIndex(3), ElementIndex(4),
+                                   ElementIndex(5)));
+
+  SetCoverInvariant reduced_inv(presolver.reduced_model());
+  GreedySolutionGenerator greedy(&reduced_inv);
+  CHECK(greedy.NextSolution());
+  SetCoverInvariant inv(&model);
+  inv.LoadSolution(presolver.Postsolve(reduced_inv.is_selected()));
+  inv.Recompute(CL::kFreeAndUncovered);
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_EQ(inv.cost(), reduced_inv.cost() + presolver.fixed_cost());
+  EXPECT_EQ(inv.cost(), 5.0);
+}
+
+TEST(SetCoverPresolveTest, Infeasible) {
+  SetCoverModel model;
+  model.AddEmptySubset(1);
+  model.AddElementToLastSubset(0);
+  model.AddEmptySubset(1);
+  model.AddElementToLastSubset(3);
+  SetCoverPresolver presolver(model);
+  EXPECT_FALSE(presolver.Presolve());
+}
+
 #ifdef NDEBUG
 static constexpr int SIZE = 128;
 #else
@@ -249,6 +491,88 @@ TEST(SetCoverTest, KnightsCoverDegree) {
   LOG(INFO) << "SteepestSearch cost: " << inv.cost();
 }
 
+TEST(SetCoverTest, KnightsCoverParallelGreedy) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+
+  ParallelGreedySolutionGenerator greedy(&inv, 4);
+  CHECK(greedy.NextSolution());
+  LOG(INFO) << "ParallelGreedySolutionGenerator cost: " << inv.cost();
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+
+  SteepestSearch steepest(&inv);
+  CHECK(steepest.NextSolution(100));
+  LOG(INFO) << "SteepestSearch cost: " << inv.cost();
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+}
+
+TEST(SetCoverTest, ParallelGreedyPrioritiesBelowStartingLevel) {
+  // Subset i is {2i, 2i + 1, 2i + 2}, so all the subsets start with the same
+  // priority, in a single bucket. The first round selects every other subset,
+  // which leaves the others with a single free element, below the starting
+  // level. There are enough subsets for the buckets to be rescanned in
+  // parallel.
+  constexpr int kNumSubsets = 12000;
+  SetCoverModel model;
+  for (int i = 0; i < kNumSubsets; ++i) {
+    model.AddEmptySubset(1);
+    for (int j = 0; j < 3; ++j) {
+      model.AddElementToLastSubset((2 * i + j) % (2 * kNumSubsets));
+    }
+  }
+  SetCoverInvariant inv(&model);
+  ParallelGreedySolutionGenerator greedy(&inv, 4);
+  CHECK(greedy.NextSolution());
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+  EXPECT_EQ(inv.cost(), kNumSubsets);
+}
+
+TEST(SetCoverTest, KnightsCoverParallelElementDegree) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+
+  ParallelElementDegreeSolutionGenerator degree(&inv, 4);
+  CHECK(degree.NextSolution());
+  LOG(INFO) << "ParallelElementDegreeSolutionGenerator cost: " << inv.cost();
+  EXPECT_TRUE(inv.CheckConsistency(CL::kCostAndCoverage));
+  inv.Recompute(CL::kFreeAndUncovered);
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+}
+
+TEST(SetCoverTest, KnightsCoverCheckpointRollback) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+  GreedySolutionGenerator greedy(&inv);
+  CHECK(greedy.NextSolution());
+  for (const CL consistency :
+       {CL::kCostAndCoverage, CL::kFreeAndUncovered, CL::kRedundancy}) {
+    inv.LoadSolution(inv.is_selected());
+    inv.Recompute(consistency);
+    const SubsetBoolVector solution = inv.is_selected();
+    const Cost cost = inv.cost();
+    const BaseInt checkpoint = inv.Checkpoint();
+    for (BaseInt i = 0; i < model.num_subsets(); i += 7) {
+      const SubsetIndex subset(i);
+      const SetCoverInvariant::FlipDelta delta = inv.ComputeFlipDelta(subset);
+      const Cost cost_before = inv.cost();
+      const BaseInt num_uncovered_before = inv.num_uncovered_elements();
+      inv.Flip(subset, consistency);
+      EXPECT_NEAR(inv.cost() - cost_before, delta.cost, 1e-9);
+      if (consistency >= CL::kFreeAndUncovered) {
+        EXPECT_EQ(inv.num_uncovered_elements() - num_uncovered_before,
+                  delta.num_uncovered_elements);
+      }
+    }
+    inv.Rollback(checkpoint, consistency);
+    EXPECT_EQ(inv.Checkpoint(), checkpoint);
+    EXPECT_EQ(inv.is_selected(), solution);
+    EXPECT_NEAR(inv.cost(), cost, 1e-9);
+    EXPECT_TRUE(inv.CheckConsistency(consistency));
+  }
+}
+
 TEST(SetCoverTest, KnightsCoverGLS) {
   SetCoverModel model = KnightsCover(SIZE, SIZE).model();
   SetCoverInvariant inv(&model);
@@ -260,6 +584,159 @@ TEST(SetCoverTest, KnightsCoverGLS) {
   LOG(INFO) << "GuidedLocalSearch cost: " << inv.cost();
 }
 
+TEST(SetCoverTest, KnightsCoverLagrangianCore) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+  GreedySolutionGenerator greedy(&inv);
+  CHECK(greedy.NextSolution());
+  const Cost greedy_cost = inv.cost();
+
+  SetCoverLagrangian lagrangian(&inv, 2);
+  CHECK(lagrangian.NextSolution());
+  LOG(INFO) << "SetCoverLagrangian cost: " << inv.cost()
+            << " lower bound: " << lagrangian.lower_bound()
+            << " fixed subsets: " << lagrangian.num_fixed_subsets()
+            << " core size: " << lagrangian.core_size();
+  EXPECT_LE(inv.cost(), greedy_cost);
+  EXPECT_LE(lagrangian.lower_bound(), inv.cost());
+  EXPECT_GT(lagrangian.lower_bound(), 0.0);
+  EXPECT_LT(lagrangian.core_size(), model.num_subsets());
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+}
+
+// The sharded passes must give the serial results, up to the order in which
+// the partial sums are added.
+TEST(SetCoverTest, KnightsCoverLagrangianShardsMatchSerial) {
+  constexpr double kTolerance = 1e-9;
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+  GreedySolutionGenerator greedy(&inv);
+  CHECK(greedy.NextSolution());
+  const Cost upper_bound = inv.cost();
+  SetCoverLagrangian serial(&inv, 1);
+  const SubsetCostVector& costs = model.subset_costs();
+  const ElementCostVector multipliers = serial.InitializeLagrangeMultipliers();
+  const SubsetCostVector reduced_costs =
+      serial.ComputeReducedCosts(costs, multipliers);
+  const ElementCostVector subgradient =
+      serial.ComputeSubgradient(reduced_costs);
+  const Cost lagrangian_value =
+      serial.ComputeLagrangianValue(reduced_costs, multipliers);
+  ElementCostVector updated_multipliers = multipliers;
+  serial.UpdateMultipliers(0.1, lagrangian_value, upper_bound, reduced_costs,
+                           &updated_multipliers);
+  const auto [lower_bound, bound_reduced_costs, bound_multipliers] =
+      serial.ComputeLowerBound(costs, upper_bound);
+  EXPECT_GT(lower_bound, 0.0);
+
+  for (const int num_threads : {1, 2, 7}) {
+    SCOPED_TRACE(absl::StrCat("num_threads: ", num_threads));
+    SetCoverLagrangian sharded(&inv, num_threads);
+    EXPECT_EQ(sharded.InitializeLagrangeMultipliers(), multipliers);
+    const SubsetCostVector sharded_reduced_costs =
+        sharded.ParallelComputeReducedCosts(costs, multipliers);
+    for (const SubsetIndex subset : model.SubsetRange()) {
+      EXPECT_NEAR(sharded_reduced_costs[subset], reduced_costs[subset],
+                  kTolerance);
+    }
+    const ElementCostVector sharded_subgradient =
+        sharded.ParallelComputeSubgradient(reduced_costs);
+    EXPECT_EQ(sharded_subgradient, subgradient);
+    EXPECT_NEAR(
+        sharded.ParallelComputeLagrangianValue(reduced_costs, multipliers),
+        lagrangian_value, kTolerance * std::abs(lagrangian_value));
+    ElementCostVector sharded_updated_multipliers = multipliers;
+    sharded.ParallelUpdateMultipliers(0.1, lagrangian_value, upper_bound,
+                                      reduced_costs,
+                                      &sharded_updated_multipliers);
+    for (const ElementIndex element : model.ElementRange()) {
+      EXPECT_NEAR(sharded_updated_multipliers[element],
+                  updated_multipliers[element], kTolerance);
+    }
+
+    // The fused subgradient loop, run on one persistent worker per shard.
+    const auto [sharded_lower_bound, sharded_bound_reduced_costs,
+                sharded_bound_multipliers] =
+        sharded.ComputeLowerBound(costs, upper_bound);
+    EXPECT_NEAR(sharded_lower_bound, lower_bound, kTolerance * lower_bound);
+    for (const SubsetIndex subset : model.SubsetRange()) {
+      EXPECT_NEAR(sharded_bound_reduced_costs[subset],
+                  bound_reduced_costs[subset], kTolerance);
+    }
+    for (const ElementIndex element : model.ElementRange()) {
+      EXPECT_NEAR(sharded_bound_multipliers[element],
+                  bound_multipliers[element], kTolerance);
+    }
+    // The reduced costs returned are those of the multipliers returned.
+    const SubsetCostVector recomputed_reduced_costs =
+        serial.ComputeReducedCosts(costs, sharded_bound_multipliers);
+    for (const SubsetIndex subset : model.SubsetRange()) {
+      EXPECT_NEAR(sharded_bound_reduced_costs[subset],
+                  recomputed_reduced_costs[subset], kTolerance);
+    }
+    EXPECT_NEAR(serial.ComputeLagrangianValue(sharded_bound_reduced_costs,
+                                              sharded_bound_multipliers),
+                sharded_lower_bound, kTolerance * sharded_lower_bound);
+  }
+}
+
+TEST(SetCoverTest, KnightsCoverLagrangianCoreMip) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+  SetCoverLagrangian lagrangian(&inv);
+  lagrangian.SetCoreSolver([](SetCoverInvariant* core_inv) {
+    SetCoverMip mip(core_inv);
+    return mip.NextSolution(true, .5);
+  });
+  CHECK(lagrangian.NextSolution());
+  LOG(INFO) << "SetCoverLagrangian with Mip cost: " << inv.cost()
+            << " lower bound: " << lagrangian.lower_bound();
+  EXPECT_LE(lagrangian.lower_bound(), inv.cost());
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+}
+
+TEST(SetCoverTest, KnightsCoverGreedyAndLns) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverInvariant inv(&model);
+  GreedySolutionGenerator greedy(&inv);
+  CHECK(greedy.NextSolution());
+  const Cost greedy_cost = inv.cost();
+
+  SetCoverLns lns(&inv);
+  lns.SetNeighborhoodSize(4);
+  CHECK(lns.NextSolution(30, 1.0));
+  LOG(INFO) << "SetCoverLns cost: " << inv.cost()
+            << " improvements: " << lns.num_improvements()
+            << " neighborhood size: " << lns.neighborhood_size();
+  EXPECT_LE(inv.cost(), greedy_cost);
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_TRUE(inv.CheckConsistency(CL::kFreeAndUncovered));
+}
+
+TEST(SetCoverTest, KnightsCoverPresolveAndGreedy) {
+  SetCoverModel model = KnightsCover(SIZE, SIZE).model();
+  SetCoverPresolver presolver(model);
+  CHECK(presolver.Presolve());
+  SetCoverModel* reduced_model = presolver.reduced_model();
+  LOG(INFO) << "Presolve removed " << presolver.num_removed_subsets()
+            << " subsets and " << presolver.num_removed_elements()
+            << " elements, forced " << presolver.forced_subsets().size()
+            << " subsets.";
+  EXPECT_TRUE(reduced_model->ComputeFeasibility());
+
+  SetCoverInvariant reduced_inv(reduced_model);
+  GreedySolutionGenerator greedy(&reduced_inv);
+  CHECK(greedy.NextSolution());
+  SetCoverInvariant inv(&model);
+  inv.LoadSolution(presolver.Postsolve(reduced_inv.is_selected()));
+  inv.Recompute(CL::kFreeAndUncovered);
+  LOG(INFO) << "Presolve and GreedySolutionGenerator cost: " << inv.cost();
+  EXPECT_EQ(inv.num_uncovered_elements(), 0);
+  EXPECT_EQ(inv.cost(), reduced_inv.cost() + presolver.fixed_cost());
+}
+
 TEST(SetCoverTest, KnightsCoverRandom) {
   SetCoverModel model = KnightsCover(SIZE, SIZE).model();
   EXPECT_TRUE(model.ComputeFeasibility());
@@ -24,7 +24,6 @@
 #include <utility>
 #include <vector>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
@@ -53,9 +52,9 @@ namespace {
 // Returns true if the given watcher list contains the given clause.
 template <typename Watcher>
 bool WatcherListContains(const std::vector<Watcher>& list,
-                         const SatClause& candidate) {
+                         ClauseRef candidate) {
   for (const Watcher& watcher : list) {
-    if (watcher.clause == &candidate) return true;
+    if (watcher.clause_ref == candidate) return true;
   }
   return false;
 }
@@ -68,6 +67,64 @@ void RemoveIf(Container c, Predicate p) {
 
 }  // namespace
 
+// ----- ClauseArena -----
+
+SatClause* ClauseArena::NewClause(absl::Span<const Literal> literals) {
+  DCHECK_GE(literals.size(), 2);
+  ClauseRef ref;
+  SatClause* clause = reinterpret_cast<SatClause*>(
+      Allocate(NumWords(literals.size()), &ref));
+  clause->size_ = literals.size();
+  clause->lbd_ = 0;
+  clause->is_removable_ = false;
+  clause->protected_during_next_cleanup_ = false;
+  clause->activity_ = 0.0;
+  clause->ref_ = ref;
+  std::copy(literals.begin(), literals.end(), clause->literals_);
+  return clause;
+}
+
+void ClauseArena::BeginCompaction() {
+  DCHECK(old_slabs_.empty());
+  old_slabs_.swap(slabs_);
+  last_slab_capacity_ = 0;
+  last_slab_size_ = 0;
+  next_slab_capacity_ = kMinSlabWords;
+  num_used_words_ = 0;
+}
+
+// Note that the literals in [size, old_size) of a shrunk clause are not
+// copied, this is where the compaction also reclaims some memory.
+SatClause* ClauseArena::Relocate(SatClause* clause) {
+  DCHECK(!clause->IsRemoved());
+  ClauseRef ref;
+  SatClause* copy = reinterpret_cast<SatClause*>(
+      Allocate(NumWords(clause->size()), &ref));
+  std::copy(reinterpret_cast<const uint32_t*>(clause),
+            reinterpret_cast<const uint32_t*>(clause->end()),
+            reinterpret_cast<uint32_t*>(copy));
+  copy->ref_ = ref;
+  clause->ref_ = ref;
+  return copy;
+}
+
+uint32_t* ClauseArena::Allocate(int64_t num_words, ClauseRef* ref) {
+  if (slabs_.empty() || last_slab_size_ + num_words > last_slab_capacity_) {
+    CHECK_LT(slabs_.size(), kMaxNumSlabs) << "Too many clauses.";
+    last_slab_capacity_ = std::max(num_words, next_slab_capacity_);
+    last_slab_size_ = 0;
+    slabs_.emplace_back(new uint32_t[last_slab_capacity_]);
+    next_slab_capacity_ = std::min(2 * next_slab_capacity_, kMaxSlabWords);
+  }
+  DCHECK_LE(last_slab_size_, kOffsetMask);
+  *ref = ClauseRef(static_cast<int>((slabs_.size() - 1) << kOffsetBits) |
+                   static_cast<int>(last_slab_size_));
+  uint32_t* memory = slabs_.back().get() + last_slab_size_;
+  last_slab_size_ += num_words;
+  num_used_words_ += num_words;
+  return memory;
+}
+
 // ----- ClauseManager -----
 
 ClauseManager::ClauseManager(Model* model)
@@ -82,7 +139,6 @@ ClauseManager::ClauseManager(Model* model)
 }
 
 ClauseManager::~ClauseManager() {
-  gtl::STLDeleteElements(&clauses_);
   IF_STATS_ENABLED(LOG(INFO) << stats_.StatString());
 }
 
@@ -99,8 +155,10 @@ void ClauseManager::AttachOnFalse(Literal literal, Literal blocking_literal,
                                   SatClause* clause) {
   SCOPED_TIME_STAT(&stats_);
   DCHECK(is_clean_);
-  DCHECK(!WatcherListContains(watchers_on_false_[literal], *clause));
-  watchers_on_false_[literal].push_back(Watcher(clause, blocking_literal));
+  DCHECK_EQ(arena_.Get(clause->ref_), clause);
+  DCHECK(!WatcherListContains(watchers_on_false_[literal], clause->ref_));
+  watchers_on_false_[literal].push_back(
+      Watcher(clause->ref_, blocking_literal));
 }
 
 bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
@@ -128,7 +186,8 @@ bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
     // If the other watched literal is true, just change the blocking literal.
     // Note that we use the fact that the first two literals of the clause are
     // the ones currently watched.
-    Literal* literals = it->clause->literals();
+    SatClause* clause = arena_.Get(it->clause_ref);
+    Literal* literals = clause->literals();
     const Literal other_watched_literal(
         LiteralIndex(literals[0].Index().value() ^ literals[1].Index().value() ^
                      false_literal.Index().value()));
@@ -145,7 +204,7 @@ bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
     // watched ones.
     {
       const int start = it->start_index;
-      const int size = it->clause->size();
+      const int size = clause->size();
       DCHECK_GE(start, 2);
 
       int i = start;
@@ -165,7 +224,7 @@ bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
         literals[1] = literals[i];
         literals[i] = false_literal;
         watchers_on_false_[literals[1]].emplace_back(
-            it->clause, other_watched_literal, i + 1);
+            it->clause_ref, other_watched_literal, i + 1);
         continue;
       }
     }
@@ -173,12 +232,12 @@ bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
     // At this point other_watched_literal is either false or unassigned, all
     // other literals are false.
     if (assignment.LiteralIsFalse(other_watched_literal)) {
-      // Conflict: All literals of it->clause are false.
+      // Conflict: All literals of clause are false.
       //
       // Note(user): we could avoid a copy here, but the conflict analysis
       // complexity will be a lot higher than this anyway.
-      trail->MutableConflict()->assign(it->clause->begin(), it->clause->end());
-      trail->SetFailingSatClause(it->clause);
+      trail->MutableConflict()->assign(clause->begin(), clause->end());
+      trail->SetFailingSatClause(clause);
       num_inspected_clause_literals_ += it - watchers.begin() + 1;
       watchers.erase(new_it, it);
       return false;
@@ -189,7 +248,7 @@ bool ClauseManager::PropagateOnFalse(Literal false_literal, Trail* trail) {
       // clause using this convention.
       literals[0] = other_watched_literal;
       literals[1] = false_literal;
-      reasons_[trail->Index()] = it->clause;
+      reasons_[trail->Index()] = clause;
       trail->Enqueue(other_watched_literal, propagator_id_);
       *new_it++ = *it;
     }
@@ -224,7 +283,7 @@ bool ClauseManager::AddClause(absl::Span<const Literal> literals) {
 
 bool ClauseManager::AddClause(absl::Span<const Literal> literals, Trail* trail,
                               int lbd) {
-  SatClause* clause = SatClause::Create(literals);
+  SatClause* clause = arena_.NewClause(literals);
   clauses_.push_back(clause);
   if (add_clause_callback_ != nullptr) add_clause_callback_(lbd, literals);
   return AttachAndPropagate(clause, trail);
@@ -232,7 +291,10 @@ bool ClauseManager::AddClause(absl::Span<const Literal> literals, Trail* trail,
 
 SatClause* ClauseManager::AddRemovableClause(absl::Span<const Literal> literals,
                                              Trail* trail, int lbd) {
-  SatClause* clause = SatClause::Create(literals);
+  SatClause* clause = arena_.NewClause(literals);
+  clause->is_removable_ = true;
+  clause->lbd_ = lbd;
+  ++num_removable_clauses_;
   clauses_.push_back(clause);
   if (add_clause_callback_ != nullptr) add_clause_callback_(lbd, literals);
   CHECK(AttachAndPropagate(clause, trail));
@@ -309,7 +371,7 @@ void ClauseManager::InternalDetach(SatClause* clause) {
   if (drat_proof_handler_ != nullptr && size > 2) {
     drat_proof_handler_->DeleteClause({clause->begin(), size});
   }
-  clauses_info_.erase(clause);
+  KeepClauseForever(clause);
   clause->Clear();
 }
 
@@ -324,8 +386,8 @@ void ClauseManager::Detach(SatClause* clause) {
   InternalDetach(clause);
   for (const Literal l : {clause->FirstLiteral(), clause->SecondLiteral()}) {
     needs_cleaning_.Clear(l);
-    RemoveIf(&(watchers_on_false_[l]), [](const Watcher& watcher) {
-      return watcher.clause->IsRemoved();
+    RemoveIf(&(watchers_on_false_[l]), [this](const Watcher& watcher) {
+      return arena_.Get(watcher.clause_ref)->IsRemoved();
     });
   }
 }
@@ -382,7 +444,7 @@ void ClauseManager::InprocessingRemoveClause(SatClause* clause) {
   if (drat_proof_handler_ != nullptr) {
     drat_proof_handler_->DeleteClause(clause->AsSpan());
   }
-  clauses_info_.erase(clause);
+  KeepClauseForever(clause);
   clause->Clear();
 }
 
@@ -421,8 +483,8 @@ bool ClauseManager::InprocessingRewriteClause(
     clause->Clear();
     for (const Literal l : {clause->FirstLiteral(), clause->SecondLiteral()}) {
       needs_cleaning_.Clear(l);
-      RemoveIf(&(watchers_on_false_[l]), [](const Watcher& watcher) {
-        return watcher.clause->IsRemoved();
+      RemoveIf(&(watchers_on_false_[l]), [this](const Watcher& watcher) {
+        return arena_.Get(watcher.clause_ref)->IsRemoved();
       });
     }
   }
@@ -455,7 +517,7 @@ SatClause* ClauseManager::InprocessingAddClause(
     return nullptr;
   }
 
-  SatClause* clause = SatClause::Create(new_clause);
+  SatClause* clause = arena_.NewClause(new_clause);
   clauses_.push_back(clause);
   return clause;
 }
@@ -464,8 +526,8 @@ void ClauseManager::CleanUpWatchers() {
   SCOPED_TIME_STAT(&stats_);
   for (const LiteralIndex index : needs_cleaning_.PositionsSetAtLeastOnce()) {
     DCHECK(needs_cleaning_[index]);
-    RemoveIf(&(watchers_on_false_[index]), [](const Watcher& watcher) {
-      return watcher.clause->IsRemoved();
+    RemoveIf(&(watchers_on_false_[index]), [this](const Watcher& watcher) {
+      return arena_.Get(watcher.clause_ref)->IsRemoved();
     });
     needs_cleaning_.Clear(index);
   }
@@ -481,14 +543,14 @@ void ClauseManager::DeleteRemovedClauses() {
   DCHECK(is_clean_);
 
   int new_size = 0;
+  int64_t num_live_words = 0;
   const int old_size = clauses_.size();
   for (int i = 0; i < old_size; ++i) {
     if (i == to_minimize_index_) to_minimize_index_ = new_size;
     if (i == to_first_minimize_index_) to_first_minimize_index_ = new_size;
     if (i == to_probe_index_) to_probe_index_ = new_size;
-    if (clauses_[i]->IsRemoved()) {
-      delete clauses_[i];
-    } else {
+    if (!clauses_[i]->IsRemoved()) {
+      num_live_words += ClauseArena::NumWords(clauses_[i]->size());
       clauses_[new_size++] = clauses_[i];
     }
   }
@@ -497,6 +559,58 @@ void ClauseManager::DeleteRemovedClauses() {
   if (to_minimize_index_ > new_size) to_minimize_index_ = new_size;
   if (to_first_minimize_index_ > new_size) to_first_minimize_index_ = new_size;
   if (to_probe_index_ > new_size) to_probe_index_ = new_size;
+
+  // We only compact the arena when a good part of it can be reclaimed, since
+  // this is linear in the number of clauses, watchers and trail literals.
+  if (4 * (arena_.num_used_words() - num_live_words) > num_live_words) {
+    CompactArena();
+  }
+}
+
+// The clauses are relocated in creation order, and each old clause remembers
+// the reference of its copy until the old slabs are freed. This is used to
+// rewrite all the references and pointers to the clauses we maintain.
+void ClauseManager::CompactArena() {
+  SCOPED_TIME_STAT(&stats_);
+  arena_.BeginCompaction();
+  for (SatClause*& clause : clauses_) clause = arena_.Relocate(clause);
+
+  // There are no watchers of removed clauses since is_clean_ is true.
+  for (std::vector<Watcher>& watchers : watchers_on_false_) {
+    for (Watcher& watcher : watchers) {
+      watcher.clause_ref = arena_.Forward(watcher.clause_ref);
+    }
+  }
+
+  // Only the reasons of the literals currently on the trail can be used, but
+  // we clear the others so that all the pointers in reasons_ point to either
+  // a live clause or a removed one whose memory is still around. This is what
+  // makes the IsRemoved() test below valid.
+  //
+  // Note that the trail caches the reasons as a span on the clause memory,
+  // which we need to invalidate.
+  const int trail_index = trail_->Index();
+  for (int i = 0; i < reasons_.size(); ++i) {
+    SatClause* old_clause = reasons_[i];
+    if (old_clause == nullptr) continue;
+    if (i >= trail_index || old_clause->IsRemoved()) {
+      reasons_[i] = nullptr;
+      continue;
+    }
+    reasons_[i] = arena_.Get(old_clause->ref_);
+    const BooleanVariable var = (*trail_)[i].Variable();
+    if (trail_->Info(var).type == AssignmentType::kCachedReason &&
+        trail_->AssignmentType(var) == propagator_id_) {
+      trail_->ChangeReason(i, propagator_id_);
+    }
+  }
+  SatClause* failing_clause = trail_->FailingSatClause();
+  if (failing_clause != nullptr) {
+    trail_->SetFailingSatClause(failing_clause->IsRemoved()
+                                    ? nullptr
+                                    : arena_.Get(failing_clause->ref_));
+  }
+  arena_.EndCompaction();
 }
 
 SatClause* ClauseManager::NextNewClauseToMinimize() {
@@ -2798,6 +2912,11 @@ SatClause* SatClause::Create(absl::Span<const Literal> literals) {
   SatClause* clause = reinterpret_cast<SatClause*>(
       ::operator new(sizeof(SatClause) + literals.size() * sizeof(Literal)));
   clause->size_ = literals.size();
+  clause->lbd_ = 0;
+  clause->is_removable_ = false;
+  clause->protected_during_next_cleanup_ = false;
+  clause->activity_ = 0.0;
+  clause->ref_ = ClauseRef(-1);
   for (int i = 0; i < literals.size(); ++i) {
     clause->literals_[i] = literals[i];
   }
@@ -20,13 +20,13 @@
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <memory>
 #include <new>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/base/attributes.h"
-#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/functional/any_invocable.h"
@@ -48,6 +48,9 @@
 namespace operations_research {
 namespace sat {
 
+// Reference to a SatClause stored in a ClauseArena, see ClauseArena::Get().
+DEFINE_STRONG_INDEX_TYPE(ClauseRef);
+
 // This is how the SatSolver stores a clause. A clause is just a disjunction of
 // literals. In many places, we just use vector<literal> to encode one. But in
 // the critical propagation code, we use this class to remove one memory
@@ -58,6 +61,9 @@ class SatClause {
   // Clause with one literal fix variable directly and are never constructed.
   // Note that in practice, we use BinaryImplicationGraph for the clause of size
   // 2, so this is used for size at least 3.
+  //
+  // The ClauseManager does not use this, its clauses are allocated in a
+  // ClauseArena.
   static SatClause* Create(absl::Span<const Literal> literals);
 
   // Non-sized delete because this is a tail-padded class.
@@ -113,12 +119,28 @@ class SatClause {
   // be satisfied by completing the assignment.
   bool IsSatisfied(const VariablesAssignment& assignment) const;
 
+  // Clause information used for the clause database management. It is stored
+  // inline so that it shares the cache lines of the literals, but it is only
+  // meaningful for the clauses that can be removed, see
+  // ClauseManager::IsRemovable().
+  int lbd() const { return lbd_; }
+  void set_lbd(int lbd) { lbd_ = lbd; }
+  double activity() const { return activity_; }
+  void set_activity(double activity) { activity_ = activity; }
+  bool protected_during_next_cleanup() const {
+    return protected_during_next_cleanup_;
+  }
+  void set_protected_during_next_cleanup(bool value) {
+    protected_during_next_cleanup_ = value;
+  }
+
   std::string DebugString() const;
 
  private:
   // The manager needs to permute the order of literals in the clause and
   // call Clear()/Rewrite.
   friend class ClauseManager;
+  friend class ClauseArena;
 
   Literal* literals() { return &(literals_[0]); }
 
@@ -136,18 +158,100 @@ class SatClause {
 
   int32_t size_;
 
+  // We use unsigned bit-fields since MSVC does not pack bool ones with the
+  // unsigned one.
+  uint32_t lbd_ : 30;
+  uint32_t is_removable_ : 1;
+  uint32_t protected_during_next_cleanup_ : 1;
+
+  // A float is enough for the activity, it is regularly rescaled anyway.
+  float activity_;
+
+  // The reference of this clause in its ClauseArena. During a compaction, this
+  // is the reference of the relocated copy instead.
+  ClauseRef ref_;
+
   // This class store the literals inline, and literals_ mark the starts of the
   // variable length portion.
   Literal literals_[0];
 };
 
-// Clause information used for the clause database management. Note that only
-// the clauses that can be removed have an info. The problem clauses and
-// the learned one that we wants to keep forever do not have one.
-struct ClauseInfo {
-  double activity = 0.0;
-  int32_t lbd = 0;
-  bool protected_during_next_cleanup = false;
+// Owns the memory of the clauses of a ClauseManager.
+//
+// The clauses are allocated one after the other in a few large slabs rather
+// than with one heap allocation each. This removes the allocator overhead per
+// clause, keeps the clauses learned together close in memory, and allows to
+// refer to a clause with a 32-bit ClauseRef: the slab index in the high bits,
+// and the offset in the slab, counted in 4-byte words, in the low bits.
+//
+// The memory of a removed clause is only reclaimed by a compaction, which
+// relocates all the clauses that are still alive to new slabs. The pointers to
+// the clauses are stable in-between.
+class ClauseArena {
+ public:
+  ClauseArena() = default;
+
+  // This type is neither copyable nor movable.
+  ClauseArena(const ClauseArena&) = delete;
+  ClauseArena& operator=(const ClauseArena&) = delete;
+
+  // Allocates a new clause with the given literals. There must be at least 2
+  // of them.
+  SatClause* NewClause(absl::Span<const Literal> literals);
+
+  SatClause* Get(ClauseRef ref) const {
+    return reinterpret_cast<SatClause*>(
+        slabs_[ref.value() >> kOffsetBits].get() +
+        (ref.value() & kOffsetMask));
+  }
+
+  // The number of words used by the clauses, including the removed ones and
+  // the literals removed from the shrunk ones, until the next compaction.
+  int64_t num_used_words() const { return num_used_words_; }
+
+  // Returns the number of words used by a clause with the given size.
+  static int64_t NumWords(int num_literals) {
+    return (sizeof(SatClause) + num_literals * sizeof(Literal)) /
+           sizeof(uint32_t);
+  }
+
+  // Compaction. Between BeginCompaction() and EndCompaction(), the clauses
+  // allocated before can still be accessed, and those that survive must be
+  // relocated with Relocate(). After that, Forward() maps the reference of a
+  // relocated clause to the one of its copy. The old clauses are freed by
+  // EndCompaction().
+  void BeginCompaction();
+  SatClause* Relocate(SatClause* clause);
+  ClauseRef Forward(ClauseRef old_ref) const {
+    return reinterpret_cast<const SatClause*>(
+               old_slabs_[old_ref.value() >> kOffsetBits].get() +
+               (old_ref.value() & kOffsetMask))
+        ->ref_;
+  }
+  void EndCompaction() { old_slabs_.clear(); }
+
+ private:
+  // The slabs grow geometrically up to kMaxSlabWords, so that small problems
+  // do not pay for a large slab. A clause too large for any slab gets a slab
+  // of its own, and thus an offset of zero.
+  static constexpr int kOffsetBits = 20;
+  static constexpr int kOffsetMask = (1 << kOffsetBits) - 1;
+  static constexpr int64_t kMinSlabWords = 1 << 10;
+  static constexpr int64_t kMaxSlabWords = 1 << kOffsetBits;
+  static constexpr int kMaxNumSlabs = 1 << (31 - kOffsetBits);
+
+  // Returns the memory for a clause of the given number of words, and sets
+  // ref to its reference.
+  uint32_t* Allocate(int64_t num_words, ClauseRef* ref);
+
+  std::vector<std::unique_ptr<uint32_t[]>> slabs_;
+  std::vector<std::unique_ptr<uint32_t[]>> old_slabs_;
+
+  // The clauses are allocated at the end of the last slab.
+  int64_t last_slab_capacity_ = 0;
+  int64_t last_slab_size_ = 0;
+  int64_t next_slab_capacity_ = kMinSlabWords;
+  int64_t num_used_words_ = 0;
 };
 
 class BinaryImplicationGraph;
@@ -157,7 +261,8 @@ class BinaryImplicationGraph;
 // detail.
 //
 // This class is also responsible for owning the clause memory and all related
-// information.
+// information. The clauses live in a ClauseArena: a SatClause* stays valid
+// until the next DeleteRemovedClauses(), which may relocate all the clauses.
 class ClauseManager : public SatPropagator {
  public:
   explicit ClauseManager(Model* model);
@@ -187,6 +292,7 @@ class ClauseManager : public SatPropagator {
 
   // Same as AddClause() for a removable clause. This is only called on learned
   // conflict, so this should never have all its literal at false (CHECKED).
+  // The given lbd is stored in the clause.
   SatClause* AddRemovableClause(absl::Span<const Literal> literals,
                                 Trail* trail, int lbd);
 
@@ -194,7 +300,7 @@ class ClauseManager : public SatPropagator {
   // CleanUpWatchers() is called. The later needs to be called before any other
   // function in this class can be called. This is DCHECKed.
   //
-  // Note that we remove the clause from clauses_info_ right away.
+  // Note that the clause is not removable anymore right away.
   void LazyDetach(SatClause* clause);
   void CleanUpWatchers();
 
@@ -212,6 +318,11 @@ class ClauseManager : public SatPropagator {
   // Reclaims the memory of the lazily removed clauses (their size was set to
   // zero) and remove them from AllClausesInCreationOrder() this work in
   // O(num_clauses()).
+  //
+  // When enough memory can be reclaimed, this compacts the arena, which moves
+  // the remaining clauses together in creation order: all the SatClause*
+  // obtained before are invalidated, and the watchers, the reasons and
+  // AllClausesInCreationOrder() are rewritten to point to the new clauses.
   void DeleteRemovedClauses();
   int64_t num_clauses() const { return clauses_.size(); }
   const std::vector<SatClause*>& AllClausesInCreationOrder() const {
@@ -223,11 +334,16 @@ class ClauseManager : public SatPropagator {
   // that some learned clause are kept forever (heuristics) and do not appear
   // here.
   bool IsRemovable(SatClause* const clause) const {
-    return clauses_info_.contains(clause);
+    return clause->is_removable_;
   }
-  int64_t num_removable_clauses() const { return clauses_info_.size(); }
-  absl::flat_hash_map<SatClause*, ClauseInfo>* mutable_clauses_info() {
-    return &clauses_info_;
+  int64_t num_removable_clauses() const { return num_removable_clauses_; }
+
+  // Makes sure the given clause is kept forever, i.e. IsRemovable() will be
+  // false from now on. This is a no-op if it was not removable.
+  void KeepClauseForever(SatClause* clause) {
+    if (!clause->is_removable_) return;
+    clause->is_removable_ = false;
+    --num_removable_clauses_;
   }
 
   // Total number of clauses inspected during calls to PropagateOnFalse().
@@ -300,8 +416,8 @@ class ClauseManager : public SatPropagator {
   // when the corresponding literal becomes false.
   struct Watcher {
     Watcher() = default;
-    Watcher(SatClause* c, Literal b, int i = 2)
-        : blocking_literal(b), start_index(i), clause(c) {}
+    Watcher(ClauseRef c, Literal b, int i = 2)
+        : blocking_literal(b), start_index(i), clause_ref(c) {}
 
     // Optimization. A literal from the clause that sometimes allow to not even
     // look at the clause memory when true.
@@ -314,13 +430,16 @@ class ClauseManager : public SatPropagator {
     // Watched Literals and more General Techniques", Ian P. Gent.
     //
     // Note that ideally, this should be part of a SatClause, so it can be
-    // shared across watchers. However, since we have 32 bits for "free" here
-    // because of the struct alignment, we store it here instead.
+    // shared across watchers. However, storing it here keeps the watcher to 12
+    // bytes, and it is only needed when we look at the clause anyway.
     int32_t start_index;
 
-    SatClause* clause;
+    // The watched clause, see GetClause().
+    ClauseRef clause_ref;
   };
 
+  SatClause* GetClause(ClauseRef ref) const { return arena_.Get(ref); }
+
   // This is exposed since some inprocessing code can heuristically exploit the
   // currently watched literal and blocking literal to do some simplification.
   const std::vector<Watcher>& WatcherListOnFalse(Literal false_literal) const {
@@ -358,6 +477,10 @@ class ClauseManager : public SatPropagator {
   // Common code between LazyDetach() and Detach().
   void InternalDetach(SatClause* clause);
 
+  // Relocates all the clauses of clauses_ to new memory, and reclaims the one
+  // of the removed clauses. Called by DeleteRemovedClauses().
+  void CompactArena();
+
   util_intops::StrongVector<LiteralIndex, std::vector<Watcher>>
       watchers_on_false_;
 
@@ -380,9 +503,11 @@ class ClauseManager : public SatPropagator {
   // For DetachAllClauses()/AttachAllClauses().
   bool all_clauses_are_attached_ = true;
 
-  // All the clauses currently in memory. This vector has ownership of the
-  // pointers. We currently do not use std::unique_ptr<SatClause> because it
-  // can't be used with some STL algorithms like std::partition.
+  // The memory of all the clauses.
+  ClauseArena arena_;
+
+  // All the clauses currently in memory, in creation order, which is also
+  // their order in arena_.
   //
   // Note that the unit clauses and binary clause are not kept here.
   std::vector<SatClause*> clauses_;
@@ -392,8 +517,8 @@ class ClauseManager : public SatPropagator {
   int to_first_minimize_index_ = 0;
   int to_probe_index_ = 0;
 
-  // Only contains removable clause.
-  absl::flat_hash_map<SatClause*, ClauseInfo> clauses_info_;
+  // The number of clauses for which IsRemovable() is true.
+  int64_t num_removable_clauses_ = 0;
 
   DratProofHandler* drat_proof_handler_ = nullptr;
 
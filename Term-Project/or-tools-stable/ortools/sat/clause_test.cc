@@ -68,7 +68,53 @@ struct TestSatClause {
 
 TEST(SatClauseTest, ClassSize) {
   EXPECT_EQ(4, sizeof(TestSatClause));
-  EXPECT_EQ(4, sizeof(SatClause));
+  // The size, the lbd and flags, the activity and the ClauseRef.
+  EXPECT_EQ(16, sizeof(SatClause));
+}
+
+TEST(ClauseManagerTest, DeleteRemovedClausesCompactsTheArena) {
+  Model model;
+  auto* sat_solver = model.GetOrCreate<SatSolver>();
+  auto* clause_manager = model.GetOrCreate<ClauseManager>();
+  auto* trail = model.GetOrCreate<Trail>();
+
+  // Enough clauses to span a few slabs of the arena.
+  const int num_variables = 10000;
+  sat_solver->SetNumVariables(num_variables);
+  for (int i = 1; i + 2 <= num_variables; ++i) {
+    clause_manager->AddRemovableClause(Literals({i, i + 1, i + 2}), trail,
+                                       /*lbd=*/i);
+  }
+  EXPECT_EQ(clause_manager->num_removable_clauses(), num_variables - 2);
+
+  // Remove all the clauses but one every ten.
+  const std::vector<SatClause*> clauses =
+      clause_manager->AllClausesInCreationOrder();
+  for (int i = 0; i < clauses.size(); ++i) {
+    if (i % 10 != 0) clause_manager->LazyDetach(clauses[i]);
+  }
+  clause_manager->CleanUpWatchers();
+  clause_manager->DeleteRemovedClauses();
+
+  const std::vector<SatClause*>& kept =
+      clause_manager->AllClausesInCreationOrder();
+  ASSERT_EQ(kept.size(), (clauses.size() + 9) / 10);
+  EXPECT_EQ(clause_manager->num_removable_clauses(), kept.size());
+  for (int i = 0; i < kept.size(); ++i) {
+    const int first = 10 * i + 1;
+    EXPECT_THAT(kept[i]->AsSpan(),
+                ElementsAre(Literal(first), Literal(first + 1),
+                            Literal(first + 2)));
+    EXPECT_EQ(kept[i]->lbd(), first);
+    EXPECT_TRUE(clause_manager->IsRemovable(kept[i]));
+  }
+
+  // The watchers must point to the relocated clauses.
+  sat_solver->EnqueueDecisionAndBackjumpOnConflict(Literal(-5001));
+  sat_solver->EnqueueDecisionAndBackjumpOnConflict(Literal(-5002));
+  EXPECT_TRUE(sat_solver->Assignment().LiteralIsTrue(Literal(+5003)));
+  const int trail_index = trail->Info(BooleanVariable(5002)).trail_index;
+  EXPECT_EQ(clause_manager->ReasonClause(trail_index), kept[500]);
 }
 
 BinaryClause MakeBinaryClause(int a, int b) {
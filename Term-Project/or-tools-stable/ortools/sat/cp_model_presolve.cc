@@ -9503,13 +9503,14 @@ bool CpModelPresolver::ProcessEncodingFromLinear(
   return true;
 }
 
+// The hashes are precomputed in parallel by DetectDuplicateColumns().
 struct ColumnHashForDuplicateDetection {
   explicit ColumnHashForDuplicateDetection(
-      CompactVectorVector<int, std::pair<int, int64_t>>* _column)
-      : column(_column) {}
-  std::size_t operator()(int c) const { return absl::HashOf((*column)[c]); }
+      const std::vector<std::size_t>* _hashes)
+      : hashes(_hashes) {}
+  std::size_t operator()(int c) const { return (*hashes)[c]; }
 
-  CompactVectorVector<int, std::pair<int, int64_t>>* column;
+  const std::vector<std::size_t>* hashes;
 };
 
 struct ColumnEqForDuplicateDetection {
@@ -9616,21 +9617,36 @@ void CpModelPresolver::DetectDuplicateColumns() {
   // Now construct the graph.
   var_to_columns.ResetFromFlatMapping(flat_vars, flat_terms);
 
-  // Find duplicate columns using an hash map.
   // We only consider "full" columns.
+  const auto is_full_column = [this, &var_to_columns](int var) {
+    const int size_seen = var_to_columns[var].size();
+    return size_seen != 0 &&
+           size_seen == context_->VarToConstraints(var).size();
+  };
+
+  // Hash the columns in parallel, this only reads var_to_columns.
+  std::vector<std::size_t> column_hashes(var_to_columns.size());
+  ParallelForEachRange(
+      context_->params().presolve_num_workers(), var_to_columns.size(),
+      [&](int begin, int end) {
+        for (int var = begin; var < end; ++var) {
+          if (!is_full_column(var)) continue;
+          column_hashes[var] = absl::HashOf(var_to_columns[var]);
+        }
+      });
+
+  // Find duplicate columns using an hash map.
   // var -> var_representative using columns hash/comparison.
   absl::flat_hash_map<int, int, ColumnHashForDuplicateDetection,
                       ColumnEqForDuplicateDetection>
       duplicates(
           /*capacity=*/num_vars,
-          ColumnHashForDuplicateDetection(&var_to_columns),
+          ColumnHashForDuplicateDetection(&column_hashes),
           ColumnEqForDuplicateDetection(&var_to_columns));
   std::vector<int> flat_duplicates;
   std::vector<int> flat_representatives;
   for (int var = 0; var < var_to_columns.size(); ++var) {
-    const int size_seen = var_to_columns[var].size();
-    if (size_seen == 0) continue;
-    if (size_seen != context_->VarToConstraints(var).size()) continue;
+    if (!is_full_column(var)) continue;
 
     // TODO(user): If we have duplicate columns appearing in Boolean constraint
     // we can only easily substitute if the sum of columns is a Boolean (i.e. if
@@ -9827,7 +9843,9 @@ void CpModelPresolver::DetectDuplicateConstraints() {
   // TODO(user): We might want to do that earlier so that our count of variable
   // usage is not biased by duplicate constraints.
   const std::vector<std::pair<int, int>> duplicates =
-      FindDuplicateConstraints(*context_->working_model);
+      FindDuplicateConstraints(*context_->working_model,
+                               /*ignore_enforcement=*/false,
+                               context_->params().presolve_num_workers());
   timer.AddCounter("duplicates", duplicates.size());
   for (const auto& [dup, rep] : duplicates) {
     // Note that it is important to look at the type of the representative in
@@ -9914,7 +9932,9 @@ void CpModelPresolver::DetectDuplicateConstraintsWithDifferentEnforcements(
   // cte and expr + Y = other_cte, we can see that X is in affine relation with
   // Y.
   const std::vector<std::pair<int, int>> duplicates_without_enforcement =
-      FindDuplicateConstraints(*context_->working_model, true);
+      FindDuplicateConstraints(*context_->working_model,
+                               /*ignore_enforcement=*/true,
+                               context_->params().presolve_num_workers());
   timer.AddCounter("without_enforcements",
                    duplicates_without_enforcement.size());
   for (const auto& [dup, rep] : duplicates_without_enforcement) {
@@ -14019,19 +14039,56 @@ struct ConstraintEqForDuplicateDetection {
   }
 };
 
+// Returns the hash of the constraints computed by FindDuplicateConstraints(),
+// or computes it for the objective.
+struct PrecomputedConstraintHash {
+  const std::vector<std::size_t>* hashes;
+  const ConstraintHashForDuplicateDetection* hasher;
+
+  std::size_t operator()(int ct_idx) const {
+    return ct_idx == kObjectiveConstraint ? (*hasher)(ct_idx)
+                                          : (*hashes)[ct_idx];
+  }
+};
+
 }  // namespace
 
 std::vector<std::pair<int, int>> FindDuplicateConstraints(
-    const CpModelProto& model_proto, bool ignore_enforcement) {
+    const CpModelProto& model_proto, bool ignore_enforcement,
+    int num_workers) {
   std::vector<std::pair<int, int>> result;
 
-  // We use a map hash that uses the underlying constraint to compute the hash
-  // and the equality for the indices.
-  absl::flat_hash_map<int, int, ConstraintHashForDuplicateDetection,
+  const int num_constraints = model_proto.constraints().size();
+  const auto is_candidate = [&model_proto, ignore_enforcement](int c) {
+    const auto type = model_proto.constraints(c).constraint_case();
+    if (type == ConstraintProto::CONSTRAINT_NOT_SET) return false;
+
+    // TODO(user): we could delete duplicate identical interval, but we need
+    // to make sure reference to them are updated.
+    if (type == ConstraintProto::kInterval) return false;
+
+    // Nothing we will presolve in this case.
+    if (ignore_enforcement && type == ConstraintProto::kBoolAnd) return false;
+    return true;
+  };
+
+  // Hashing the constraints is the most expensive part for large models, and
+  // it only reads the model, so we do it in parallel.
+  const ConstraintHashForDuplicateDetection hasher{&model_proto,
+                                                   ignore_enforcement};
+  std::vector<std::size_t> hashes(num_constraints);
+  ParallelForEachRange(num_workers, num_constraints, [&](int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      if (is_candidate(c)) hashes[c] = hasher(c);
+    }
+  });
+
+  // We use a map hash that uses the precomputed hash and the underlying
+  // constraint to compute the equality for the indices.
+  absl::flat_hash_map<int, int, PrecomputedConstraintHash,
                       ConstraintEqForDuplicateDetection>
       equiv_constraints(
-          model_proto.constraints_size(),
-          ConstraintHashForDuplicateDetection{&model_proto, ignore_enforcement},
+          num_constraints, PrecomputedConstraintHash{&hashes, &hasher},
           ConstraintEqForDuplicateDetection{&model_proto, ignore_enforcement});
 
   // Create a special representative for the linear objective.
@@ -14039,17 +14096,8 @@ std::vector<std::pair<int, int>> FindDuplicateConstraints(
     equiv_constraints[kObjectiveConstraint] = kObjectiveConstraint;
   }
 
-  const int num_constraints = model_proto.constraints().size();
   for (int c = 0; c < num_constraints; ++c) {
-    const auto type = model_proto.constraints(c).constraint_case();
-    if (type == ConstraintProto::CONSTRAINT_NOT_SET) continue;
-
-    // TODO(user): we could delete duplicate identical interval, but we need
-    // to make sure reference to them are updated.
-    if (type == ConstraintProto::kInterval) continue;
-
-    // Nothing we will presolve in this case.
-    if (ignore_enforcement && type == ConstraintProto::kBoolAnd) continue;
+    if (!is_candidate(c)) continue;
 
     const auto [it, inserted] = equiv_constraints.insert({c, c});
     if (it->second != c) {
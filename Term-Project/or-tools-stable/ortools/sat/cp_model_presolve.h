@@ -427,10 +427,14 @@ CpSolverStatus PresolveCpModel(PresolveContext* context,
 // - enforced constraint duplicate of non-enforced one.
 // - Two enforced constraints with singleton enforcement (vpphard).
 //
+// The constraints are hashed using up to num_workers threads, the result does
+// not depend on it.
+//
 // Visible here for testing. This is meant to be called at the end of the
 // presolve where constraints have been canonicalized.
 std::vector<std::pair<int, int>> FindDuplicateConstraints(
-    const CpModelProto& model_proto, bool ignore_enforcement = false);
+    const CpModelProto& model_proto, bool ignore_enforcement = false,
+    int num_workers = 1);
 
 }  // namespace sat
 }  // namespace operations_research
@@ -76,6 +76,7 @@
 #include "ortools/sat/lp_utils.h"
 #include "ortools/sat/model.h"
 #include "ortools/sat/parameters_validation.h"
+#include "ortools/sat/presolve_cache.h"
 #include "ortools/sat/presolve_context.h"
 #include "ortools/sat/sat_base.h"
 #include "ortools/sat/sat_inprocessing.h"
@@ -815,6 +816,14 @@ void LogFinalStatistics(SharedClasses* shared) {
     shared->clauses->LogStatistics(shared->logger);
   }
 
+  if (shared->clause_rings) {
+    shared->clause_rings->LogStatistics(shared->logger);
+  }
+
+  if (shared->remote_sharing) {
+    shared->remote_sharing->LogStatistics(shared->logger);
+  }
+
   // Extra logging if needed. Note that these are mainly activated on
   // --vmodule *some_file*=1 and are here for development.
   shared->stats->Log(shared->logger);
@@ -1762,6 +1771,14 @@ void SolveCpModelParallel(SharedClasses* shared, Model* global_model) {
   std::vector<std::unique_ptr<SubSolver>> reentrant_interleaved_subsolvers;
   std::vector<std::unique_ptr<SubSolver>> interleaved_subsolvers;
 
+  // Import what other processes learned before the synchronization below, so
+  // that it is published to our workers in the same round.
+  if (shared->remote_sharing != nullptr) {
+    subsolvers.push_back(std::make_unique<SynchronizationPoint>(
+        "remote_sharing",
+        [shared]() { shared->remote_sharing->Synchronize(); }));
+  }
+
   // Add a synchronization point for the shared classes.
   subsolvers.push_back(std::make_unique<SynchronizationPoint>(
       "synchronization_agent", [shared]() {
@@ -2182,6 +2199,18 @@ void SolveCpModelParallel(SharedClasses* shared, Model* global_model) {
   }
 
   LaunchSubsolvers(params, shared, subsolvers, name_filter.AllIgnored());
+
+  // The search can stop on a solution or a proof found after the last
+  // synchronization point, so we synchronize once more to send it to the other
+  // processes. The transport is owned by the caller and still open here.
+  if (shared->remote_sharing != nullptr) {
+    shared->response->Synchronize();
+    shared->response->MutableSolutionsRepository()->Synchronize();
+    if (shared->bounds != nullptr) {
+      shared->bounds->Synchronize();
+    }
+    shared->remote_sharing->Synchronize();
+  }
 }
 
 #endif  // __PORTABLE_PLATFORM__
@@ -2652,10 +2681,40 @@ CpSolverResponse SolveCpModel(const CpModelProto& model_proto, Model* model) {
     }
   }
 
-  // Do the actual presolve.
+  // If this exact model was already presolved with the same parameters, we
+  // reuse the result and skip the presolve and the symmetry detection.
+  const bool use_presolve_cache =
+      !params.presolve_cache_directory().empty() &&
+      !absl::GetFlag(FLAGS_debug_model_copy) &&
+      !absl::GetFlag(FLAGS_cp_model_ignore_objective) &&
+      !absl::GetFlag(FLAGS_cp_model_ignore_hints);
   std::vector<int> postsolve_mapping;
+  uint64_t presolve_cache_key = 0;
+  bool presolve_cache_hit = false;
+  if (use_presolve_cache && !context->ModelIsUnsat()) {
+    presolve_cache_key = PresolveCacheKey(model_proto, params);
+    PresolveCacheEntry* entry =
+        google::protobuf::Arena::Create<PresolveCacheEntry>(&arena);
+    const absl::StatusOr<bool> loaded = LoadPresolveCacheEntry(
+        params.presolve_cache_directory(), presolve_cache_key, entry);
+    if (!loaded.ok()) {
+      SOLVER_LOG(logger, "Ignoring presolve cache: ",
+                 loaded.status().message());
+    } else if (*loaded) {
+      presolve_cache_hit = true;
+      new_cp_model_proto->Swap(entry->mutable_presolved_model());
+      mapping_proto->Swap(entry->mutable_mapping_model());
+      postsolve_mapping.assign(entry->postsolve_mapping().begin(),
+                               entry->postsolve_mapping().end());
+      SOLVER_LOG(logger, absl::StrFormat("Presolve cache hit, key %016x.",
+                                         presolve_cache_key));
+    }
+  }
+
+  // Do the actual presolve.
   const CpSolverStatus presolve_status =
-      PresolveCpModel(context.get(), &postsolve_mapping);
+      presolve_cache_hit ? CpSolverStatus::UNKNOWN
+                         : PresolveCpModel(context.get(), &postsolve_mapping);
 
   // Delete the context as soon as the presolve is done. Note that only
   // postsolve_mapping and mapping_proto are needed for postsolve.
@@ -2684,8 +2743,10 @@ CpSolverResponse SolveCpModel(const CpModelProto& model_proto, Model* model) {
   //
   // TODO(user): We could actually report a complete feasible hint before this
   // point. But the proper fix is to report it even before the presolve.
+  //
+  // The presolved model of a cache hit already contains its symmetries.
   if (params.symmetry_level() > 1 && !params.stop_after_presolve() &&
-      !shared_time_limit->LimitReached()) {
+      !presolve_cache_hit && !shared_time_limit->LimitReached()) {
     if (params.keep_symmetry_in_presolve() &&
         new_cp_model_proto->has_symmetry()) {
       // Symmetry should be already computed and correct, so we don't redo it.
@@ -2696,6 +2757,24 @@ CpSolverResponse SolveCpModel(const CpModelProto& model_proto, Model* model) {
     }
   }
 
+  // An interrupted presolve or symmetry detection is weaker than a complete
+  // one, so we do not store it.
+  if (use_presolve_cache && !presolve_cache_hit &&
+      !shared_time_limit->LimitReached()) {
+    PresolveCacheEntry entry;
+    entry.set_key(presolve_cache_key);
+    *entry.mutable_presolved_model() = *new_cp_model_proto;
+    *entry.mutable_mapping_model() = *mapping_proto;
+    entry.mutable_postsolve_mapping()->Assign(postsolve_mapping.begin(),
+                                              postsolve_mapping.end());
+    const absl::Status status =
+        StorePresolveCacheEntry(params.presolve_cache_directory(), entry);
+    if (!status.ok()) {
+      SOLVER_LOG(logger, "Could not store the presolve in the cache: ",
+                 status.message());
+    }
+  }
+
   // TODO(user): reduce this function size and find a better place for this?
   SharedClasses shared(new_cp_model_proto, model);
 
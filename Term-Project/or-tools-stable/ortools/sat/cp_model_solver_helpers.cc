@@ -71,9 +71,11 @@
 #include "ortools/sat/optimization.h"
 #include "ortools/sat/precedences.h"
 #include "ortools/sat/probing.h"
+#include "ortools/sat/remote_sharing.h"
 #include "ortools/sat/sat_base.h"
 #include "ortools/sat/sat_parameters.pb.h"
 #include "ortools/sat/sat_solver.h"
+#include "ortools/sat/sharing_transport.h"
 #include "ortools/sat/stat_tables.h"
 #include "ortools/sat/symmetry_util.h"
 #include "ortools/sat/synchronization.h"
@@ -971,9 +973,34 @@ void RegisterClausesExport(int id, SharedClausesManager* shared_clauses_manager,
   if (!model->GetOrCreate<SatParameters>()->share_glue_clauses()) {
     return;
   }
-  auto* clause_stream = shared_clauses_manager->GetClauseStream(id);
   const int max_lbd =
       model->GetOrCreate<SatParameters>()->clause_cleanup_lbd_bound();
+  auto* clause_rings = model->Mutable<SharedClauseRings>();
+  if (clause_rings != nullptr && id < clause_rings->num_workers()) {
+    // This callback takes no lock at all, the clause is directly published on
+    // the ring of this worker.
+    auto share_clause = [mapping, clause_rings, id, max_lbd,
+                         clause = std::vector<int>()](
+                            int lbd,
+                            absl::Span<const Literal> literals) mutable {
+      if (lbd <= 0 || lbd > max_lbd ||
+          literals.size() > SharedClauseRings::kMaxClauseSize) {
+        return;
+      }
+      clause.clear();
+      for (const Literal& lit : literals) {
+        const int var =
+            mapping->GetProtoVariableFromBooleanVariable(lit.Variable());
+        if (var == -1) return;
+        clause.push_back(lit.IsPositive() ? var : NegatedRef(var));
+      }
+      clause_rings->Add(id, clause);
+    };
+    model->GetOrCreate<ClauseManager>()->SetAddClauseCallback(
+        std::move(share_clause));
+    return;
+  }
+  auto* clause_stream = shared_clauses_manager->GetClauseStream(id);
   // Note that this callback takes no global locks, everything operates on this
   // worker's own clause stream, whose lock is only used by this worker, and
   // briefly when generating a batch in SharedClausesManager::Synchronize().
@@ -1014,13 +1041,20 @@ int RegisterClausesLevelZeroImport(int id,
       model->GetOrCreate<SatParameters>()->share_glue_clauses();
   const bool minimize_shared_clauses =
       model->GetOrCreate<SatParameters>()->minimize_shared_clauses();
-  auto* clause_stream = share_glue_clauses
-                            ? shared_clauses_manager->GetClauseStream(id)
-                            : nullptr;
+  auto* clause_rings =
+      share_glue_clauses ? model->Mutable<SharedClauseRings>() : nullptr;
+  if (clause_rings != nullptr && id >= clause_rings->num_workers()) {
+    clause_rings = nullptr;
+  }
+  auto* clause_stream =
+      share_glue_clauses && clause_rings == nullptr
+          ? shared_clauses_manager->GetClauseStream(id)
+          : nullptr;
   auto* clause_manager = model->GetOrCreate<ClauseManager>();
   const auto& import_level_zero_clauses = [shared_clauses_manager, id, mapping,
                                            sat_solver, implications,
-                                           clause_stream, clause_manager,
+                                           clause_stream, clause_rings,
+                                           clause_manager,
                                            minimize_shared_clauses]() {
     std::vector<std::pair<int, int>> new_binary_clauses;
     shared_clauses_manager->GetUnseenBinaryClauses(id, &new_binary_clauses);
@@ -1033,7 +1067,20 @@ int RegisterClausesLevelZeroImport(int id,
       }
     }
     implications->EnableSharing(true);
-    if (clause_stream == nullptr) return true;
+    if (clause_stream == nullptr && clause_rings == nullptr) return true;
+
+    // The rings are read without any lock, so the clauses published since the
+    // last restart are all imported now.
+    CompactVectorVector<int> ring_clauses;
+    std::vector<absl::Span<const int>> shared_clauses;
+    if (clause_rings != nullptr) {
+      clause_rings->GetUnseenClauses(id, &ring_clauses);
+      for (int i = 0; i < ring_clauses.size(); ++i) {
+        shared_clauses.push_back(ring_clauses[i]);
+      }
+    } else {
+      shared_clauses = shared_clauses_manager->GetUnseenClauses(id);
+    }
 
     int new_clauses = 0;
     std::array<Literal, UniqueClauseStream::kMaxClauseSize> local_clause;
@@ -1041,14 +1088,15 @@ int RegisterClausesLevelZeroImport(int id,
     // Temporarily disable clause sharing so we don't immediately re-export the
     // clauses we just imported.
     auto callback = clause_manager->TakeAddClauseCallback();
-    for (const absl::Span<const int> shared_clause :
-         shared_clauses_manager->GetUnseenClauses(id)) {
+    for (const absl::Span<const int> shared_clause : shared_clauses) {
       // Check this clause was not already learned by this worker.
       // We can delete the fingerprint because we should not learn an identical
       // clause, and the global stream will not emit the same clause while any
       // worker hasn't consumed this clause (and thus also shouldn't relearn the
       // clause).
-      if (clause_stream->Delete(shared_clause)) continue;
+      if (clause_stream != nullptr && clause_stream->Delete(shared_clause)) {
+        continue;
+      }
       for (int i = 0; i < shared_clause.size(); ++i) {
         local_clause[i] = mapping->Literal(shared_clause[i]);
       }
@@ -1059,7 +1107,7 @@ int RegisterClausesLevelZeroImport(int id,
       ++new_clauses;
     }
     clause_manager->SetAddClauseCallback(std::move(callback));
-    clause_stream->RemoveWorstClauses();
+    if (clause_stream != nullptr) clause_stream->RemoveWorstClauses();
     if (minimize_shared_clauses && new_clauses > 0) {
       // The new clauses may be subsumed, so try to minimize them to reduce
       // overhead of sharing.
@@ -2009,9 +2057,24 @@ SharedClasses::SharedClasses(const CpModelProto* proto, Model* global_model)
   const bool always_synchronize =
       !params.interleave_search() || params.num_workers() <= 1;
   response->SetSynchronizationMode(always_synchronize);
+  // Shares with other processes if a transport was registered.
+  SharingTransport* transport = global_model->Mutable<SharingTransport>();
+  const bool use_remote_sharing =
+      transport != nullptr && params.num_workers() > 1;
   if (params.share_binary_clauses() && params.num_workers() > 1) {
     clauses = std::make_unique<SharedClausesManager>(always_synchronize,
                                                      absl::Seconds(1));
+    if (params.share_glue_clauses() && params.share_glue_clauses_lock_free()) {
+      // The remote sharing registers its id before all the workers, so it
+      // needs a ring too.
+      clause_rings = std::make_unique<SharedClauseRings>(
+          params.num_workers() + (use_remote_sharing ? 1 : 0));
+    }
+  }
+  if (use_remote_sharing) {
+    remote_sharing = std::make_unique<RemoteSharing>(
+        model_proto, response, bounds.get(), clauses.get(), clause_rings.get(),
+        transport, logger);
   }
 }
 
@@ -2038,6 +2101,9 @@ void SharedClasses::RegisterSharedClassesInLocalModel(Model* local_model) {
   if (clauses != nullptr) {
     local_model->Register<SharedClausesManager>(clauses.get());
   }
+  if (clause_rings != nullptr) {
+    local_model->Register<SharedClauseRings>(clause_rings.get());
+  }
 }
 
 bool SharedClasses::SearchIsDone() {
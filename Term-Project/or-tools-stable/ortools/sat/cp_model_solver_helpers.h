@@ -27,6 +27,7 @@
 #include "ortools/sat/cp_model.pb.h"
 #include "ortools/sat/integer_base.h"
 #include "ortools/sat/model.h"
+#include "ortools/sat/remote_sharing.h"
 #include "ortools/sat/sat_parameters.pb.h"
 #include "ortools/sat/stat_tables.h"
 #include "ortools/sat/synchronization.h"
@@ -68,6 +69,8 @@ struct SharedClasses {
   std::unique_ptr<SharedLPSolutionRepository> lp_solutions;
   std::unique_ptr<SharedIncompleteSolutionManager> incomplete_solutions;
   std::unique_ptr<SharedClausesManager> clauses;
+  std::unique_ptr<SharedClauseRings> clause_rings;
+  std::unique_ptr<RemoteSharing> remote_sharing;
 
   // call local_model->Register() on most of the class here, this allow to
   // more easily depends on one of the shared class deep within the solver.
@@ -0,0 +1,171 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/presolve_cache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "absl/random/distributions.h"
+#include "absl/random/random.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/message.h"
+#include "ortools/base/hash.h"
+#if !defined(__PORTABLE_PLATFORM__)
+#include "ortools/base/helpers.h"
+#include "ortools/base/options.h"
+#endif  // __PORTABLE_PLATFORM__
+#include "ortools/base/version.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/presolve_cache.pb.h"
+#include "ortools/sat/sat_parameters.pb.h"
+
+namespace operations_research {
+namespace sat {
+
+namespace {
+
+// Changing this invalidates all the existing entries. It must be increased
+// whenever the meaning of PresolveCacheEntry changes.
+constexpr uint64_t kPresolveCacheFormatVersion = 1;
+
+uint64_t FingerprintMessage(const google::protobuf::Message& message,
+                            uint64_t seed) {
+  // The default serialization does not guarantee the same bytes for equal
+  // messages, so we ask for a deterministic one.
+  std::string bytes;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&bytes);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    message.SerializeToCodedStream(&coded_stream);
+  }
+  return fasthash64(bytes.data(), bytes.size(), seed);
+}
+
+bool HasNames(const CpModelProto& model_proto) {
+  if (!model_proto.name().empty()) return true;
+  for (const IntegerVariableProto& var : model_proto.variables()) {
+    if (!var.name().empty()) return true;
+  }
+  for (const ConstraintProto& ct : model_proto.constraints()) {
+    if (!ct.name().empty()) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+uint64_t PresolveCacheKey(const CpModelProto& model_proto,
+                          const SatParameters& params) {
+  // These parameters do not change the result of a presolve that is not
+  // interrupted, and the interrupted ones are not cached.
+  SatParameters normalized_params = params;
+  normalized_params.clear_max_time_in_seconds();
+  normalized_params.clear_max_deterministic_time();
+  normalized_params.clear_log_search_progress();
+  normalized_params.clear_log_subsolver_statistics();
+  normalized_params.clear_log_prefix();
+  normalized_params.clear_log_to_stdout();
+  normalized_params.clear_log_to_response();
+  normalized_params.clear_presolve_cache_directory();
+  normalized_params.clear_presolve_num_workers();
+
+  const std::string version = OrToolsVersionString();
+  uint64_t key = fasthash64(version.data(), version.size(),
+                            kPresolveCacheFormatVersion);
+  key = FingerprintMessage(normalized_params, key);
+
+  // The names do not change the presolve, so we ignore them. We only copy the
+  // model if needed since it can be large.
+  if (!HasNames(model_proto)) return FingerprintMessage(model_proto, key);
+  CpModelProto unnamed_model = model_proto;
+  unnamed_model.clear_name();
+  for (IntegerVariableProto& var : *unnamed_model.mutable_variables()) {
+    var.clear_name();
+  }
+  for (ConstraintProto& ct : *unnamed_model.mutable_constraints()) {
+    ct.clear_name();
+  }
+  return FingerprintMessage(unnamed_model, key);
+}
+
+std::string PresolveCacheFilename(absl::string_view directory, uint64_t key) {
+  return absl::StrFormat("%s/%016x.presolve", directory, key);
+}
+
+#if !defined(__PORTABLE_PLATFORM__)
+
+absl::StatusOr<bool> LoadPresolveCacheEntry(absl::string_view directory,
+                                            uint64_t key,
+                                            PresolveCacheEntry* entry) {
+  const std::string filename = PresolveCacheFilename(directory, key);
+  if (!file::Exists(filename, file::Defaults()).ok()) return false;
+  const absl::Status status =
+      file::GetBinaryProto(filename, entry, file::Defaults());
+  if (!status.ok()) return status;
+  if (entry->key() != key) {
+    return absl::DataLossError(absl::StrCat(
+        "The presolve cache file '", filename, "' has the wrong key."));
+  }
+  return true;
+}
+
+absl::Status StorePresolveCacheEntry(absl::string_view directory,
+                                     const PresolveCacheEntry& entry) {
+  const std::string filename = PresolveCacheFilename(directory, entry.key());
+
+  // The temporary file is in the same directory so that the rename is atomic.
+  absl::BitGen random;
+  const std::string tmp_filename = absl::StrFormat(
+      "%s.%016x.tmp", filename, absl::Uniform<uint64_t>(random));
+  const absl::Status status =
+      file::SetBinaryProto(tmp_filename, entry, file::Defaults());
+  if (!status.ok()) {
+    file::Delete(tmp_filename, file::Defaults()).IgnoreError();
+    return status;
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    file::Delete(tmp_filename, file::Defaults()).IgnoreError();
+    return absl::InternalError(
+        absl::StrCat("Could not rename '", tmp_filename, "' to '", filename,
+                     "'."));
+  }
+  return absl::OkStatus();
+}
+
+#else  // __PORTABLE_PLATFORM__
+
+absl::StatusOr<bool> LoadPresolveCacheEntry(absl::string_view, uint64_t,
+                                            PresolveCacheEntry*) {
+  return absl::UnimplementedError(
+      "The presolve cache is not supported on this platform.");
+}
+
+absl::Status StorePresolveCacheEntry(absl::string_view,
+                                     const PresolveCacheEntry&) {
+  return absl::UnimplementedError(
+      "The presolve cache is not supported on this platform.");
+}
+
+#endif  // __PORTABLE_PLATFORM__
+
+}  // namespace sat
+}  // namespace operations_research
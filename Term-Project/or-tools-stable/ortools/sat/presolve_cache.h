@@ -0,0 +1,69 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// An on-disk cache of the presolve results, so that solving again a model that
+// was already solved with the same parameters can skip the presolve and the
+// symmetry detection. See SatParameters.presolve_cache_directory.
+//
+// There is one file per entry, named after the key of the entry. The files
+// are written atomically, so several processes can share the same directory.
+// Nothing is ever removed from the directory by the solver.
+
+#ifndef OR_TOOLS_SAT_PRESOLVE_CACHE_H_
+#define OR_TOOLS_SAT_PRESOLVE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/presolve_cache.pb.h"
+#include "ortools/sat/sat_parameters.pb.h"
+
+namespace operations_research {
+namespace sat {
+
+// Returns the key of the presolve of the given model with the given
+// parameters. It depends on the whole model except the names, including the
+// order of the variables and constraints, the hints and the assumptions. It
+// also depends on all the parameters except the time limits and the ones that
+// only control the logging, and on the OR-Tools version so that the entries
+// written by another version are never used.
+//
+// Note that the models are not reordered: the same model with its constraints
+// in a different order has a different key.
+uint64_t PresolveCacheKey(const CpModelProto& model_proto,
+                          const SatParameters& params);
+
+// The path of the file of the entry with the given key.
+std::string PresolveCacheFilename(absl::string_view directory, uint64_t key);
+
+// Reads the entry with the given key in entry. Returns false if there is no
+// such entry, and an error if the file cannot be read or is not a valid entry
+// for this key.
+absl::StatusOr<bool> LoadPresolveCacheEntry(absl::string_view directory,
+                                            uint64_t key,
+                                            PresolveCacheEntry* entry);
+
+// Writes the entry in the file named after entry.key(). The entry is first
+// written in a temporary file which is then renamed, so that a concurrent
+// LoadPresolveCacheEntry() never sees a partial file.
+absl::Status StorePresolveCacheEntry(absl::string_view directory,
+                                     const PresolveCacheEntry& entry);
+
+}  // namespace sat
+}  // namespace operations_research
+
+#endif  // OR_TOOLS_SAT_PRESOLVE_CACHE_H_
@@ -0,0 +1,252 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/presolve_cache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+#include "ortools/base/filesystem.h"
+#include "ortools/base/gmock.h"
+#include "ortools/base/helpers.h"
+#include "ortools/base/options.h"
+#include "ortools/base/parse_test_proto.h"
+#include "ortools/base/path.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_checker.h"
+#include "ortools/sat/cp_model_solver.h"
+#include "ortools/sat/presolve_cache.pb.h"
+#include "ortools/sat/sat_parameters.pb.h"
+
+namespace operations_research {
+namespace sat {
+namespace {
+
+using ::google::protobuf::contrib::parse_proto::ParseTestProto;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::EqualsProto;
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+CpModelProto SmallModel() {
+  return ParseTestProto(R"pb(
+    variables { domain: [ 0, 10 ] }
+    variables { domain: [ 0, 10 ] }
+    constraints {
+      linear {
+        vars: [ 0, 1 ]
+        coeffs: [ 1, 1 ]
+        domain: [ 5, 5 ]
+      }
+    }
+  )pb");
+}
+
+// Returns a directory under the test temporary directory, without the cache
+// entries of a previous run.
+std::string EmptyDirectory(absl::string_view name) {
+  const std::string directory = file::JoinPath(::testing::TempDir(), name);
+  CHECK_OK(file::RecursivelyCreateDir(directory, file::Defaults()));
+  std::vector<std::string> old_entries;
+  CHECK_OK(file::Match(file::JoinPath(directory, "*"), &old_entries,
+                       file::Defaults()));
+  for (const std::string& old_entry : old_entries) {
+    CHECK_OK(file::Delete(old_entry, file::Defaults()));
+  }
+  return directory;
+}
+
+TEST(PresolveCacheKeyTest, IgnoresTimeLimitsAndLogging) {
+  const CpModelProto model = SmallModel();
+  SatParameters params;
+  const uint64_t key = PresolveCacheKey(model, params);
+  EXPECT_EQ(key, PresolveCacheKey(model, params));
+
+  params.set_max_time_in_seconds(10.0);
+  params.set_log_search_progress(true);
+  params.set_presolve_cache_directory("/tmp");
+  EXPECT_EQ(key, PresolveCacheKey(model, params));
+
+  params.set_cp_model_probing_level(0);
+  EXPECT_NE(key, PresolveCacheKey(model, params));
+}
+
+TEST(PresolveCacheKeyTest, IgnoresNames) {
+  const CpModelProto model = SmallModel();
+  const SatParameters params;
+  const uint64_t key = PresolveCacheKey(model, params);
+
+  CpModelProto other = model;
+  other.set_name("other");
+  other.mutable_variables(0)->set_name("x");
+  other.mutable_constraints(0)->set_name("sum");
+  EXPECT_EQ(key, PresolveCacheKey(other, params));
+}
+
+TEST(PresolveCacheKeyTest, DependsOnTheRestOfTheModel) {
+  const CpModelProto model = SmallModel();
+  const SatParameters params;
+  const uint64_t key = PresolveCacheKey(model, params);
+
+  CpModelProto other = model;
+  other.mutable_variables(1)->set_domain(1, 9);
+  EXPECT_NE(key, PresolveCacheKey(other, params));
+
+  other = model;
+  other.mutable_solution_hint()->add_vars(0);
+  other.mutable_solution_hint()->add_values(5);
+  EXPECT_NE(key, PresolveCacheKey(other, params));
+}
+
+TEST(PresolveCacheTest, StoreAndLoad) {
+  const std::string directory = EmptyDirectory("presolve_cache_store");
+  const uint64_t key = PresolveCacheKey(SmallModel(), SatParameters());
+
+  PresolveCacheEntry entry;
+  absl::StatusOr<bool> loaded = LoadPresolveCacheEntry(directory, key, &entry);
+  ASSERT_TRUE(loaded.ok());
+  EXPECT_FALSE(*loaded);
+
+  entry.set_key(key);
+  *entry.mutable_presolved_model() = SmallModel();
+  entry.mutable_mapping_model()->add_variables()->add_domain(3);
+  entry.add_postsolve_mapping(1);
+  entry.add_postsolve_mapping(0);
+  ASSERT_TRUE(StorePresolveCacheEntry(directory, entry).ok());
+
+  PresolveCacheEntry read;
+  loaded = LoadPresolveCacheEntry(directory, key, &read);
+  ASSERT_TRUE(loaded.ok());
+  EXPECT_TRUE(*loaded);
+  EXPECT_THAT(read, EqualsProto(entry));
+  EXPECT_THAT(read.postsolve_mapping(), ElementsAre(1, 0));
+}
+
+TEST(PresolveCacheTest, DetectsAMisplacedEntry) {
+  const std::string directory = EmptyDirectory("presolve_cache_misplaced");
+  PresolveCacheEntry entry;
+  entry.set_key(12345);
+  ASSERT_TRUE(file::SetBinaryProto(PresolveCacheFilename(directory, 54321),
+                                   entry, file::Defaults())
+                  .ok());
+
+  PresolveCacheEntry read;
+  const absl::StatusOr<bool> loaded =
+      LoadPresolveCacheEntry(directory, 54321, &read);
+  EXPECT_EQ(loaded.status().code(), absl::StatusCode::kDataLoss);
+}
+
+// Maximum independent set on a cycle, which has symmetries and is not solved
+// by the presolve.
+CpModelProto CycleModel(int num_nodes) {
+  CpModelProto model;
+  for (int i = 0; i < num_nodes; ++i) {
+    IntegerVariableProto* var = model.add_variables();
+    var->add_domain(0);
+    var->add_domain(1);
+    model.mutable_objective()->add_vars(i);
+    model.mutable_objective()->add_coeffs(-1);
+  }
+  for (int i = 0; i < num_nodes; ++i) {
+    LinearConstraintProto* linear = model.add_constraints()->mutable_linear();
+    linear->add_vars(i);
+    linear->add_coeffs(1);
+    linear->add_vars((i + 1) % num_nodes);
+    linear->add_coeffs(1);
+    linear->add_domain(0);
+    linear->add_domain(1);
+  }
+  return model;
+}
+
+TEST(PresolveCacheTest, SecondSolveSkipsPresolveAndSymmetries) {
+  const std::string directory = EmptyDirectory("presolve_cache_solve");
+
+  const CpModelProto model = CycleModel(10);
+  SatParameters params;
+  params.set_num_workers(1);
+  params.set_symmetry_level(2);
+  params.set_log_search_progress(true);
+  params.set_log_to_stdout(false);
+  params.set_log_to_response(true);
+  params.set_presolve_cache_directory(directory);
+
+  const CpSolverResponse first = SolveWithParameters(model, params);
+  ASSERT_EQ(first.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_EQ(first.objective_value(), -5);
+  EXPECT_THAT(first.solve_log(), Not(HasSubstr("Presolve cache hit")));
+  EXPECT_THAT(first.solve_log(), HasSubstr("[Symmetry]"));
+
+  const CpSolverResponse second = SolveWithParameters(model, params);
+  ASSERT_EQ(second.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_EQ(second.objective_value(), first.objective_value());
+  EXPECT_TRUE(SolutionIsFeasible(model, second.solution()));
+  EXPECT_THAT(second.solve_log(), HasSubstr("Presolve cache hit"));
+  EXPECT_THAT(second.solve_log(), Not(HasSubstr("[Symmetry]")));
+}
+
+TEST(PresolveCacheTest, CacheHitGivesTheSameSolutionAsAColdSolve) {
+  const std::string directory = EmptyDirectory("presolve_cache_hint");
+
+  // A feasible but not optimal hint, which the presolve must carry over to
+  // the cached model.
+  CpModelProto model = CycleModel(12);
+  for (int i = 0; i < 12; ++i) {
+    model.mutable_solution_hint()->add_vars(i);
+    model.mutable_solution_hint()->add_values(i % 4 == 0 ? 1 : 0);
+  }
+  SatParameters params;
+  params.set_num_workers(1);
+  params.set_symmetry_level(2);
+  params.set_log_search_progress(true);
+  params.set_log_to_stdout(false);
+  params.set_log_to_response(true);
+
+  const CpSolverResponse without_cache = SolveWithParameters(model, params);
+  ASSERT_EQ(without_cache.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_EQ(without_cache.objective_value(), -6);
+
+  params.set_presolve_cache_directory(directory);
+  const CpSolverResponse cold = SolveWithParameters(model, params);
+  ASSERT_EQ(cold.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_THAT(cold.solve_log(), Not(HasSubstr("Presolve cache hit")));
+  EXPECT_THAT(cold.solve_log(), HasSubstr("[Symmetry]"));
+
+  const CpSolverResponse hit = SolveWithParameters(model, params);
+  ASSERT_EQ(hit.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_THAT(hit.solve_log(), HasSubstr("Presolve cache hit"));
+  EXPECT_THAT(hit.solve_log(), Not(HasSubstr("[Symmetry]")));
+
+  // The search runs on the same presolved model, with the same hint and
+  // symmetries, so it finds the same solution, which is postsolved the same
+  // way.
+  for (const CpSolverResponse* response : {&cold, &hit}) {
+    EXPECT_EQ(response->objective_value(), without_cache.objective_value());
+    EXPECT_EQ(response->best_objective_bound(),
+              without_cache.best_objective_bound());
+    EXPECT_THAT(response->solution(),
+                ElementsAreArray(without_cache.solution()));
+    EXPECT_TRUE(SolutionIsFeasible(model, response->solution()));
+  }
+}
+
+}  // namespace
+}  // namespace sat
+}  // namespace operations_research
@@ -17,6 +17,7 @@
 #include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <limits>
 #include <string>
 #include <tuple>
@@ -33,6 +34,7 @@
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
 #include "ortools/base/strong_vector.h"
+#include "ortools/base/threadpool.h"
 #include "ortools/sat/cp_model.pb.h"
 #include "ortools/sat/cp_model_utils.h"
 #include "ortools/sat/util.h"
@@ -739,5 +741,30 @@ bool FindSingleLinearDifference(const LinearConstraintProto& lin1,
   return *coeff1 != 0 && *coeff2 != 0;
 }
 
+void ParallelForEachRange(int num_workers, int size,
+                          const std::function<void(int, int)>& f) {
+  // Below this range size, starting a thread costs more than it saves.
+  constexpr int kMinRangeSize = 4096;
+  const int num_ranges = std::min(num_workers, size / kMinRangeSize);
+  if (num_ranges <= 1) {
+    if (size > 0) f(0, size);
+    return;
+  }
+
+  // The current thread processes the last range while the pool does the
+  // others. The pool destructor waits for all of them.
+  const auto range_begin = [size, num_ranges](int i) {
+    return static_cast<int>(static_cast<int64_t>(size) * i / num_ranges);
+  };
+  ThreadPool pool(num_ranges - 1);
+  pool.StartWorkers();
+  for (int i = 0; i + 1 < num_ranges; ++i) {
+    const int begin = range_begin(i);
+    const int end = range_begin(i + 1);
+    pool.Schedule([&f, begin, end]() { f(begin, end); });
+  }
+  f(range_begin(num_ranges - 1), size);
+}
+
 }  // namespace sat
 }  // namespace operations_research
@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -408,6 +409,16 @@ inline bool LinearsDifferAtOneTerm(const LinearConstraintProto& lin1,
   return FindSingleLinearDifference(lin1, lin2, &var1, &coeff1, &var2, &coeff2);
 }
 
+// Calls f(begin, end) on consecutive ranges that cover [0, size), using up to
+// num_workers threads, and returns when all calls are done. Small sizes are
+// processed in a single call from the current thread.
+//
+// This is meant for the read-only scans of the presolve, so f must only write
+// to data indexed by its range. The result then does not depend on the number
+// of workers.
+void ParallelForEachRange(int num_workers, int size,
+                          const std::function<void(int, int)>& f);
+
 }  // namespace sat
 }  // namespace operations_research
 
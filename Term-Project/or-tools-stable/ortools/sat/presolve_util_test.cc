@@ -15,11 +15,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <array>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/random/distributions.h"
 #include "absl/random/random.h"
 #include "absl/types/span.h"
 #include "gtest/gtest.h"
@@ -28,8 +30,11 @@
 #include "ortools/base/parse_test_proto.h"
 #include "ortools/sat/cp_model.h"
 #include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_presolve.h"
 #include "ortools/sat/cp_model_solver.h"
 #include "ortools/sat/cp_model_utils.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/presolve_context.h"
 #include "ortools/sat/sat_parameters.pb.h"
 #include "ortools/util/sorted_interval_list.h"
 
@@ -39,6 +44,7 @@ namespace {
 
 using ::google::protobuf::contrib::parse_proto::ParseTestProto;
 using ::testing::ElementsAre;
+using ::testing::EqualsProto;
 
 TEST(DomainDeductionsTest, BasicTest) {
   DomainDeductions deductions;
@@ -524,6 +530,122 @@ TEST(VectorWithSparseUsageTest, RandomTest) {
   }
 }
 
+TEST(ParallelForEachRangeTest, CoversEachIndexOnce) {
+  for (const int num_workers : {1, 2, 3, 8}) {
+    for (const int size : {0, 1, 4095, 4096, 10000, 100003}) {
+      std::vector<int> count(size, 0);
+      ParallelForEachRange(num_workers, size, [&count](int begin, int end) {
+        ASSERT_LE(begin, end);
+        for (int i = begin; i < end; ++i) ++count[i];
+      });
+      EXPECT_EQ(std::count(count.begin(), count.end(), 1), size)
+          << num_workers << " " << size;
+    }
+  }
+}
+
+// Enough constraints for FindDuplicateConstraints() to hash them on several
+// threads. Every third constraint is a copy of the previous one, with its
+// terms in the same order.
+CpModelProto ModelWithDuplicateConstraints(int num_constraints) {
+  CpModelProto model_proto;
+  for (int i = 0; i < 100; ++i) {
+    IntegerVariableProto* var = model_proto.add_variables();
+    var->add_domain(0);
+    var->add_domain(10);
+  }
+  absl::BitGen random;
+  for (int c = 0; c < num_constraints; ++c) {
+    if (c % 3 == 2) {
+      *model_proto.add_constraints() = model_proto.constraints(c - 1);
+      continue;
+    }
+    LinearConstraintProto* linear =
+        model_proto.add_constraints()->mutable_linear();
+    const int var = absl::Uniform(random, 0, 99);
+    linear->add_vars(var);
+    linear->add_coeffs(absl::Uniform(random, 1, 4));
+    linear->add_vars(var + 1);
+    linear->add_coeffs(absl::Uniform(random, 1, 4));
+    linear->add_domain(0);
+    linear->add_domain(absl::Uniform(random, 1, 20));
+  }
+  return model_proto;
+}
+
+TEST(FindDuplicateConstraintsTest, SameResultWithSeveralWorkers) {
+  const CpModelProto model_proto = ModelWithDuplicateConstraints(10000);
+  const std::vector<std::pair<int, int>> duplicates =
+      FindDuplicateConstraints(model_proto, /*ignore_enforcement=*/false,
+                               /*num_workers=*/1);
+  EXPECT_GE(duplicates.size(), 3333);
+  EXPECT_EQ(duplicates,
+            FindDuplicateConstraints(model_proto, /*ignore_enforcement=*/false,
+                                     /*num_workers=*/4));
+}
+
+// Enough variables for DetectDuplicateColumns() to hash the columns on several
+// threads. In each block of four variables, the first two have the same
+// column.
+CpModelProto ModelWithDuplicateColumns(int num_blocks) {
+  CpModelProto model_proto;
+  for (int i = 0; i < 4 * num_blocks; ++i) {
+    IntegerVariableProto* var = model_proto.add_variables();
+    var->add_domain(0);
+    var->add_domain(3);
+    model_proto.mutable_objective()->add_vars(i);
+    model_proto.mutable_objective()->add_coeffs(1);
+  }
+  absl::BitGen random;
+  for (int block = 0; block < num_blocks; ++block) {
+    const int a = 4 * block;
+    const int coeff = absl::Uniform(random, 1, 4);
+    LinearConstraintProto* first =
+        model_proto.add_constraints()->mutable_linear();
+    for (const int var : {a, a + 1, a + 2}) {
+      first->add_vars(var);
+      first->add_coeffs(var == a + 2 ? 2 : coeff);
+    }
+    first->add_domain(0);
+    first->add_domain(5);
+    LinearConstraintProto* second =
+        model_proto.add_constraints()->mutable_linear();
+    for (const int var : {a, a + 1, a + 3}) {
+      second->add_vars(var);
+      second->add_coeffs(1);
+    }
+    second->add_domain(1);
+    second->add_domain(9);
+  }
+  return model_proto;
+}
+
+TEST(DetectDuplicateColumnsTest, SameResultWithSeveralWorkers) {
+  const CpModelProto model_proto = ModelWithDuplicateColumns(3000);
+  std::vector<CpModelProto> working_models;
+  std::vector<CpModelProto> mapping_models;
+  for (const int num_workers : {1, 4}) {
+    CpModelProto working_model = model_proto;
+    CpModelProto mapping_model;
+    Model model;
+    model.GetOrCreate<SatParameters>()->set_presolve_num_workers(num_workers);
+    PresolveContext context(&model, &working_model, &mapping_model);
+    context.InitializeNewDomains();
+    context.ReadObjectiveFromProto();
+    context.UpdateNewConstraintsVariableUsage();
+    std::vector<int> postsolve_mapping;
+    CpModelPresolver presolver(&context, &postsolve_mapping);
+    presolver.DetectDuplicateColumns();
+    context.WriteVariableDomainsToProto();
+    working_models.push_back(working_model);
+    mapping_models.push_back(mapping_model);
+  }
+  // Each block gets a new variable for the sum of its first two.
+  EXPECT_EQ(working_models[0].variables_size(), 5 * 3000);
+  EXPECT_THAT(working_models[1], EqualsProto(working_models[0]));
+  EXPECT_THAT(mapping_models[1], EqualsProto(mapping_models[0]));
+}
+
 }  // namespace
 }  // namespace sat
 }  // namespace operations_research
@@ -832,7 +832,8 @@ bool FailedLiteralProbingRound(ProbingOptions options, Model* model) {
       for (const auto& w :
            clause_manager->WatcherListOnFalse(last_decision.Negated())) {
         if (assignment.LiteralIsTrue(w.blocking_literal)) {
-          if (w.clause->IsRemoved()) continue;
+          SatClause* clause = clause_manager->GetClause(w.clause_ref);
+          if (clause->IsRemoved()) continue;
           CHECK_NE(w.blocking_literal, last_decision.Negated());
 
           // Add the binary clause if needed. Note that we change the reason
@@ -861,7 +862,7 @@ bool FailedLiteralProbingRound(ProbingOptions options, Model* model) {
           }
 
           ++num_new_subsumed;
-          clause_manager->LazyDetach(w.clause);
+          clause_manager->LazyDetach(clause);
         }
       }
     }
@@ -0,0 +1,243 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/remote_sharing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_utils.h"
+#include "ortools/sat/integer_base.h"
+#include "ortools/sat/remote_sharing.pb.h"
+#include "ortools/sat/sharing_transport.h"
+#include "ortools/sat/synchronization.h"
+#include "ortools/sat/util.h"
+#include "ortools/util/logging.h"
+
+namespace operations_research {
+namespace sat {
+
+RemoteSharing::RemoteSharing(const CpModelProto& model_proto,
+                             SharedResponseManager* response,
+                             SharedBoundsManager* bounds,
+                             SharedClausesManager* clauses,
+                             SharedClauseRings* clause_rings,
+                             SharingTransport* transport, SolverLogger* logger)
+    : num_variables_(model_proto.variables_size()),
+      has_objective_(model_proto.has_objective()),
+      model_fingerprint_(FingerprintModel(model_proto)),
+      response_(response),
+      bounds_(bounds),
+      clauses_(clauses),
+      clause_rings_(clauses != nullptr ? clause_rings : nullptr),
+      transport_(transport),
+      logger_(logger) {
+  CHECK(response_ != nullptr);
+  CHECK(transport_ != nullptr);
+  if (bounds_ != nullptr) bounds_id_ = bounds_->RegisterNewId();
+  if (clauses_ != nullptr) {
+    clauses_id_ = clauses_->RegisterNewId();
+    clauses_->SetWorkerNameForId(clauses_id_, "remote");
+  }
+  if (clause_rings_ != nullptr) {
+    CHECK_LT(clauses_id_, clause_rings_->num_workers());
+  }
+}
+
+void RemoteSharing::Synchronize() {
+  if (!connected_) return;
+  RemoteSharingMessage message;
+  while (true) {
+    const absl::StatusOr<bool> received = transport_->Receive(&buffer_);
+    if (!received.ok()) return Disconnect(received.status());
+    if (!*received) break;
+    ++num_messages_received_;
+    num_bytes_received_ += buffer_.size();
+    if (!message.ParseFromString(buffer_) ||
+        message.model_fingerprint() != model_fingerprint_) {
+      ++num_messages_ignored_;
+      continue;
+    }
+    Import(message);
+  }
+  Export();
+}
+
+void RemoteSharing::Import(const RemoteSharingMessage& message) {
+  // The solution goes first, so that the lower bound below never crosses our
+  // best solution.
+  if (message.solution_size() == num_variables_) {
+    const auto solution = response_->NewSolution(message.solution(), "remote");
+    best_rank_sent_ = std::min(best_rank_sent_, solution->rank);
+    ++num_solutions_imported_;
+  }
+  if (has_objective_ && message.has_inner_objective_lower_bound()) {
+    lower_bound_sent_ =
+        std::max(lower_bound_sent_, message.inner_objective_lower_bound());
+    response_->UpdateInnerObjectiveBounds(
+        "remote", IntegerValue(message.inner_objective_lower_bound()),
+        kMaxIntegerValue);
+  }
+  if (message.improving_problem_is_infeasible()) {
+    solved_sent_ = true;
+    response_->NotifyThatImprovingProblemIsInfeasible("remote");
+  }
+
+  if (bounds_ != nullptr && message.bounds_variables_size() > 0 &&
+      message.bounds_lower_size() == message.bounds_variables_size() &&
+      message.bounds_upper_size() == message.bounds_variables_size() &&
+      absl::c_all_of(message.bounds_variables(), [this](int var) {
+        return var >= 0 && var < num_variables_;
+      })) {
+    bounds_->ReportPotentialNewBounds("remote", message.bounds_variables(),
+                                      message.bounds_lower(),
+                                      message.bounds_upper());
+  }
+
+  if (clauses_ == nullptr) return;
+  for (int i = 0; i + 1 < message.binary_clauses_size(); i += 2) {
+    const int lit1 = message.binary_clauses(i);
+    const int lit2 = message.binary_clauses(i + 1);
+    if (!IsValidLiteral(lit1) || !IsValidLiteral(lit2)) continue;
+    clauses_->AddBinaryClause(clauses_id_, lit1, lit2);
+    ++num_clauses_imported_;
+  }
+  UniqueClauseStream* stream = clauses_->GetClauseStream(clauses_id_);
+  const absl::Span<const int> literals = message.clause_literals();
+  int start = 0;
+  for (const int size : message.clause_sizes()) {
+    if (size < 0 || start + size > literals.size()) break;
+    const absl::Span<const int> clause = literals.subspan(start, size);
+    start += size;
+    if (!absl::c_all_of(clause, [this](int l) { return IsValidLiteral(l); })) {
+      continue;
+    }
+    if (imported_clauses_.size() >= kMaxImportedClauses) {
+      imported_clauses_.clear();
+    }
+    imported_clauses_.insert(UniqueClauseStream::HashClause(clause));
+    // The workers with a ring only read the rings, and the others only read
+    // the batches of the clauses manager.
+    bool imported = stream->Add(clause);
+    if (clause_rings_ != nullptr) {
+      imported |= clause_rings_->Add(clauses_id_, clause);
+    }
+    if (imported) ++num_clauses_imported_;
+  }
+}
+
+void RemoteSharing::Export() {
+  RemoteSharingMessage message;
+  const SharedSolutionRepository<int64_t>& solutions =
+      response_->SolutionsRepository();
+  if (solutions.NumSolutions() > 0) {
+    const auto best = solutions.GetSolution(0);
+    if (best->rank < best_rank_sent_) {
+      best_rank_sent_ = best->rank;
+      message.mutable_solution()->Assign(best->variable_values.begin(),
+                                         best->variable_values.end());
+    }
+  }
+  if (has_objective_) {
+    const int64_t lower_bound =
+        response_->GetInnerObjectiveLowerBound().value();
+    if (lower_bound > lower_bound_sent_) {
+      lower_bound_sent_ = lower_bound;
+      message.set_inner_objective_lower_bound(lower_bound);
+    }
+  }
+  if (!solved_sent_ && response_->ProblemIsSolved()) {
+    solved_sent_ = true;
+    message.set_improving_problem_is_infeasible(true);
+  }
+
+  if (bounds_ != nullptr) {
+    bounds_->GetChangedBounds(bounds_id_, &variables_, &lower_bounds_,
+                              &upper_bounds_);
+    message.mutable_bounds_variables()->Assign(variables_.begin(),
+                                               variables_.end());
+    message.mutable_bounds_lower()->Assign(lower_bounds_.begin(),
+                                           lower_bounds_.end());
+    message.mutable_bounds_upper()->Assign(upper_bounds_.begin(),
+                                           upper_bounds_.end());
+  }
+
+  if (clauses_ != nullptr) {
+    clauses_->GetUnseenBinaryClauses(clauses_id_, &binary_clauses_);
+    for (const auto& [lit1, lit2] : binary_clauses_) {
+      message.add_binary_clauses(lit1);
+      message.add_binary_clauses(lit2);
+    }
+    // Note that this must be called regularly so that the manager can release
+    // the batches of clauses.
+    for (const absl::Span<const int> clause :
+         clauses_->GetUnseenClauses(clauses_id_)) {
+      AddClauseToExport(clause, &message);
+    }
+    if (clause_rings_ != nullptr) {
+      ring_clauses_.clear();
+      clause_rings_->GetUnseenClauses(clauses_id_, &ring_clauses_);
+      for (int i = 0; i < ring_clauses_.size(); ++i) {
+        AddClauseToExport(ring_clauses_[i], &message);
+      }
+    }
+  }
+
+  if (message.ByteSizeLong() == 0) return;
+  message.set_model_fingerprint(model_fingerprint_);
+  message.SerializeToString(&buffer_);
+  const absl::Status status = transport_->Send(buffer_);
+  if (!status.ok()) return Disconnect(status);
+  ++num_messages_sent_;
+  num_bytes_sent_ += buffer_.size();
+}
+
+void RemoteSharing::AddClauseToExport(absl::Span<const int> clause,
+                                      RemoteSharingMessage* message) {
+  if (imported_clauses_.contains(UniqueClauseStream::HashClause(clause))) {
+    return;
+  }
+  message->add_clause_sizes(clause.size());
+  message->mutable_clause_literals()->Add(clause.begin(), clause.end());
+}
+
+void RemoteSharing::Disconnect(const absl::Status& status) {
+  connected_ = false;
+  SOLVER_LOG(logger_, "[RemoteSharing] Stopping the sharing with the other ",
+             "processes: ", status.ToString());
+}
+
+void RemoteSharing::LogStatistics(SolverLogger* logger) const {
+  std::vector<std::vector<std::string>> table;
+  table.push_back({"Remote sharing", "Sent", "Bytes sent", "Received",
+                   "Bytes received", "Ignored", "Solutions", "Clauses"});
+  table.push_back(
+      {FormatName("remote"), FormatCounter(num_messages_sent_),
+       FormatCounter(num_bytes_sent_), FormatCounter(num_messages_received_),
+       FormatCounter(num_bytes_received_), FormatCounter(num_messages_ignored_),
+       FormatCounter(num_solutions_imported_),
+       FormatCounter(num_clauses_imported_)});
+  SOLVER_LOG(logger, FormatTable(table));
+}
+
+}  // namespace sat
+}  // namespace operations_research
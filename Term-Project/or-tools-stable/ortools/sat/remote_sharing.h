@@ -0,0 +1,145 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OR_TOOLS_SAT_REMOTE_SHARING_H_
+#define OR_TOOLS_SAT_REMOTE_SHARING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_utils.h"
+#include "ortools/sat/remote_sharing.pb.h"
+#include "ortools/sat/sharing_transport.h"
+#include "ortools/sat/synchronization.h"
+#include "ortools/sat/util.h"
+#include "ortools/util/logging.h"
+
+namespace operations_research {
+namespace sat {
+
+// Shares what the workers of this process learn with the workers of other
+// processes solving the same model, so that a parallel solve can span several
+// processes or machines:
+// - the best solution and the objective lower bound,
+// - the variable bounds of the SharedBoundsManager,
+// - the binary and glue clauses of the SharedClausesManager, and the glue
+//   clauses of the SharedClauseRings when the workers share them this way,
+// - the fact that the problem is solved.
+//
+// One process, or a thread of one of them, relays the messages with
+//   SharingCoordinator::Listen(address).value()->Run(num_processes);
+// and each solving process registers its connection before solving:
+//   std::unique_ptr<SocketTransport> transport =
+//       SocketTransport::Connect(address).value();
+//   model.Register<SharingTransport>(transport.get());
+//   SolveCpModel(model_proto, &model);
+// Only the parallel solve (num_workers > 1) uses it.
+//
+// All the variables and literals refer to the presolved model, so all the
+// processes must solve the same model with the same presolve parameters. The
+// messages about another model are ignored, but the processes should still use
+// different random seeds or subsolvers to diversify the search.
+//
+// This is not thread-safe: Synchronize() is called from the synchronization
+// point of the parallel solve.
+class RemoteSharing {
+ public:
+  // The bounds and clauses managers can be nullptr if the corresponding
+  // information is not shared, and so can the clause rings if the glue clauses
+  // are not shared through them. All of them must outlive this class.
+  //
+  // This registers a new id in the clauses manager, which must have a ring if
+  // clause_rings is not nullptr. Note that the clause rings are only used if
+  // clauses is not nullptr.
+  RemoteSharing(const CpModelProto& model_proto,
+                SharedResponseManager* response, SharedBoundsManager* bounds,
+                SharedClausesManager* clauses, SharedClauseRings* clause_rings,
+                SharingTransport* transport, SolverLogger* logger);
+
+  // Imports the messages received since the last call into the shared
+  // managers, then sends what was learned locally since the last call.
+  void Synchronize();
+
+  void LogStatistics(SolverLogger* logger) const;
+
+ private:
+  void Import(const RemoteSharingMessage& message);
+  void Export();
+
+  // Adds the clause to the message, unless it was imported from the other
+  // processes.
+  void AddClauseToExport(absl::Span<const int> clause,
+                         RemoteSharingMessage* message);
+
+  // Stops all sharing after a transport error.
+  void Disconnect(const absl::Status& status);
+
+  bool IsValidLiteral(int literal) const {
+    return PositiveRef(literal) < num_variables_;
+  }
+
+  const int num_variables_;
+  const bool has_objective_;
+  const uint64_t model_fingerprint_;
+  SharedResponseManager* response_;
+  SharedBoundsManager* bounds_;
+  SharedClausesManager* clauses_;
+  SharedClauseRings* clause_rings_;
+  SharingTransport* transport_;
+  SolverLogger* logger_;
+  bool connected_ = true;
+
+  // Our ids in the bounds and clauses managers.
+  int bounds_id_ = -1;
+  int clauses_id_ = -1;
+
+  // The fingerprints of the imported clauses are kept up to this number, so
+  // that they are not sent back.
+  static constexpr int kMaxImportedClauses = 1 << 20;
+
+  // What was already sent or received, so that it is not sent again.
+  int64_t best_rank_sent_ = std::numeric_limits<int64_t>::max();
+  int64_t lower_bound_sent_ = std::numeric_limits<int64_t>::min();
+  bool solved_sent_ = false;
+  absl::flat_hash_set<size_t> imported_clauses_;
+
+  // Statistics.
+  int64_t num_messages_sent_ = 0;
+  int64_t num_messages_received_ = 0;
+  int64_t num_messages_ignored_ = 0;
+  int64_t num_bytes_sent_ = 0;
+  int64_t num_bytes_received_ = 0;
+  int64_t num_solutions_imported_ = 0;
+  int64_t num_clauses_imported_ = 0;
+
+  // Temporary storage.
+  std::string buffer_;
+  std::vector<int> variables_;
+  std::vector<int64_t> lower_bounds_;
+  std::vector<int64_t> upper_bounds_;
+  std::vector<std::pair<int, int>> binary_clauses_;
+  CompactVectorVector<int> ring_clauses_;
+};
+
+}  // namespace sat
+}  // namespace operations_research
+
+#endif  // OR_TOOLS_SAT_REMOTE_SHARING_H_
@@ -0,0 +1,448 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/remote_sharing.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+#include "ortools/base/gmock.h"
+#include "ortools/sat/cp_model.pb.h"
+#include "ortools/sat/cp_model_solver.h"
+#include "ortools/sat/cp_model_utils.h"
+#include "ortools/sat/model.h"
+#include "ortools/sat/remote_sharing.pb.h"
+#include "ortools/sat/sat_parameters.pb.h"
+#include "ortools/sat/sharing_transport.h"
+#include "ortools/sat/synchronization.h"
+#include "ortools/sat/util.h"
+#include "ortools/util/logging.h"
+
+namespace operations_research {
+namespace sat {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+
+// One end of an in-memory connection between two processes.
+class InMemoryTransport : public SharingTransport {
+ public:
+  static void Connect(InMemoryTransport* a, InMemoryTransport* b) {
+    a->peer_ = b;
+    b->peer_ = a;
+  }
+
+  absl::Status Send(absl::string_view message) override {
+    CHECK(peer_ != nullptr);
+    peer_->received_.push_back(std::string(message));
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<bool> Receive(std::string* message) override {
+    if (received_.empty()) return false;
+    *message = std::move(received_.front());
+    received_.pop_front();
+    return true;
+  }
+
+  // The messages sent to this end and not received yet.
+  std::deque<std::string>& received() { return received_; }
+
+ private:
+  InMemoryTransport* peer_ = nullptr;
+  std::deque<std::string> received_;
+};
+
+// Minimizes the sum of 4 Boolean variables, at least 2 of them being true.
+CpModelProto TestModel() {
+  CpModelProto model_proto;
+  LinearConstraintProto* linear =
+      model_proto.add_constraints()->mutable_linear();
+  for (int i = 0; i < 4; ++i) {
+    IntegerVariableProto* var = model_proto.add_variables();
+    var->add_domain(0);
+    var->add_domain(1);
+    model_proto.mutable_objective()->add_vars(i);
+    model_proto.mutable_objective()->add_coeffs(1);
+    linear->add_vars(i);
+    linear->add_coeffs(1);
+  }
+  linear->add_domain(2);
+  linear->add_domain(4);
+  return model_proto;
+}
+
+// The shared classes of a solving process with a single local worker, which
+// shares its glue clauses through the rings if use_rings is true.
+struct Process {
+  Process(const CpModelProto& model_proto, bool use_rings)
+      : response(&model),
+        bounds(model_proto),
+        clauses(/*always_synchronize=*/true, absl::ZeroDuration()) {
+    response.InitializeObjective(model_proto);
+    if (use_rings) {
+      // One ring for the remote sharing, and one for the worker.
+      clause_rings = std::make_unique<SharedClauseRings>(2);
+    }
+    remote = std::make_unique<RemoteSharing>(
+        model_proto, &response, &bounds, &clauses, clause_rings.get(),
+        &transport, model.GetOrCreate<SolverLogger>());
+    bounds_id = bounds.RegisterNewId();
+    clauses_id = clauses.RegisterNewId();
+  }
+
+  // Same order as the synchronization points of the parallel solve.
+  void Synchronize() {
+    remote->Synchronize();
+    response.Synchronize();
+    bounds.Synchronize();
+    clauses.Synchronize();
+  }
+
+  // Shares a glue clause from the worker.
+  void AddClause(absl::Span<const int> clause) {
+    if (clause_rings != nullptr) {
+      CHECK(clause_rings->Add(clauses_id, clause));
+    } else {
+      CHECK(clauses.GetClauseStream(clauses_id)->Add(clause));
+    }
+  }
+
+  // Returns the glue clauses that the worker did not see yet.
+  std::vector<std::vector<int>> GetUnseenClauses() {
+    std::vector<std::vector<int>> result;
+    if (clause_rings != nullptr) {
+      CompactVectorVector<int> ring_clauses;
+      clause_rings->GetUnseenClauses(clauses_id, &ring_clauses);
+      for (int i = 0; i < ring_clauses.size(); ++i) {
+        result.emplace_back(ring_clauses[i].begin(), ring_clauses[i].end());
+      }
+    } else {
+      for (const absl::Span<const int> clause :
+           clauses.GetUnseenClauses(clauses_id)) {
+        result.emplace_back(clause.begin(), clause.end());
+      }
+    }
+    return result;
+  }
+
+  Model model;
+  SharedResponseManager response;
+  SharedBoundsManager bounds;
+  SharedClausesManager clauses;
+  std::unique_ptr<SharedClauseRings> clause_rings;
+  InMemoryTransport transport;
+  std::unique_ptr<RemoteSharing> remote;
+  int bounds_id = -1;
+  int clauses_id = -1;
+};
+
+class RemoteSharingTest : public ::testing::TestWithParam<bool> {};
+
+INSTANTIATE_TEST_SUITE_P(ClauseRings, RemoteSharingTest, ::testing::Bool());
+
+TEST_P(RemoteSharingTest, SharesEverythingWithTheOtherProcess) {
+  const CpModelProto model_proto = TestModel();
+  Process a(model_proto, GetParam());
+  Process b(model_proto, GetParam());
+  InMemoryTransport::Connect(&a.transport, &b.transport);
+
+  a.response.NewSolution({1, 0, 1, 1}, "worker");
+  a.response.UpdateInnerObjectiveBounds("worker", IntegerValue(2),
+                                        kMaxIntegerValue);
+  a.bounds.ReportPotentialNewBounds("worker", {3}, {0}, {0});
+  a.clauses.AddBinaryClause(a.clauses_id, 0, 1);
+  a.AddClause({0, 1, 2});
+  a.AddClause({NegatedRef(0), 1, 2, 3});
+  a.Synchronize();
+  a.Synchronize();
+  ASSERT_FALSE(b.transport.received().empty());
+
+  b.Synchronize();
+  EXPECT_EQ(b.response.BestSolutionInnerObjectiveValue(), 3);
+  EXPECT_EQ(b.response.GetInnerObjectiveLowerBound(), 2);
+  std::vector<int> variables;
+  std::vector<int64_t> lower_bounds;
+  std::vector<int64_t> upper_bounds;
+  b.bounds.GetChangedBounds(b.bounds_id, &variables, &lower_bounds,
+                            &upper_bounds);
+  EXPECT_THAT(variables, ElementsAre(3));
+  EXPECT_THAT(upper_bounds, ElementsAre(0));
+  std::vector<std::pair<int, int>> binary_clauses;
+  b.clauses.GetUnseenBinaryClauses(b.clauses_id, &binary_clauses);
+  EXPECT_THAT(binary_clauses, ElementsAre(std::make_pair(0, 1)));
+  EXPECT_THAT(b.GetUnseenClauses(),
+              ElementsAre(ElementsAre(0, 1, 2),
+                          ElementsAre(NegatedRef(0), 1, 2, 3)));
+}
+
+TEST_P(RemoteSharingTest, ImportsTheSolutionBeforeTheBoundAndTheStatus) {
+  const CpModelProto model_proto = TestModel();
+  Process b(model_proto, GetParam());
+  InMemoryTransport other;
+  InMemoryTransport::Connect(&b.transport, &other);
+
+  // The lower bound proves that the solution is optimal. If b imported the
+  // status before the solution, it would consider the problem infeasible.
+  RemoteSharingMessage message;
+  message.set_model_fingerprint(FingerprintModel(model_proto));
+  for (const int64_t value : {1, 1, 0, 0}) {
+    message.add_solution(value);
+  }
+  message.set_inner_objective_lower_bound(2);
+  message.set_improving_problem_is_infeasible(true);
+  b.transport.received().push_back(message.SerializeAsString());
+
+  b.Synchronize();
+  const CpSolverResponse response = b.response.GetResponse();
+  EXPECT_EQ(response.status(), CpSolverStatus::OPTIMAL);
+  EXPECT_EQ(response.objective_value(), 2);
+  EXPECT_EQ(response.best_objective_bound(), 2);
+  EXPECT_THAT(response.solution(), ElementsAre(1, 1, 0, 0));
+}
+
+TEST_P(RemoteSharingTest, DoesNotSendBackTheImportedClauses) {
+  const CpModelProto model_proto = TestModel();
+  Process a(model_proto, GetParam());
+  Process b(model_proto, GetParam());
+  InMemoryTransport::Connect(&a.transport, &b.transport);
+
+  a.AddClause({0, 1, 2});
+  a.Synchronize();
+  a.Synchronize();
+  for (int i = 0; i < 3; ++i) b.Synchronize();
+  EXPECT_THAT(b.GetUnseenClauses(), ElementsAre(ElementsAre(0, 1, 2)));
+
+  // The clauses learned by b are still sent.
+  b.AddClause({1, 2, 3});
+  for (int i = 0; i < 2; ++i) b.Synchronize();
+  ASSERT_EQ(a.transport.received().size(), 1);
+  RemoteSharingMessage message;
+  ASSERT_TRUE(message.ParseFromString(a.transport.received().front()));
+  EXPECT_THAT(message.clause_sizes(), ElementsAre(3));
+  EXPECT_THAT(message.clause_literals(), ElementsAre(1, 2, 3));
+}
+
+TEST_P(RemoteSharingTest, IgnoresTheMessagesAboutAnotherModel) {
+  const CpModelProto model_proto = TestModel();
+  CpModelProto other_model_proto = model_proto;
+  other_model_proto.mutable_constraints(0)->mutable_linear()->set_domain(0, 1);
+  Process a(other_model_proto, GetParam());
+  Process b(model_proto, GetParam());
+  InMemoryTransport::Connect(&a.transport, &b.transport);
+
+  a.response.NewSolution({1, 0, 0, 0}, "worker");
+  a.bounds.ReportPotentialNewBounds("worker", {3}, {0}, {0});
+  a.AddClause({0, 1, 2});
+  a.Synchronize();
+  a.Synchronize();
+  ASSERT_FALSE(b.transport.received().empty());
+
+  for (int i = 0; i < 2; ++i) b.Synchronize();
+  EXPECT_EQ(b.response.SolutionsRepository().NumSolutions(), 0);
+  std::vector<int> variables;
+  std::vector<int64_t> lower_bounds;
+  std::vector<int64_t> upper_bounds;
+  b.bounds.GetChangedBounds(b.bounds_id, &variables, &lower_bounds,
+                            &upper_bounds);
+  EXPECT_THAT(variables, IsEmpty());
+  EXPECT_THAT(b.GetUnseenClauses(), IsEmpty());
+}
+
+TEST_P(RemoteSharingTest, DropsMalformedClausesAndBounds) {
+  const CpModelProto model_proto = TestModel();
+  Process b(model_proto, GetParam());
+  InMemoryTransport other;
+  InMemoryTransport::Connect(&b.transport, &other);
+  RemoteSharingMessage message;
+  message.set_model_fingerprint(FingerprintModel(model_proto));
+  const auto receive = [&b, &message]() {
+    b.transport.received().push_back(message.SerializeAsString());
+  };
+
+  // Literals of unknown variables.
+  message.add_binary_clauses(0);
+  message.add_binary_clauses(4);
+  message.add_clause_sizes(3);
+  for (const int value : {0, 1, NegatedRef(4)}) {
+    message.add_clause_literals(value);
+  }
+  receive();
+
+  // Clauses longer than the literals.
+  message.Clear();
+  message.set_model_fingerprint(FingerprintModel(model_proto));
+  message.add_clause_sizes(4);
+  for (const int value : {0, 1, 2}) {
+    message.add_clause_literals(value);
+  }
+  receive();
+  message.clear_clause_sizes();
+  message.add_clause_sizes(-1);
+  receive();
+
+  // Bounds of unknown variables, and missing bounds.
+  message.Clear();
+  message.set_model_fingerprint(FingerprintModel(model_proto));
+  message.add_bounds_variables(4);
+  message.add_bounds_lower(0);
+  message.add_bounds_upper(0);
+  receive();
+  message.set_bounds_variables(0, 3);
+  message.clear_bounds_upper();
+  receive();
+
+  // Not a message at all.
+  b.transport.received().push_back("\xff\xff\xff");
+
+  b.Synchronize();
+  b.Synchronize();
+  EXPECT_THAT(b.transport.received(), IsEmpty());
+  std::vector<int> variables;
+  std::vector<int64_t> lower_bounds;
+  std::vector<int64_t> upper_bounds;
+  b.bounds.GetChangedBounds(b.bounds_id, &variables, &lower_bounds,
+                            &upper_bounds);
+  EXPECT_THAT(variables, IsEmpty());
+  std::vector<std::pair<int, int>> binary_clauses;
+  b.clauses.GetUnseenBinaryClauses(b.clauses_id, &binary_clauses);
+  EXPECT_THAT(binary_clauses, IsEmpty());
+  EXPECT_THAT(b.GetUnseenClauses(), IsEmpty());
+
+  // The valid messages are still imported.
+  message.Clear();
+  message.set_model_fingerprint(FingerprintModel(model_proto));
+  message.add_clause_sizes(3);
+  for (const int value : {0, 1, 2}) {
+    message.add_clause_literals(value);
+  }
+  receive();
+  b.Synchronize();
+  b.Synchronize();
+  EXPECT_THAT(b.GetUnseenClauses(), ElementsAre(ElementsAre(0, 1, 2)));
+}
+
+// Maximum independent set on a cycle of odd length, which takes a few
+// conflicts to prove optimal.
+CpModelProto CycleModel(int num_nodes) {
+  CpModelProto model_proto;
+  for (int i = 0; i < num_nodes; ++i) {
+    IntegerVariableProto* var = model_proto.add_variables();
+    var->add_domain(0);
+    var->add_domain(1);
+    model_proto.mutable_objective()->add_vars(i);
+    model_proto.mutable_objective()->add_coeffs(-1);
+  }
+  for (int i = 0; i < num_nodes; ++i) {
+    LinearConstraintProto* linear =
+        model_proto.add_constraints()->mutable_linear();
+    linear->add_vars(i);
+    linear->add_coeffs(1);
+    linear->add_vars((i + 1) % num_nodes);
+    linear->add_coeffs(1);
+    linear->add_domain(0);
+    linear->add_domain(1);
+  }
+  return model_proto;
+}
+
+TEST(RemoteSharingSolveTest, TwoProcessesThroughACoordinator) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharingCoordinator> coordinator,
+                       SharingCoordinator::Listen("localhost:0"));
+  const std::string address = absl::StrCat("localhost:", coordinator->port());
+  std::thread relay([&coordinator]() { CHECK_OK(coordinator->Run(2)); });
+
+  const CpModelProto model_proto = CycleModel(31);
+  std::vector<CpSolverResponse> responses(2);
+  std::vector<std::thread> processes;
+  for (int i = 0; i < 2; ++i) {
+    processes.emplace_back([&model_proto, &address, &responses, i]() {
+      std::unique_ptr<SocketTransport> transport =
+          SocketTransport::Connect(address).value();
+      Model model;
+      model.Register<SharingTransport>(transport.get());
+      SatParameters params;
+      params.set_num_workers(2);
+      params.set_random_seed(i);
+      params.set_share_glue_clauses_lock_free(true);
+      params.set_log_search_progress(true);
+      params.set_log_to_stdout(false);
+      params.set_log_to_response(true);
+      model.Add(NewSatParameters(params));
+      responses[i] = SolveCpModel(model_proto, &model);
+    });
+  }
+  for (std::thread& process : processes) process.join();
+  relay.join();
+
+  for (const CpSolverResponse& response : responses) {
+    EXPECT_EQ(response.status(), CpSolverStatus::OPTIMAL);
+    EXPECT_EQ(response.objective_value(), -15);
+    EXPECT_THAT(response.solve_log(), ::testing::HasSubstr("Remote sharing"));
+  }
+}
+
+// Without an objective, the search stops on its first solution, after the
+// last synchronization point of the workers. It must still be sent.
+TEST(RemoteSharingSolveTest, SendsTheFinalSolution) {
+  InMemoryTransport transport;
+  InMemoryTransport other_process;
+  InMemoryTransport::Connect(&transport, &other_process);
+
+  CpModelProto model_proto = CycleModel(31);
+  model_proto.clear_objective();
+  Model model;
+  model.Register<SharingTransport>(&transport);
+  SatParameters params;
+  params.set_num_workers(2);
+  // The deterministic loop stops right after the round in which the search is
+  // done, and the presolve would otherwise remove all the variables.
+  params.set_interleave_search(true);
+  params.set_cp_model_presolve(false);
+  model.Add(NewSatParameters(params));
+  const CpSolverResponse response = SolveCpModel(model_proto, &model);
+  ASSERT_EQ(response.status(), CpSolverStatus::OPTIMAL);
+
+  std::vector<int64_t> solution_sent;
+  bool solved_sent = false;
+  for (const std::string& buffer : other_process.received()) {
+    RemoteSharingMessage message;
+    ASSERT_TRUE(message.ParseFromString(buffer));
+    if (message.solution_size() > 0) {
+      solution_sent.assign(message.solution().begin(),
+                           message.solution().end());
+    }
+    if (message.improving_problem_is_infeasible()) solved_sent = true;
+  }
+  EXPECT_THAT(solution_sent, ElementsAreArray(response.solution()));
+  EXPECT_TRUE(solved_sent);
+}
+
+}  // namespace
+}  // namespace sat
+}  // namespace operations_research
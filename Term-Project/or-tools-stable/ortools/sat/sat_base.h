@@ -488,7 +488,7 @@ class Trail {
   std::vector<Literal> trail_;
   std::vector<Literal> conflict_;
   util_intops::StrongVector<BooleanVariable, AssignmentInfo> info_;
-  SatClause* failing_sat_clause_;
+  SatClause* failing_sat_clause_ = nullptr;
 
   // Data used by EnqueueWithSameReasonAs().
   util_intops::StrongVector<BooleanVariable, BooleanVariable>
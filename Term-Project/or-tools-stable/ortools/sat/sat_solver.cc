@@ -426,10 +426,6 @@ int SatSolver::AddLearnedClauseAndEnqueueUnitPropagation(
 
     SatClause* clause =
         clauses_propagator_->AddRemovableClause(literals, trail_, lbd);
-
-    // BumpClauseActivity() must be called after clauses_info_[clause] has
-    // been created or it will have no effect.
-    (*clauses_propagator_->mutable_clauses_info())[clause].lbd = lbd;
     BumpClauseActivity(clause);
   } else {
     CHECK(clauses_propagator_->AddClause(literals, trail_, lbd));
@@ -1140,7 +1136,7 @@ void SatSolver::KeepAllClausesUsedToInfer(BooleanVariable variable) {
     SatClause* clause = ReasonClauseOrNull(var);
     if (clause != nullptr) {
       // Keep this clause.
-      clauses_propagator_->mutable_clauses_info()->erase(clause);
+      clauses_propagator_->KeepClauseForever(clause);
     }
     if (trail_->AssignmentType(var) == AssignmentType::kSearchDecision) {
       continue;
@@ -1630,19 +1626,18 @@ void SatSolver::BumpReasonActivities(absl::Span<const Literal> literals) {
 }
 
 void SatSolver::BumpClauseActivity(SatClause* clause) {
-  // We only bump the activity of the clauses that have some info. So if we know
-  // that we will keep a clause forever, we don't need to create its Info. More
-  // than the speed, this allows to limit as much as possible the activity
+  // We only bump the activity of the clauses that can be removed. So if we know
+  // that we will keep a clause forever, we don't need to maintain its activity.
+  // More than the speed, this allows to limit as much as possible the activity
   // rescaling.
-  auto it = clauses_propagator_->mutable_clauses_info()->find(clause);
-  if (it == clauses_propagator_->mutable_clauses_info()->end()) return;
+  if (!clauses_propagator_->IsRemovable(clause)) return;
 
   // Check if the new clause LBD is below our threshold to keep this clause
   // indefinitely. Note that we use a +1 here because the LBD of a newly learned
   // clause decrease by 1 just after the backjump.
   const int new_lbd = ComputeLbd(*clause);
   if (new_lbd + 1 <= parameters_->clause_cleanup_lbd_bound()) {
-    clauses_propagator_->mutable_clauses_info()->erase(clause);
+    clauses_propagator_->KeepClauseForever(clause);
     return;
   }
 
@@ -1651,21 +1646,22 @@ void SatSolver::BumpClauseActivity(SatClause* clause) {
     case SatParameters::PROTECTION_NONE:
       break;
     case SatParameters::PROTECTION_ALWAYS:
-      it->second.protected_during_next_cleanup = true;
+      clause->set_protected_during_next_cleanup(true);
       break;
     case SatParameters::PROTECTION_LBD:
       // This one is similar to the one used by the Glucose SAT solver.
       //
       // TODO(user): why the +1? one reason may be that the LBD of a conflict
       // decrease by 1 just after the backjump...
-      if (new_lbd + 1 < it->second.lbd) {
-        it->second.protected_during_next_cleanup = true;
-        it->second.lbd = new_lbd;
+      if (new_lbd + 1 < clause->lbd()) {
+        clause->set_protected_during_next_cleanup(true);
+        clause->set_lbd(new_lbd);
       }
   }
 
   // Increase the activity.
-  const double activity = it->second.activity += clause_activity_increment_;
+  const double activity = clause->activity() + clause_activity_increment_;
+  clause->set_activity(activity);
   if (activity > parameters_->max_clause_activity_value()) {
     RescaleClauseActivities(1.0 / parameters_->max_clause_activity_value());
   }
@@ -1674,8 +1670,9 @@ void SatSolver::BumpClauseActivity(SatClause* clause) {
 void SatSolver::RescaleClauseActivities(double scaling_factor) {
   SCOPED_TIME_STAT(&stats_);
   clause_activity_increment_ *= scaling_factor;
-  for (auto& entry : *clauses_propagator_->mutable_clauses_info()) {
-    entry.second.activity *= scaling_factor;
+  for (SatClause* clause : clauses_propagator_->AllClausesInCreationOrder()) {
+    if (!clauses_propagator_->IsRemovable(clause)) continue;
+    clause->set_activity(clause->activity() * scaling_factor);
   }
 }
 
@@ -2731,38 +2728,38 @@ void SatSolver::CleanClauseDatabaseIfNeeded() {
   if (num_learned_clause_before_cleanup_ > 0) return;
   SCOPED_TIME_STAT(&stats_);
 
-  // Creates a list of clauses that can be deleted. Note that only the clauses
-  // that appear in clauses_info can potentially be removed.
-  typedef std::pair<SatClause*, ClauseInfo> Entry;
-  std::vector<Entry> entries;
-  auto& clauses_info = *(clauses_propagator_->mutable_clauses_info());
-  for (auto& entry : clauses_info) {
-    if (ClauseIsUsedAsReason(entry.first)) continue;
-    if (entry.second.protected_during_next_cleanup) {
-      entry.second.protected_during_next_cleanup = false;
+  // Creates a list of clauses that can be deleted. Note that only the
+  // removable clauses can potentially be removed.
+  std::vector<SatClause*> entries;
+  for (SatClause* clause : clauses_propagator_->AllClausesInCreationOrder()) {
+    if (!clauses_propagator_->IsRemovable(clause)) continue;
+    if (ClauseIsUsedAsReason(clause)) continue;
+    if (clause->protected_during_next_cleanup()) {
+      clause->set_protected_during_next_cleanup(false);
       continue;
     }
-    entries.push_back(entry);
+    entries.push_back(clause);
   }
-  const int num_protected_clauses = clauses_info.size() - entries.size();
+  const int num_protected_clauses =
+      clauses_propagator_->num_removable_clauses() - entries.size();
 
   if (parameters_->clause_cleanup_ordering() == SatParameters::CLAUSE_LBD) {
     // Order the clauses by decreasing LBD and then increasing activity.
     std::sort(entries.begin(), entries.end(),
-              [](const Entry& a, const Entry& b) {
-                if (a.second.lbd == b.second.lbd) {
-                  return a.second.activity < b.second.activity;
+              [](const SatClause* a, const SatClause* b) {
+                if (a->lbd() == b->lbd()) {
+                  return a->activity() < b->activity();
                 }
-                return a.second.lbd > b.second.lbd;
+                return a->lbd() > b->lbd();
               });
   } else {
     // Order the clauses by increasing activity and then decreasing LBD.
     std::sort(entries.begin(), entries.end(),
-              [](const Entry& a, const Entry& b) {
-                if (a.second.activity == b.second.activity) {
-                  return a.second.lbd > b.second.lbd;
+              [](const SatClause* a, const SatClause* b) {
+                if (a->activity() == b->activity()) {
+                  return a->lbd() > b->lbd();
                 }
-                return a.second.activity < b.second.activity;
+                return a->activity() < b->activity();
               });
   }
 
@@ -2776,29 +2773,28 @@ void SatSolver::CleanClauseDatabaseIfNeeded() {
 
   int num_deleted_clauses = entries.size() - num_kept_clauses;
 
-  // Tricky: Because the order of the clauses_info iteration is NOT
-  // deterministic (pointer keys), we also keep all the clauses which have the
-  // same LBD and activity as the last one so the behavior is deterministic.
+  // Tricky: Because std::sort() is not stable, we also keep all the clauses
+  // which have the same LBD and activity as the last one so the behavior does
+  // not depend on the sort implementation.
   if (num_kept_clauses > 0) {
     while (num_deleted_clauses > 0) {
-      const ClauseInfo& a = entries[num_deleted_clauses].second;
-      const ClauseInfo& b = entries[num_deleted_clauses - 1].second;
-      if (a.activity != b.activity || a.lbd != b.lbd) break;
+      const SatClause* a = entries[num_deleted_clauses];
+      const SatClause* b = entries[num_deleted_clauses - 1];
+      if (a->activity() != b->activity() || a->lbd() != b->lbd()) break;
       --num_deleted_clauses;
       ++num_kept_clauses;
     }
   }
   if (num_deleted_clauses > 0) {
     entries.resize(num_deleted_clauses);
-    for (const Entry& entry : entries) {
-      SatClause* clause = entry.first;
+    for (SatClause* clause : entries) {
       counters_.num_literals_forgotten += clause->size();
       clauses_propagator_->LazyDetach(clause);
     }
     clauses_propagator_->CleanUpWatchers();
 
     // TODO(user): If the need arise, we could avoid this linear scan on the
-    // full list of clauses by not keeping the clauses from clauses_info there.
+    // full list of clauses by not keeping the removable clauses there.
     if (!block_clause_deletion_) {
       clauses_propagator_->DeleteRemovedClauses();
     }
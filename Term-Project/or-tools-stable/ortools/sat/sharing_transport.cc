@@ -0,0 +1,412 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/sharing_transport.h"
+
+#if !defined(_MSC_VER)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif  // !defined(_MSC_VER)
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "ortools/base/status_macros.h"
+
+namespace operations_research {
+namespace sat {
+
+#if !defined(_MSC_VER)
+
+namespace {
+
+// The size of the length prefix of each message.
+constexpr int kHeaderSize = 4;
+
+absl::Status ErrnoError(absl::string_view what) {
+  const int error = errno;
+  return absl::Status(absl::ErrnoToStatusCode(error),
+                      absl::StrCat(what, ": ", std::strerror(error)));
+}
+
+struct SocketAddress {
+  bool is_unix = false;
+  // The path of a Unix domain socket, or the host of a TCP one.
+  std::string path_or_host;
+  std::string port;
+};
+
+absl::StatusOr<SocketAddress> ParseAddress(absl::string_view address) {
+  SocketAddress result;
+  if (absl::ConsumePrefix(&address, "unix:")) {
+    if (address.empty()) {
+      return absl::InvalidArgumentError("Empty Unix domain socket path.");
+    }
+    result.is_unix = true;
+    result.path_or_host = std::string(address);
+    return result;
+  }
+  const size_t colon = address.rfind(':');
+  if (colon == absl::string_view::npos || colon == 0 ||
+      colon + 1 == address.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid address, expected unix:<path> or <host>:<port>: ",
+                     address));
+  }
+  absl::string_view host = address.substr(0, colon);
+  // Brackets around IPv6 addresses, as in "[::1]:1234".
+  if (absl::ConsumePrefix(&host, "[")) absl::ConsumeSuffix(&host, "]");
+  result.path_or_host = std::string(host);
+  result.port = std::string(address.substr(colon + 1));
+  return result;
+}
+
+// Returns a socket connected to the address, or listening on it.
+absl::StatusOr<int> OpenSocket(const SocketAddress& address, bool listen) {
+  if (address.is_unix) {
+    sockaddr_un unix_address = {};
+    unix_address.sun_family = AF_UNIX;
+    if (address.path_or_host.size() >= sizeof(unix_address.sun_path)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Unix domain socket path too long: ", address.path_or_host));
+    }
+    std::memcpy(unix_address.sun_path, address.path_or_host.data(),
+                address.path_or_host.size());
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return ErrnoError("socket");
+    const sockaddr* addr = reinterpret_cast<const sockaddr*>(&unix_address);
+    if (listen) {
+      // Removes the socket file left by a previous run, if any.
+      unlink(address.path_or_host.c_str());
+      if (bind(fd, addr, sizeof(unix_address)) != 0 ||
+          ::listen(fd, SOMAXCONN) != 0) {
+        const absl::Status status = ErrnoError(address.path_or_host);
+        close(fd);
+        return status;
+      }
+    } else if (connect(fd, addr, sizeof(unix_address)) != 0) {
+      const absl::Status status = ErrnoError(address.path_or_host);
+      close(fd);
+      return status;
+    }
+    return fd;
+  }
+
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (listen) hints.ai_flags = AI_PASSIVE;
+  addrinfo* results = nullptr;
+  const int error =
+      getaddrinfo(address.path_or_host.c_str(), address.port.c_str(), &hints,
+                  &results);
+  if (error != 0) {
+    return absl::UnavailableError(absl::StrCat(
+        address.path_or_host, ":", address.port, ": ", gai_strerror(error)));
+  }
+  absl::Status status;
+  int fd = -1;
+  for (addrinfo* info = results; info != nullptr; info = info->ai_next) {
+    fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd < 0) {
+      status = ErrnoError("socket");
+      continue;
+    }
+    if (listen) {
+      const int one = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      if (bind(fd, info->ai_addr, info->ai_addrlen) == 0 &&
+          ::listen(fd, SOMAXCONN) == 0) {
+        break;
+      }
+    } else if (connect(fd, info->ai_addr, info->ai_addrlen) == 0) {
+      break;
+    }
+    status = ErrnoError(
+        absl::StrCat(address.path_or_host, ":", address.port));
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(results);
+  if (fd < 0) return status;
+
+  // The messages are sent once per synchronization, so latency matters more
+  // than the number of packets.
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  return fd;
+}
+
+}  // namespace
+
+SocketTransport::SocketTransport(int fd) : fd_(fd) {
+#if defined(SO_NOSIGPIPE)
+  const int one = 1;
+  setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif  // defined(SO_NOSIGPIPE)
+  fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK);
+}
+
+SocketTransport::~SocketTransport() {
+  const absl::Time deadline = absl::Now() + absl::Seconds(1);
+  while (HasPendingOutput() && Flush().ok()) {
+    const int64_t timeout_ms =
+        absl::ToInt64Milliseconds(deadline - absl::Now());
+    if (timeout_ms <= 0) break;
+    pollfd poll_fd = {fd_, POLLOUT, 0};
+    if (poll(&poll_fd, 1, timeout_ms) <= 0) break;
+  }
+  close(fd_);
+}
+
+absl::StatusOr<std::unique_ptr<SocketTransport>> SocketTransport::Connect(
+    absl::string_view address) {
+  ASSIGN_OR_RETURN(const SocketAddress parsed, ParseAddress(address));
+  ASSIGN_OR_RETURN(const int fd, OpenSocket(parsed, /*listen=*/false));
+  return std::make_unique<SocketTransport>(fd);
+}
+
+absl::Status SocketTransport::Send(absl::string_view message) {
+  if (message.size() > std::numeric_limits<uint32_t>::max()) {
+    return absl::InvalidArgumentError("Message too large.");
+  }
+  const uint32_t size = message.size();
+  for (int i = 0; i < kHeaderSize; ++i) {
+    output_.push_back(static_cast<char>((size >> (8 * i)) & 0xff));
+  }
+  output_.append(message.data(), message.size());
+  return Flush();
+}
+
+absl::Status SocketTransport::Flush() {
+  while (HasPendingOutput()) {
+#if defined(MSG_NOSIGNAL)
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif  // defined(MSG_NOSIGNAL)
+    const ssize_t num_written =
+        send(fd_, output_.data() + output_start_,
+             output_.size() - output_start_, flags);
+    if (num_written < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      return ErrnoError("send");
+    }
+    output_start_ += num_written;
+  }
+  if (output_start_ == output_.size()) {
+    output_.clear();
+    output_start_ = 0;
+  } else if (output_start_ > output_.size() / 2) {
+    output_.erase(0, output_start_);
+    output_start_ = 0;
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<bool> SocketTransport::Receive(std::string* message) {
+  const auto pop_message = [this, message]() {
+    const int64_t num_available = input_.size() - input_start_;
+    if (num_available < kHeaderSize) return false;
+    uint32_t size = 0;
+    for (int i = 0; i < kHeaderSize; ++i) {
+      size |= static_cast<uint32_t>(
+                  static_cast<unsigned char>(input_[input_start_ + i]))
+              << (8 * i);
+    }
+    if (num_available < kHeaderSize + static_cast<int64_t>(size)) return false;
+    message->assign(input_, input_start_ + kHeaderSize, size);
+    input_start_ += kHeaderSize + size;
+    if (input_start_ == input_.size()) {
+      input_.clear();
+      input_start_ = 0;
+    } else if (input_start_ > input_.size() / 2) {
+      input_.erase(0, input_start_);
+      input_start_ = 0;
+    }
+    return true;
+  };
+  if (pop_message()) return true;
+
+  char buffer[1 << 16];
+  while (!input_closed_) {
+    const ssize_t num_read = recv(fd_, buffer, sizeof(buffer), 0);
+    if (num_read > 0) {
+      input_.append(buffer, num_read);
+      continue;
+    }
+    if (num_read == 0) {
+      input_closed_ = true;
+      break;
+    }
+    if (errno == EINTR) continue;
+    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+    return ErrnoError("recv");
+  }
+  if (pop_message()) return true;
+  if (input_closed_) return absl::UnavailableError("Connection closed.");
+  return false;
+}
+
+absl::StatusOr<std::unique_ptr<SharingCoordinator>> SharingCoordinator::Listen(
+    absl::string_view address) {
+  ASSIGN_OR_RETURN(const SocketAddress parsed, ParseAddress(address));
+  ASSIGN_OR_RETURN(const int fd, OpenSocket(parsed, /*listen=*/true));
+  int port = -1;
+  if (!parsed.is_unix) {
+    sockaddr_storage bound_address = {};
+    socklen_t length = sizeof(bound_address);
+    if (getsockname(fd, reinterpret_cast<sockaddr*>(&bound_address),
+                    &length) != 0) {
+      const absl::Status status = ErrnoError("getsockname");
+      close(fd);
+      return status;
+    }
+    port = ntohs(bound_address.ss_family == AF_INET6
+                     ? reinterpret_cast<sockaddr_in6*>(&bound_address)
+                           ->sin6_port
+                     : reinterpret_cast<sockaddr_in*>(&bound_address)
+                           ->sin_port);
+  }
+  return absl::WrapUnique(new SharingCoordinator(
+      fd, port, parsed.is_unix ? parsed.path_or_host : ""));
+}
+
+SharingCoordinator::~SharingCoordinator() {
+  connections_.clear();
+  close(listen_fd_);
+  if (!unix_path_.empty()) unlink(unix_path_.c_str());
+}
+
+absl::Status SharingCoordinator::Run(int num_processes) {
+  while (connections_.size() < num_processes) {
+    const int fd = accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) continue;
+      return ErrnoError("accept");
+    }
+    if (unix_path_.empty()) {
+      const int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    connections_.push_back(std::make_unique<SocketTransport>(fd));
+  }
+
+  // A closed or broken connection is reset, and ignored from then on.
+  std::vector<pollfd> poll_fds(connections_.size());
+  std::string message;
+  while (true) {
+    bool all_closed = true;
+    for (int i = 0; i < connections_.size(); ++i) {
+      SocketTransport* connection = connections_[i].get();
+      if (connection == nullptr) {
+        // poll() ignores negative file descriptors.
+        poll_fds[i] = {-1, 0, 0};
+        continue;
+      }
+      all_closed = false;
+      const short events =
+          POLLIN | (connection->HasPendingOutput() ? POLLOUT : 0);
+      poll_fds[i] = {connection->fd(), events, 0};
+    }
+    if (all_closed) break;
+    if (poll(poll_fds.data(), poll_fds.size(), /*timeout=*/-1) < 0) {
+      if (errno == EINTR) continue;
+      return ErrnoError("poll");
+    }
+
+    for (int i = 0; i < connections_.size(); ++i) {
+      if (connections_[i] == nullptr) continue;
+      if ((poll_fds[i].revents & POLLOUT) && !connections_[i]->Flush().ok()) {
+        connections_[i].reset();
+        continue;
+      }
+      if (!(poll_fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+      while (true) {
+        const absl::StatusOr<bool> received =
+            connections_[i]->Receive(&message);
+        if (!received.ok()) {
+          connections_[i].reset();
+          break;
+        }
+        if (!*received) break;
+        for (int j = 0; j < connections_.size(); ++j) {
+          if (j == i || connections_[j] == nullptr) continue;
+          if (!connections_[j]->Send(message).ok()) connections_[j].reset();
+        }
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+#else  // !defined(_MSC_VER)
+
+SocketTransport::SocketTransport(int fd) : fd_(fd) {}
+
+SocketTransport::~SocketTransport() = default;
+
+absl::StatusOr<std::unique_ptr<SocketTransport>> SocketTransport::Connect(
+    absl::string_view /*address*/) {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+absl::Status SocketTransport::Send(absl::string_view /*message*/) {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+absl::Status SocketTransport::Flush() {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+absl::StatusOr<bool> SocketTransport::Receive(std::string* /*message*/) {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+absl::StatusOr<std::unique_ptr<SharingCoordinator>> SharingCoordinator::Listen(
+    absl::string_view /*address*/) {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+SharingCoordinator::~SharingCoordinator() = default;
+
+absl::Status SharingCoordinator::Run(int /*num_processes*/) {
+  return absl::UnimplementedError("Sockets are not supported on Windows.");
+}
+
+#endif  // !defined(_MSC_VER)
+
+}  // namespace sat
+}  // namespace operations_research
@@ -0,0 +1,134 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OR_TOOLS_SAT_SHARING_TRANSPORT_H_
+#define OR_TOOLS_SAT_SHARING_TRANSPORT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace operations_research {
+namespace sat {
+
+// Exchanges opaque messages with other processes. This is what the processes
+// of a distributed solve use to share what they learn, see RemoteSharing.
+//
+// Neither Send() nor Receive() should block, since they are called from the
+// synchronization loop of the solver. Implementations do not need to be
+// thread-safe.
+class SharingTransport {
+ public:
+  virtual ~SharingTransport() = default;
+
+  // Sends the message, or queues it to be sent later. Returns an error if the
+  // connection is broken.
+  virtual absl::Status Send(absl::string_view message) = 0;
+
+  // Sets message to the next received message and returns true, or returns
+  // false if no complete message was received yet. Returns an error if the
+  // connection is broken or closed.
+  virtual absl::StatusOr<bool> Receive(std::string* message) = 0;
+};
+
+// A SharingTransport over a connected stream socket, either a Unix domain
+// socket or a TCP one. Each message is prefixed by its length on 4 bytes.
+//
+// The socket is used in non-blocking mode: the messages that cannot be written
+// right away are buffered and written by the next calls.
+//
+// Addresses are either "unix:<path>" for a Unix domain socket, or
+// "<host>:<port>" for a TCP socket.
+class SocketTransport : public SharingTransport {
+ public:
+  // Takes ownership of the connected socket fd.
+  explicit SocketTransport(int fd);
+
+  // Tries to write the buffered messages for up to one second, then closes the
+  // socket.
+  ~SocketTransport() override;
+
+  // This type is neither copyable nor movable.
+  SocketTransport(const SocketTransport&) = delete;
+  SocketTransport& operator=(const SocketTransport&) = delete;
+
+  // Connects to a SharingCoordinator listening on the given address.
+  static absl::StatusOr<std::unique_ptr<SocketTransport>> Connect(
+      absl::string_view address);
+
+  absl::Status Send(absl::string_view message) override;
+  absl::StatusOr<bool> Receive(std::string* message) override;
+
+  // Writes as much of the buffered messages as possible without blocking.
+  absl::Status Flush();
+
+  bool HasPendingOutput() const { return output_start_ < output_.size(); }
+  int fd() const { return fd_; }
+
+ private:
+  int fd_;
+
+  // The bytes not written yet are output_[output_start_, output_.size()).
+  std::string output_;
+  int64_t output_start_ = 0;
+
+  // The bytes read but not returned yet by Receive() are
+  // input_[input_start_, input_.size()).
+  std::string input_;
+  int64_t input_start_ = 0;
+  bool input_closed_ = false;
+};
+
+// Relays the messages between the processes of a distributed solve: each
+// message received from a process is sent to all the other ones. This runs in
+// its own process, or in a thread of one of the solving processes.
+class SharingCoordinator {
+ public:
+  // Listens on the given address, see SocketTransport. A port of 0 on a TCP
+  // address picks any free port, see port().
+  static absl::StatusOr<std::unique_ptr<SharingCoordinator>> Listen(
+      absl::string_view address);
+
+  ~SharingCoordinator();
+
+  // This type is neither copyable nor movable.
+  SharingCoordinator(const SharingCoordinator&) = delete;
+  SharingCoordinator& operator=(const SharingCoordinator&) = delete;
+
+  // Accepts num_processes connections, then relays the messages until all of
+  // them are closed.
+  absl::Status Run(int num_processes);
+
+  // The port listened to, or -1 for a Unix domain socket.
+  int port() const { return port_; }
+
+ private:
+  SharingCoordinator(int listen_fd, int port, std::string unix_path)
+      : listen_fd_(listen_fd), port_(port), unix_path_(std::move(unix_path)) {}
+
+  const int listen_fd_;
+  const int port_;
+  const std::string unix_path_;
+  std::vector<std::unique_ptr<SocketTransport>> connections_;
+};
+
+}  // namespace sat
+}  // namespace operations_research
+
+#endif  // OR_TOOLS_SAT_SHARING_TRANSPORT_H_
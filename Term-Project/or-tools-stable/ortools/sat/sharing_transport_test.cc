@@ -0,0 +1,115 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/sharing_transport.h"
+
+#include <sys/socket.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "ortools/base/gmock.h"
+
+namespace operations_research {
+namespace sat {
+namespace {
+
+// Receives the next message, waiting for it if needed.
+std::string ReceiveNext(SharingTransport* transport) {
+  std::string message;
+  while (true) {
+    const absl::StatusOr<bool> received = transport->Receive(&message);
+    CHECK_OK(received.status());
+    if (*received) return message;
+    std::this_thread::yield();
+  }
+}
+
+TEST(SocketTransportTest, MessagesAreReceivedInOrder) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  SocketTransport a(fds[0]);
+  SocketTransport b(fds[1]);
+
+  std::string message;
+  EXPECT_THAT(b.Receive(&message), ::testing::status::IsOkAndHolds(false));
+
+  // The large message cannot be written at once, so it is written as the
+  // receiver reads it.
+  const std::string large(10 << 20, 'x');
+  std::thread sender([&a, &large]() {
+    CHECK_OK(a.Send("first"));
+    CHECK_OK(a.Send(""));
+    CHECK_OK(a.Send(large));
+    while (a.HasPendingOutput()) {
+      CHECK_OK(a.Flush());
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(ReceiveNext(&b), "first");
+  EXPECT_EQ(ReceiveNext(&b), "");
+  EXPECT_EQ(ReceiveNext(&b), large);
+  sender.join();
+}
+
+TEST(SocketTransportTest, ReportsClosedConnections) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  SocketTransport b(fds[1]);
+  {
+    SocketTransport a(fds[0]);
+    ASSERT_OK(a.Send("last"));
+  }
+  EXPECT_EQ(ReceiveNext(&b), "last");
+  std::string message;
+  EXPECT_EQ(b.Receive(&message).status().code(),
+            absl::StatusCode::kUnavailable);
+}
+
+TEST(SocketTransportTest, RejectsInvalidAddresses) {
+  EXPECT_EQ(SocketTransport::Connect("localhost").status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(SocketTransport::Connect("unix:").status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SharingCoordinatorTest, RelaysMessagesToTheOtherProcesses) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SharingCoordinator> coordinator,
+                       SharingCoordinator::Listen("localhost:0"));
+  const std::string address = absl::StrCat("localhost:", coordinator->port());
+  std::thread relay([&coordinator]() { CHECK_OK(coordinator->Run(3)); });
+
+  std::vector<std::unique_ptr<SocketTransport>> processes(3);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(processes[i], SocketTransport::Connect(address));
+  }
+  ASSERT_OK(processes[0]->Send("from 0"));
+  ASSERT_OK(processes[2]->Send("from 2"));
+  EXPECT_EQ(ReceiveNext(processes[1].get()), "from 0");
+  EXPECT_EQ(ReceiveNext(processes[0].get()), "from 2");
+
+  // Closing the connections stops the coordinator.
+  processes.clear();
+  relay.join();
+}
+
+}  // namespace
+}  // namespace sat
+}  // namespace operations_research
@@ -1448,6 +1448,142 @@ void SharedClausesManager::Synchronize() {
   // TODO(user): We could cleanup binary clauses that have been consumed.
 }
 
+SharedClauseRings::SharedClauseRings(int num_workers)
+    : num_workers_(num_workers),
+      rings_(new Ring[num_workers]),
+      fingerprints_(new std::atomic<uint64_t>[kNumFingerprints]) {
+  for (int id = 0; id < num_workers_; ++id) {
+    rings_[id].slots.reset(new Slot[kNumSlots]);
+    rings_[id].num_read.assign(num_workers_, 0);
+  }
+  for (int i = 0; i < kNumFingerprints; ++i) {
+    fingerprints_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+bool SharedClauseRings::InsertFingerprint(absl::Span<const int> clause) {
+  // Zero marks an empty entry.
+  const uint64_t fingerprint = UniqueClauseStream::HashClause(clause) | 1;
+  const int num_buckets = kNumFingerprints / kBucketSize;
+  std::atomic<uint64_t>* bucket =
+      &fingerprints_[((fingerprint >> 32) % num_buckets) * kBucketSize];
+  for (int i = 0; i < kBucketSize; ++i) {
+    const uint64_t entry = bucket[i].load(std::memory_order_relaxed);
+    if (entry == fingerprint) return false;
+    if (entry == 0) {
+      // On a race, the other fingerprint is overwritten, which only means that
+      // its clause might be published again.
+      bucket[i].store(fingerprint, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  // The bucket is full, so we evict a pseudo-random entry.
+  bucket[(fingerprint >> 8) % kBucketSize].store(fingerprint,
+                                                 std::memory_order_relaxed);
+  return true;
+}
+
+bool SharedClauseRings::Add(int id, absl::Span<const int> clause) {
+  DCHECK_GE(id, 0);
+  DCHECK_LT(id, num_workers_);
+  if (clause.size() < kMinClauseSize || clause.size() > kMaxClauseSize) {
+    return false;
+  }
+  Ring& ring = rings_[id];
+  if (!InsertFingerprint(clause)) {
+    ring.num_filtered.store(
+        ring.num_filtered.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    return false;
+  }
+
+  // We are the only writer of this ring, so relaxed loads of our own counters
+  // are enough. The release fence orders the odd epoch before the literals, so
+  // that a reader that sees any of them also sees the slot as being written.
+  const int64_t index = ring.num_published.load(std::memory_order_relaxed);
+  Slot& slot = ring.slots[index % kNumSlots];
+  slot.epoch.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.size.store(clause.size(), std::memory_order_relaxed);
+  for (int i = 0; i < clause.size(); ++i) {
+    slot.literals[i].store(clause[i], std::memory_order_relaxed);
+  }
+  slot.epoch.store(2 * index + 2, std::memory_order_release);
+  ring.num_published.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+void SharedClauseRings::GetUnseenClauses(int id,
+                                         CompactVectorVector<int>* clauses) {
+  DCHECK_GE(id, 0);
+  DCHECK_LT(id, num_workers_);
+  Ring& self = rings_[id];
+  int64_t num_imported = 0;
+  int64_t num_missed = 0;
+  std::array<int, kMaxClauseSize> literals;
+  for (int other = 0; other < num_workers_; ++other) {
+    if (other == id) continue;
+    const Ring& ring = rings_[other];
+    const int64_t end = ring.num_published.load(std::memory_order_acquire);
+    int64_t begin = self.num_read[other];
+    if (end - begin > kNumSlots) {
+      // These clauses have already been overwritten.
+      num_missed += end - kNumSlots - begin;
+      begin = end - kNumSlots;
+    }
+    for (int64_t index = begin; index < end; ++index) {
+      const Slot& slot = ring.slots[index % kNumSlots];
+      const int64_t epoch = 2 * index + 2;
+      if (slot.epoch.load(std::memory_order_acquire) != epoch) {
+        ++num_missed;
+        continue;
+      }
+      const int size = slot.size.load(std::memory_order_relaxed);
+      for (int i = 0; i < size; ++i) {
+        literals[i] = slot.literals[i].load(std::memory_order_relaxed);
+      }
+      // If the slot was overwritten while we copied it, then the epoch changed
+      // and this fence ensures that we see it.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.epoch.load(std::memory_order_relaxed) != epoch) {
+        ++num_missed;
+        continue;
+      }
+      clauses->Add(absl::MakeConstSpan(literals.data(), size));
+      ++num_imported;
+    }
+    self.num_read[other] = end;
+  }
+  self.num_imported.store(
+      self.num_imported.load(std::memory_order_relaxed) + num_imported,
+      std::memory_order_relaxed);
+  self.num_missed.store(
+      self.num_missed.load(std::memory_order_relaxed) + num_missed,
+      std::memory_order_relaxed);
+}
+
+void SharedClauseRings::LogStatistics(SolverLogger* logger) {
+  int64_t num_published = 0;
+  int64_t num_filtered = 0;
+  int64_t num_imported = 0;
+  int64_t num_missed = 0;
+  for (int id = 0; id < num_workers_; ++id) {
+    const Ring& ring = rings_[id];
+    num_published += ring.num_published.load(std::memory_order_relaxed);
+    num_filtered += ring.num_filtered.load(std::memory_order_relaxed);
+    num_imported += ring.num_imported.load(std::memory_order_relaxed);
+    num_missed += ring.num_missed.load(std::memory_order_relaxed);
+  }
+  if (num_published + num_filtered == 0) return;
+  std::vector<std::vector<std::string>> table;
+  table.push_back({"Clause rings", "Published", "Duplicates", "Imported",
+                   "Missed"});
+  table.push_back({FormatName("lock-free"), FormatCounter(num_published),
+                   FormatCounter(num_filtered), FormatCounter(num_imported),
+                   FormatCounter(num_missed)});
+  SOLVER_LOG(logger, FormatTable(table));
+}
+
 void SharedStatistics::AddStats(
     absl::Span<const std::pair<std::string, int64_t>> stats) {
   absl::MutexLock mutex_lock(&mutex_);
@@ -800,6 +800,96 @@ class SharedClausesManager {
   absl::flat_hash_map<int, std::string> id_to_worker_name_;
 };
 
+// A lock-free alternative to the glue clauses exchange of
+// SharedClausesManager, used when share_glue_clauses_lock_free is true.
+//
+// Each worker publishes its clauses on its own ring of kNumSlots fixed-size
+// slots, which all the other workers read at their own pace:
+// - A ring has a single producer, so publishing a clause just writes the next
+//   slot, overwriting the oldest clause of the ring.
+// - Each slot has an epoch, odd while the slot is being written, that tells
+//   which clause it holds. A reader only keeps the clauses whose epoch did not
+//   change while it copied them (i.e. a sequence lock), so a clause can be
+//   missed if it is overwritten before being read, but is never read torn.
+// - Probable duplicates are not published, using a lossy concurrent table of
+//   clause fingerprints. Fingerprints can be evicted or missed by racing
+//   workers, so a few duplicates still go through.
+// Thus neither the producers nor the consumers ever block, and the clauses
+// are visible as soon as they are published, without waiting for the next
+// Synchronize().
+//
+// The ids are the ones of SharedClausesManager, and a given id must only be
+// used by a single thread at a time. Workers with an id of at least
+// num_workers() fall back to the exchange of SharedClausesManager.
+//
+// Note that this uses literal as encoded in a cp_model.proto. Thus, the
+// literals can be negative numbers.
+class SharedClauseRings {
+ public:
+  static constexpr int kMinClauseSize = UniqueClauseStream::kMinClauseSize;
+  static constexpr int kMaxClauseSize = UniqueClauseStream::kMaxClauseSize;
+  static constexpr int kNumSlots = 1024;
+
+  // Ids must be in [0, num_workers).
+  explicit SharedClauseRings(int num_workers);
+
+  // This type is neither copyable nor movable.
+  SharedClauseRings(const SharedClauseRings&) = delete;
+  SharedClauseRings& operator=(const SharedClauseRings&) = delete;
+
+  // Publishes the clause on the ring of the given worker. Returns false if the
+  // clause was not published because of its size, or because it is probably a
+  // duplicate of a clause already published by some worker.
+  bool Add(int id, absl::Span<const int> clause);
+
+  // Appends to clauses the ones published by the other workers since the last
+  // call with the same id, except the ones overwritten in the meantime.
+  void GetUnseenClauses(int id, CompactVectorVector<int>* clauses);
+
+  int num_workers() const { return num_workers_; }
+
+  // Search statistics.
+  void LogStatistics(SolverLogger* logger);
+
+ private:
+  // The fingerprints table is made of buckets of kBucketSize entries, each
+  // bucket filling a cache line.
+  static constexpr int kNumFingerprints = 1 << 16;
+  static constexpr int kBucketSize = 8;
+
+  struct alignas(64) Slot {
+    // 2 * i + 1 while the i-th clause of the ring is written in this slot,
+    // and 2 * i + 2 once it is.
+    std::atomic<int64_t> epoch = 0;
+    std::atomic<int> size = 0;
+    std::array<std::atomic<int>, kMaxClauseSize> literals = {};
+  };
+
+  struct Ring {
+    std::unique_ptr<Slot[]> slots;
+
+    // The number of clauses published on this ring.
+    alignas(64) std::atomic<int64_t> num_published = 0;
+
+    // The number of clauses of each ring read by the worker of this ring.
+    // Only accessed by this worker.
+    std::vector<int64_t> num_read;
+
+    // Statistics, only written by the worker of this ring.
+    std::atomic<int64_t> num_filtered = 0;
+    std::atomic<int64_t> num_imported = 0;
+    std::atomic<int64_t> num_missed = 0;
+  };
+
+  // Adds the fingerprint of the clause to the table, and returns false if it
+  // was already there.
+  bool InsertFingerprint(absl::Span<const int> clause);
+
+  const int num_workers_;
+  std::unique_ptr<Ring[]> rings_;
+  std::unique_ptr<std::atomic<uint64_t>[]> fingerprints_;
+};
+
 // Simple class to add statistics by name and print them at the end.
 class SharedStatistics {
  public:
@@ -0,0 +1,124 @@
+// Copyright 2010-2025 Google LLC
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ortools/sat/synchronization.h"
+
+#include <thread>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "gtest/gtest.h"
+#include "ortools/base/gmock.h"
+#include "ortools/sat/util.h"
+
+namespace operations_research {
+namespace sat {
+namespace {
+
+using ::testing::ElementsAre;
+
+std::vector<std::vector<int>> ToVectors(
+    const CompactVectorVector<int>& clauses) {
+  std::vector<std::vector<int>> result;
+  for (int i = 0; i < clauses.size(); ++i) {
+    result.push_back(std::vector<int>(clauses[i].begin(), clauses[i].end()));
+  }
+  return result;
+}
+
+TEST(SharedClauseRingsTest, ClausesAreSeenOnceByTheOtherWorkers) {
+  SharedClauseRings rings(/*num_workers=*/3);
+  EXPECT_TRUE(rings.Add(0, {1, 2, 3}));
+  EXPECT_TRUE(rings.Add(1, {-1, 4, 5, 6}));
+
+  CompactVectorVector<int> clauses;
+  rings.GetUnseenClauses(0, &clauses);
+  EXPECT_THAT(ToVectors(clauses), ElementsAre(ElementsAre(-1, 4, 5, 6)));
+
+  clauses.clear();
+  rings.GetUnseenClauses(2, &clauses);
+  EXPECT_THAT(ToVectors(clauses), ElementsAre(ElementsAre(1, 2, 3),
+                                              ElementsAre(-1, 4, 5, 6)));
+
+  clauses.clear();
+  rings.GetUnseenClauses(2, &clauses);
+  EXPECT_EQ(clauses.size(), 0);
+}
+
+TEST(SharedClauseRingsTest, FiltersSizesAndDuplicates) {
+  SharedClauseRings rings(/*num_workers=*/2);
+  EXPECT_FALSE(rings.Add(0, {1, 2}));
+  EXPECT_FALSE(rings.Add(0, std::vector<int>(33, 1)));
+  EXPECT_TRUE(rings.Add(0, {1, 2, 3}));
+  EXPECT_FALSE(rings.Add(1, {3, 1, 2}));
+
+  CompactVectorVector<int> clauses;
+  rings.GetUnseenClauses(1, &clauses);
+  EXPECT_THAT(ToVectors(clauses), ElementsAre(ElementsAre(1, 2, 3)));
+}
+
+TEST(SharedClauseRingsTest, OverwrittenClausesAreMissed) {
+  SharedClauseRings rings(/*num_workers=*/2);
+  const int num_clauses = 2 * SharedClauseRings::kNumSlots + 10;
+  for (int i = 0; i < num_clauses; ++i) {
+    ASSERT_TRUE(rings.Add(0, {3 * i, 3 * i + 1, 3 * i + 2}));
+  }
+  CompactVectorVector<int> clauses;
+  rings.GetUnseenClauses(1, &clauses);
+  ASSERT_EQ(clauses.size(), SharedClauseRings::kNumSlots);
+  const int first = num_clauses - SharedClauseRings::kNumSlots;
+  EXPECT_EQ(clauses[0][0], 3 * first);
+  EXPECT_EQ(clauses[clauses.size() - 1][0], 3 * (num_clauses - 1));
+}
+
+TEST(SharedClauseRingsTest, ConcurrentWorkersNeverReadTornClauses) {
+  const int kNumWorkers = 4;
+  const int kNumClauses = 20000;
+  SharedClauseRings rings(kNumWorkers);
+  std::vector<int> num_read(kNumWorkers, 0);
+  std::vector<int> num_torn(kNumWorkers, 0);
+  std::vector<std::thread> threads;
+  for (int id = 0; id < kNumWorkers; ++id) {
+    threads.emplace_back([&, id]() {
+      CompactVectorVector<int> clauses;
+      std::vector<int> clause;
+      for (int i = 0; i < kNumClauses; ++i) {
+        // The clause {x, x + 1, ..., x + size - 1} with size in [3, 32].
+        const int x = (id * kNumClauses + i) * 64;
+        clause.clear();
+        for (int j = 0; j < 3 + i % 30; ++j) clause.push_back(x + j);
+        rings.Add(id, clause);
+        if (i % 16 != 0) continue;
+        clauses.clear();
+        rings.GetUnseenClauses(id, &clauses);
+        for (int c = 0; c < clauses.size(); ++c) {
+          const absl::Span<const int> read = clauses[c];
+          for (int j = 0; j < read.size(); ++j) {
+            if (read[j] != read[0] + j) ++num_torn[id];
+          }
+          if (read[0] / 64 / kNumClauses == id) ++num_torn[id];
+          ++num_read[id];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  for (int id = 0; id < kNumWorkers; ++id) {
+    EXPECT_EQ(num_torn[id], 0);
+    EXPECT_GT(num_read[id], 0);
+  }
+}
+
+}  // namespace
+}  // namespace sat
+}  // namespace operations_research
@@ -1173,6 +1173,32 @@ bool DualBoundStrengthening::Strengthen(PresolveContext* context) {
   return true;
 }
 
+namespace {
+
+// Returns the min and max activity of each linear constraint of the model. This
+// only reads the model, so it is done with up to presolve_num_workers()
+// threads. Returns an empty vector if the presolve is single-threaded, in which
+// case the activities are better computed on the fly.
+std::vector<std::pair<int64_t, int64_t>> ComputeLinearActivitiesInParallel(
+    const PresolveContext& context) {
+  const int num_workers = context.params().presolve_num_workers();
+  if (num_workers <= 1) return {};
+
+  const CpModelProto& cp_model = *context.working_model;
+  const int num_constraints = cp_model.constraints_size();
+  std::vector<std::pair<int64_t, int64_t>> activities(num_constraints);
+  ParallelForEachRange(num_workers, num_constraints, [&](int begin, int end) {
+    for (int c = begin; c < end; ++c) {
+      const ConstraintProto& ct = cp_model.constraints(c);
+      if (ct.constraint_case() != ConstraintProto::kLinear) continue;
+      activities[c] = context.ComputeMinMaxActivity(ct.linear());
+    }
+  });
+  return activities;
+}
+
+}  // namespace
+
 void ScanModelForDominanceDetection(PresolveContext& context,
                                     VarDomination* var_domination) {
   if (context.ModelIsUnsat()) return;
@@ -1207,6 +1233,8 @@ void ScanModelForDominanceDetection(PresolveContext& context,
 
   // First scan: update the partition.
   const int num_constraints = cp_model.constraints_size();
+  const std::vector<std::pair<int64_t, int64_t>> activities =
+      ComputeLinearActivitiesInParallel(context);
   std::vector<bool> c_is_free_to_increase(num_constraints);
   std::vector<bool> c_is_free_to_decrease(num_constraints);
   for (int c = 0; c < num_constraints; ++c) {
@@ -1225,7 +1253,8 @@ void ScanModelForDominanceDetection(PresolveContext& context,
       case ConstraintProto::kLinear: {
         // TODO(user): Maybe we should avoid recomputing that here.
         const auto [min_activity, max_activity] =
-            context.ComputeMinMaxActivity(ct.linear());
+            activities.empty() ? context.ComputeMinMaxActivity(ct.linear())
+                               : activities[c];
         const bool domain_is_simple = ct.linear().domain().size() == 2;
         const bool free_to_increase =
             domain_is_simple && ct.linear().domain(1) >= max_activity;
@@ -1404,6 +1433,8 @@ void ScanModelForDualBoundStrengthening(
   }
 
   const int num_constraints = cp_model.constraints_size();
+  const std::vector<std::pair<int64_t, int64_t>> activities =
+      ComputeLinearActivitiesInParallel(context);
   for (int c = 0; c < num_constraints; ++c) {
     const ConstraintProto& ct = cp_model.constraints(c);
     dual_bound_strengthening->CannotIncrease(ct.enforcement_literal(), c);
@@ -1424,7 +1455,8 @@ void ScanModelForDualBoundStrengthening(
       case ConstraintProto::kLinear: {
         // TODO(user): Maybe we should avoid recomputing that here.
         const auto [min_activity, max_activity] =
-            context.ComputeMinMaxActivity(ct.linear());
+            activities.empty() ? context.ComputeMinMaxActivity(ct.linear())
+                               : activities[c];
         dual_bound_strengthening->ProcessLinearConstraint(
             false, context, ct.linear(), min_activity, max_activity, c);
         break;
@@ -1,26 +1,22 @@
+// solve.cpp
+// CP-SAT minimum dominating set, warm-started from the native engine in mds/:
+//   - kernel plants are fixed before the model is built, and only residual
+//     candidates get a variable; only residual needed vertices a constraint
+//   - every component is solved natively first (mds::solve_component); its
+//     set becomes the hint and an upper bound on that component's plants
+//   - a packing of needed vertices bounds each component from below; a
+//     component whose bounds meet is already optimal and stays out
+// CP-SAT then spends its budget proving or improving, not finding a first
+// solution. MDS_WARM_MS (default 100) bounds the native pass; it is shared
+// by size as in mds::solve, so one large component cannot starve the others.
+
 #include <bits/stdc++.h>
 #include "ortools/sat/cp_model.h"
+#include "mds/io.h"
+#include "mds/solver.h"
 using namespace std;
 using namespace operations_research::sat;
 
-static const int BSZ = 1 << 20;
-static char buf[BSZ];
-int bp = BSZ, be = BSZ;
-
-inline int readInt()
-{
-    if (bp == be)
-        be = fread(buf, 1, BSZ, stdin), bp = 0;
-    if (be == 0)
-        return -1;
-    int c, x = 0;
-    while ((c = buf[bp++]) < '0')
-        ;
-    for (; c >= '0'; c = buf[bp++])
-        x = x * 10 + (c - '0');
-    return x;
-}
-
 int main(int argc, char **argv)
 {
     if (argc != 3)
@@ -28,52 +24,106 @@ int main(int argc, char **argv)
         fprintf(stderr, "Usage: %s input_file output_file\n", argv[0]);
         return 1;
     }
-    freopen(argv[1], "r", stdin);
+    mds::Graph g;
+    if (!mds::read_graph(argv[1], g))
+    {
+        fprintf(stderr, "Cannot read %s\n", argv[1]);
+        return 1;
+    }
     freopen(argv[2], "w", stdout);
+    const int num_nodes = g.n;
 
-    int num_nodes = readInt();
-    int num_edges = readInt();
-    vector<vector<int>> neighbors(num_nodes);
+    mds::Kernel kernel(g);
+    kernel.reduce();
+    vector<char> in_set = kernel.chosen;
+    vector<char> hint(num_nodes, 0);
 
-    for (int i = 0; i < num_edges; ++i)
-    {
-        int u = readInt(), v = readInt();
-        neighbors[u].push_back(v);
-        neighbors[v].push_back(u);
-    }
+    int warm_ms = 100;
+    if (const char *e = getenv("MDS_WARM_MS"))
+        warm_ms = atoi(e);
+    const auto warm_deadline = mds::Clock::now() + chrono::milliseconds(warm_ms);
 
     CpModelBuilder model;
-    vector<BoolVar> x;
-    x.reserve(num_nodes);
-    for (int i = 0; i < num_nodes; ++i)
-        x.push_back(model.NewBoolVar());
-
-    for (int i = 0; i < num_nodes; ++i)
+    vector<BoolVar> x(num_nodes);
+    vector<int> vars, local(num_nodes);
+    mds::Components comps = mds::label_components(g, kernel.need, kernel.cand, 1);
+    // a component starting now gets its fraction of the vertices not yet
+    // started, so the time left by fast components goes to the next ones;
+    // smallest first, so that time ends up with the largest component
+    long long left = 0;
+    for (const vector<int> &members : comps.members)
+        left += (long long)members.size();
+    for (auto it = comps.members.rbegin(); it != comps.members.rend(); ++it)
     {
-        LinearExpr cover;
-        cover += x[i];
-        for (int j : neighbors[i])
-            cover += x[j];
-        model.AddGreaterOrEqual(cover, 1);
+        const vector<int> &members = *it;
+        mds::Sub s = mds::make_sub(g, kernel.need, kernel.cand, members, local);
+        mds::SearchLimits limits;
+        const auto now = mds::Clock::now();
+        limits.deadline = now;
+        if (warm_deadline > now)
+            limits.deadline += chrono::duration_cast<mds::Clock::duration>(
+                (warm_deadline - now) * s.size() / max(1LL, left));
+        left -= s.size();
+        vector<int> warm = mds::solve_component(s, limits);
+        const int lower = mds::packing_lower_bound(s);
+        if (lower >= (int)warm.size())
+        {
+            for (int v : warm)
+                in_set[s.orig[v]] = 1;
+            continue;
+        }
+
+        vector<BoolVar> comp_vars;
+        for (int i = 0; i < s.size(); ++i)
+            if (s.cand[i])
+            {
+                x[s.orig[i]] = model.NewBoolVar();
+                comp_vars.push_back(x[s.orig[i]]);
+                vars.push_back(s.orig[i]);
+            }
+        for (int i = 0; i < s.size(); ++i)
+        {
+            if (!s.need[i])
+                continue;
+            LinearExpr cover;
+            if (s.cand[i])
+                cover += x[s.orig[i]];
+            for (int j : s.g.nbrs(i))
+                if (s.cand[j])
+                    cover += x[s.orig[j]];
+            model.AddGreaterOrEqual(cover, 1);
+        }
+        for (int v : warm)
+            hint[s.orig[v]] = 1;
+        // redundant cuts: components are independent, so each one is bounded
+        // by its own native set from above and its packing from below
+        model.AddLessOrEqual(LinearExpr::Sum(comp_vars), (int64_t)warm.size());
+        model.AddGreaterOrEqual(LinearExpr::Sum(comp_vars), lower);
     }
 
-    model.Minimize(LinearExpr::Sum(x));
+    if (!vars.empty())
+    {
+        vector<BoolVar> all;
+        all.reserve(vars.size());
+        for (int v : vars)
+        {
+            model.AddHint(x[v], hint[v] != 0);
+            all.push_back(x[v]);
+        }
+        model.Minimize(LinearExpr::Sum(all));
 
-    Model sat_model;
-    sat_model.Add(NewSatParameters(
-        "max_time_in_seconds:0.2 num_search_workers:12 linearization_level:1"));
-    const CpSolverResponse response = SolveCpModel(model.Build(), &sat_model);
+        Model sat_model;
+        sat_model.Add(NewSatParameters(
+            "max_time_in_seconds:0.2 num_search_workers:12 linearization_level:1"));
+        const CpSolverResponse response = SolveCpModel(model.Build(), &sat_model);
 
-    if (response.status() == CpSolverStatus::OPTIMAL ||
-        response.status() == CpSolverStatus::FEASIBLE)
-    {
-        for (int i = 0; i < num_nodes; ++i)
-            fputc(SolutionIntegerValue(response, x[i]) ? '1' : '0', stdout);
-    }
-    else
-    {
-        for (int i = 0; i < num_nodes; ++i)
-            fputc('0', stdout);
+        const bool solved = response.status() == CpSolverStatus::OPTIMAL ||
+                            response.status() == CpSolverStatus::FEASIBLE;
+        for (int v : vars)
+            in_set[v] = solved ? SolutionBooleanValue(response, x[v]) : hint[v];
     }
+
+    for (int i = 0; i < num_nodes; ++i)
+        fputc(in_set[i] ? '1' : '0', stdout);
     fputc('\n', stdout);
 }